@@ -20,7 +20,7 @@ typedef struct int_entry2 {
   zda_avl_node_t node;
 } int_entry2_t;
 
-static zda_inline int int_cmp(int x, int y) noexcept { return x - y; }
+static zda_inline int int_cmp(int x, int y) noexcept { return (x > y) - (x < y); }
 
 static zda_inline int int_entry_get_key(int_entry_t *p_entry) noexcept { return p_entry->key; }
 
@@ -56,7 +56,7 @@ zda_def_avl_tree_remove(int_avl_tree_remove, int, int_entry2_t, int_entry2_get_k
 int int_entry_cmp(zda_rb_node_t const *node, void const *key)
 {
   int_entry const *p_entry = zda_rb_entry(node, int_entry const);
-  return p_entry->key - *(int *)key;
+  return int_cmp(p_entry->key, *(int *)key);
 }
 
 void int_entry_free(zda_rb_node_t *node)
@@ -218,6 +218,29 @@ static void zda_rb_tree_search_bench(State &state)
   zda_rb_tree_destroy_init(&header, int_entry_free);
 }
 
+static void zda_rb_tree_search_int_bench(State &state)
+{
+  const int num = state.range(0);
+
+  zda_rb_header_t header;
+  zda_rb_header_init(&header);
+  prepare_rb_tree(&header, num);
+
+  int_entry *p_dup;
+
+  for (auto _ : state) {
+    for (int i = 0; i < num; ++i) {
+      zda_rb_tree_search_int_inplace(&header, i, int_entry, int_entry_get_key, p_dup);
+      state.PauseTiming();
+      if (p_dup->key != i) {
+        abort();
+      }
+      state.ResumeTiming();
+    }
+  }
+  zda_rb_tree_destroy_init(&header, int_entry_free);
+}
+
 static void zda_avl_tree_search_bench(State &state)
 {
   const int num = state.range(0);
@@ -346,6 +369,7 @@ static void stl_set_remove_bench(State &state)
   BENCHMARK(func)->RangeMultiplier(10)->Range(10, 1000000)->Name(name)
 
 register_tree_benchmark(zda_rb_tree_search_bench, "zda_rb_tree search");
+register_tree_benchmark(zda_rb_tree_search_int_bench, "zda_rb_tree search(int)");
 register_tree_benchmark(zda_avl_tree_search_bench, "zda_avl_tree search");
 register_tree_benchmark(stl_set_search_bench, "std::set search");
 register_tree_benchmark(zda_avl_tree_insert_bench, "zda_avl_tree insert");
@@ -17,6 +17,38 @@ static zda_inline void _zda_avl_tree_set_root(zda_avl_tree_t *tree, zda_avl_node
   tree->node = node;
 }
 
+static zda_inline void _zda_avl_node_set_parent(zda_avl_node_t *node, zda_avl_node_t *parent)
+    zda_noexcept
+{
+  node->parent_bf = (uintptr_t)parent | (node->parent_bf & _ZDA_AVL_BF_MASK);
+}
+
+static zda_inline void _zda_avl_node_set_bf(zda_avl_node_t *node, int bf) zda_noexcept
+{
+  assert(bf >= -1 && bf <= 1);
+  node->parent_bf = (node->parent_bf & ~_ZDA_AVL_BF_MASK) | (uintptr_t)(bf + 1);
+}
+
+/* Replace the child \p old_child of \p parent with \p new_child */
+static zda_inline void _zda_avl_tree_change_child(
+    zda_avl_tree_t *tree,
+    zda_avl_node_t *parent,
+    zda_avl_node_t *old_child,
+    zda_avl_node_t *new_child
+) zda_noexcept
+{
+  if (!parent) {
+    assert(_zda_avl_tree_is_root(tree, old_child));
+    _zda_avl_tree_set_root(tree, new_child);
+  } else if (parent->left == old_child) {
+    parent->left = new_child;
+  } else {
+    assert(parent->right == old_child);
+    parent->right = new_child;
+  }
+}
+
+/* The rotations only relink the nodes, the balance factors are updated by caller */
 static zda_inline void _zda_avl_tree_right_rotate(zda_avl_tree_t *tree, zda_avl_node_t *node)
     zda_noexcept
 {
@@ -31,23 +63,15 @@ static zda_inline void _zda_avl_tree_right_rotate(zda_avl_tree_t *tree, zda_avl_
   assert(tree->node);
 
   zda_avl_node_t *new_node = node->left;
-  node->left               = new_node->right;
-  if (node->left) node->left->parent = node;
-
-  zda_avl_node_t *parent = node->parent;
-  new_node->right        = node;
-  node->parent           = new_node;
-  if (_zda_avl_tree_is_root(tree, node)) {
-    _zda_avl_tree_set_root(tree, new_node);
-  } else {
-    if (parent->left == node) {
-      parent->left = new_node;
-    } else {
-      assert(parent->right == node);
-      parent->right = new_node;
-    }
-  }
-  new_node->parent = parent;
+  zda_avl_node_t *parent   = zda_avl_node_get_parent(node);
+
+  node->left = new_node->right;
+  if (node->left) _zda_avl_node_set_parent(node->left, node);
+
+  new_node->right = node;
+  _zda_avl_node_set_parent(node, new_node);
+  _zda_avl_tree_change_child(tree, parent, node, new_node);
+  _zda_avl_node_set_parent(new_node, parent);
 }
 
 static zda_inline void _zda_avl_tree_left_rotate(zda_avl_tree_t *tree, zda_avl_node_t *node)
@@ -57,37 +81,15 @@ static zda_inline void _zda_avl_tree_left_rotate(zda_avl_tree_t *tree, zda_avl_n
   assert(tree->node);
 
   zda_avl_node_t *new_node = node->right;
-  node->right              = new_node->left;
-  if (node->right) node->right->parent = node;
-
-  zda_avl_node_t *parent = node->parent;
-  new_node->left         = node;
-  node->parent           = new_node;
-  if (_zda_avl_tree_is_root(tree, node)) {
-    _zda_avl_tree_set_root(tree, new_node);
-  } else {
-    if (parent->left == node) {
-      parent->left = new_node;
-    } else {
-      assert(parent->right == node);
-      parent->right = new_node;
-    }
-  }
-  new_node->parent = parent;
-}
-
-static zda_inline size_t _zda_avl_node_compute_height(zda_avl_node_t *node) zda_noexcept
-{
-  return node ? node->height : 0;
-}
+  zda_avl_node_t *parent   = zda_avl_node_get_parent(node);
 
-static zda_inline void _zda_avl_node_update_height(zda_avl_node_t *node) zda_noexcept
-{
-  assert(node);
-  const size_t lh = _zda_avl_node_compute_height(node->left);
-  const size_t rh = _zda_avl_node_compute_height(node->right);
+  node->right = new_node->left;
+  if (node->right) _zda_avl_node_set_parent(node->right, node);
 
-  node->height = zda_max(lh, rh) + 1;
+  new_node->left = node;
+  _zda_avl_node_set_parent(node, new_node);
+  _zda_avl_tree_change_child(tree, parent, node, new_node);
+  _zda_avl_node_set_parent(new_node, parent);
 }
 
 /*
@@ -103,72 +105,96 @@ static zda_inline void _zda_avl_node_update_height(zda_avl_node_t *node) zda_noe
  *  If H(A) == h + 1, Right-Rotation(node) can resolve it.
  *  If H(C) == h + 1 and H(A) == h, the right subtree will be unrebalanced state.
  *  We can use Left-Rotation(node->left) to conver it to former case.
+ *
+ *  The balance factor of node is -2(not stored) and the balance factors of the
+ *  rotated nodes can be derived from the old ones without loading the grandchildren.
+ *
+ *  Return the new root of the subtree.
  */
-static zda_inline void _zda_avl_tree_fix_left_heavy(zda_avl_tree_t *tree, zda_avl_node_t *node)
-    zda_noexcept
+static zda_inline zda_avl_node_t *
+_zda_avl_tree_fix_left_heavy(zda_avl_tree_t *tree, zda_avl_node_t *node) zda_noexcept
 {
   assert(node->left);
-  zda_avl_node_t *left = node->left;
-
-  size_t lh = _zda_avl_node_compute_height(left->left);
-  size_t rh = _zda_avl_node_compute_height(left->right);
-
-  if (rh > lh) {
-    _zda_avl_tree_left_rotate(tree, left);
-    _zda_avl_node_update_height(left);
-    _zda_avl_node_update_height(left->parent);
+  zda_avl_node_t *left    = node->left;
+  const int       left_bf = zda_avl_node_get_bf(left);
+  zda_avl_node_t *child;
+  int             child_bf;
+
+  if (left_bf <= 0) {
+    _zda_avl_tree_right_rotate(tree, node);
+    /* left_bf == 0 is only possible in removal, the height is not changed */
+    _zda_avl_node_set_bf(node, -1 - left_bf);
+    _zda_avl_node_set_bf(left, 1 + left_bf);
+    return left;
   }
 
+  child    = left->right;
+  child_bf = zda_avl_node_get_bf(child);
+  _zda_avl_tree_left_rotate(tree, left);
   _zda_avl_tree_right_rotate(tree, node);
-  _zda_avl_node_update_height(node);
-  _zda_avl_node_update_height(node->parent);
+  _zda_avl_node_set_bf(node, child_bf < 0 ? 1 : 0);
+  _zda_avl_node_set_bf(left, child_bf > 0 ? -1 : 0);
+  _zda_avl_node_set_bf(child, 0);
+  return child;
 }
 
 /* symmetric operation of left fixup */
-static zda_inline void _zda_avl_tree_fix_right_heavy(zda_avl_tree_t *tree, zda_avl_node_t *node)
-    zda_noexcept
+static zda_inline zda_avl_node_t *
+_zda_avl_tree_fix_right_heavy(zda_avl_tree_t *tree, zda_avl_node_t *node) zda_noexcept
 {
   assert(node->right);
-  zda_avl_node_t *right = node->right;
-
-  size_t lh = _zda_avl_node_compute_height(right->left);
-  size_t rh = _zda_avl_node_compute_height(right->right);
-
-  if (lh > rh) {
-    _zda_avl_tree_right_rotate(tree, right);
-    _zda_avl_node_update_height(right);
-    _zda_avl_node_update_height(right->parent);
+  zda_avl_node_t *right    = node->right;
+  const int       right_bf = zda_avl_node_get_bf(right);
+  zda_avl_node_t *child;
+  int             child_bf;
+
+  if (right_bf >= 0) {
+    _zda_avl_tree_left_rotate(tree, node);
+    _zda_avl_node_set_bf(node, 1 - right_bf);
+    _zda_avl_node_set_bf(right, right_bf - 1);
+    return right;
   }
 
+  child    = right->left;
+  child_bf = zda_avl_node_get_bf(child);
+  _zda_avl_tree_right_rotate(tree, right);
   _zda_avl_tree_left_rotate(tree, node);
-  _zda_avl_node_update_height(node);
-  _zda_avl_node_update_height(node->parent);
+  _zda_avl_node_set_bf(node, child_bf > 0 ? -1 : 0);
+  _zda_avl_node_set_bf(right, child_bf < 0 ? 1 : 0);
+  _zda_avl_node_set_bf(child, 0);
+  return child;
 }
 
 void zda_avl_tree_after_insert(zda_avl_tree_t *tree, zda_avl_node_t *node, zda_avl_node_t *parent)
     zda_noexcept
 {
-  size_t lh, rh, h;
-  int    diff;
-
-  node->parent = parent;
-  for (; node; node = node->parent) {
-    lh = _zda_avl_node_compute_height(node->left);
-    rh = _zda_avl_node_compute_height(node->right);
-    h  = zda_max(lh, rh) + 1;
-    if (node->height == h) {
-      break;
-    }
-    node->height = h;
-
-    diff = lh - rh;
-    if (diff >= 2) {
-      _zda_avl_tree_fix_left_heavy(tree, node);
-      /* Update currernt node to the new node that replace it */
-      node = node->parent;
-    } else if (diff <= -2) {
-      _zda_avl_tree_fix_right_heavy(tree, node);
-      node = node->parent;
+  int bf;
+
+  _zda_avl_node_set_parent(node, parent);
+  /* The height of subtree rooted at node is increased */
+  for (; parent; node = parent, parent = zda_avl_node_get_parent(node)) {
+    bf = zda_avl_node_get_bf(parent);
+    if (parent->left == node) {
+      if (bf > 0) {
+        _zda_avl_node_set_bf(parent, 0);
+        break;
+      } else if (bf == 0) {
+        _zda_avl_node_set_bf(parent, -1);
+      } else {
+        /* The height of the new subtree root is same as the old parent */
+        _zda_avl_tree_fix_left_heavy(tree, parent);
+        break;
+      }
+    } else {
+      if (bf < 0) {
+        _zda_avl_node_set_bf(parent, 0);
+        break;
+      } else if (bf == 0) {
+        _zda_avl_node_set_bf(parent, 1);
+      } else {
+        _zda_avl_tree_fix_right_heavy(tree, parent);
+        break;
+      }
     }
   }
 }
@@ -183,54 +209,84 @@ void zda_avl_tree_insert_commit(
 }
 
 /******************************/
-/* Remove APIs */
+/* Bulk build APIs */
 /******************************/
-static zda_inline void _zda_avl_tree_remove_fix(zda_avl_tree_t *tree, zda_avl_node_t *node)
-    zda_noexcept
+/* Link nodes[lo, hi) as the subtree of \p parent and return its height */
+static size_t _zda_avl_tree_build_sorted(
+    zda_avl_node_t **nodes,
+    size_t           lo,
+    size_t           hi,
+    zda_avl_node_t  *parent,
+    zda_avl_node_t **p_slot
+) zda_noexcept
 {
-  size_t lh, rh, h;
-  int    diff;
-
-  for (; node; node = node->parent) {
-    lh = _zda_avl_node_compute_height(node->left);
-    rh = _zda_avl_node_compute_height(node->right);
-    h  = zda_max(lh, rh) + 1;
-
-    diff = lh - rh;
-    if (node->height != h) {
-      node->height = h;
-    } else if (diff >= -1 && diff <= 1)
-      break;
-
-    if (diff >= 2) {
-      _zda_avl_tree_fix_left_heavy(tree, node);
-      node = node->parent;
-    } else if (diff <= -2) {
-      _zda_avl_tree_fix_right_heavy(tree, node);
-      node = node->parent;
-    }
+  if (lo == hi) {
+    *p_slot = NULL;
+    return 0;
   }
+
+  size_t const    mid  = lo + (hi - lo) / 2;
+  zda_avl_node_t *node = nodes[mid];
+  size_t const    lh   = _zda_avl_tree_build_sorted(nodes, lo, mid, node, &node->left);
+  size_t const    rh   = _zda_avl_tree_build_sorted(nodes, mid + 1, hi, node, &node->right);
+
+  node->parent_bf = (uintptr_t)parent;
+  _zda_avl_node_set_bf(node, (int)rh - (int)lh);
+  *p_slot = node;
+  return zda_max(lh, rh) + 1;
 }
 
-static zda_inline void _zda_avl_node_transplant(
-    zda_avl_tree_t *tree,
-    zda_avl_node_t *victim,
-    zda_avl_node_t *node
-) zda_noexcept
+void zda_avl_tree_build_sorted(zda_avl_tree_t *tree, zda_avl_node_t **nodes, size_t n) zda_noexcept
 {
-  zda_avl_node_t *parent = victim->parent;
-  if (parent) {
-    if (parent->left == victim) {
-      parent->left = node;
+  assert(zda_avl_tree_is_empty(tree));
+  _zda_avl_tree_build_sorted(nodes, 0, n, NULL, &tree->node);
+}
+
+/******************************/
+/* Remove APIs */
+/******************************/
+/**
+ * The height of the left(\p is_left is true) or right subtree of \p parent is decreased.
+ * Retrace to the root until the height of some subtree is not changed.
+ */
+static zda_inline void
+_zda_avl_tree_remove_fix(zda_avl_tree_t *tree, zda_avl_node_t *parent, zda_bool is_left)
+    zda_noexcept
+{
+  zda_avl_node_t *node;
+  int             bf;
+
+  while (parent) {
+    bf = zda_avl_node_get_bf(parent);
+    if (is_left) {
+      if (bf < 0) {
+        _zda_avl_node_set_bf(parent, 0);
+        node = parent;
+      } else if (bf == 0) {
+        _zda_avl_node_set_bf(parent, 1);
+        break;
+      } else {
+        bf   = zda_avl_node_get_bf(parent->right);
+        node = _zda_avl_tree_fix_right_heavy(tree, parent);
+        /* The height is not changed if the sibling is balanced */
+        if (bf == 0) break;
+      }
     } else {
-      assert(parent->right);
-      parent->right = node;
+      if (bf > 0) {
+        _zda_avl_node_set_bf(parent, 0);
+        node = parent;
+      } else if (bf == 0) {
+        _zda_avl_node_set_bf(parent, -1);
+        break;
+      } else {
+        bf   = zda_avl_node_get_bf(parent->left);
+        node = _zda_avl_tree_fix_left_heavy(tree, parent);
+        if (bf == 0) break;
+      }
     }
-  }
 
-  if (node) node->parent = parent;
-  if (_zda_avl_tree_is_root(tree, victim)) {
-    _zda_avl_tree_set_root(tree, node);
+    parent = zda_avl_node_get_parent(node);
+    if (parent) is_left = parent->left == node;
   }
 }
 
@@ -238,70 +294,77 @@ void zda_avl_tree_remove_node(zda_avl_tree_t *tree, zda_avl_node_t *old_node) zd
 {
   assert(old_node);
 
-  zda_avl_node_t *parent = old_node->parent;
+  zda_avl_node_t *parent = zda_avl_node_get_parent(old_node);
+  zda_avl_node_t *child;
   zda_avl_node_t *replace_node;
-  if (!old_node->left) {
-    /* Single node */
-    if (!old_node->right) {
-      _zda_avl_node_transplant(tree, old_node, NULL);
-    } else {
-      /* Right only */
-      replace_node = old_node->right;
-      _zda_avl_node_transplant(tree, old_node, replace_node);
-      replace_node->left = old_node->left;
-    }
-  } else if (!old_node->right) {
-    /* Left only*/
-    replace_node = old_node->left;
-    _zda_avl_node_transplant(tree, old_node, replace_node);
-    replace_node->right = old_node->right;
+  zda_bool        is_left = parent && parent->left == old_node;
+
+  if (!old_node->left || !old_node->right) {
+    /* The child must be a leaf or NULL */
+    child = old_node->left ? old_node->left : old_node->right;
+    _zda_avl_tree_change_child(tree, parent, old_node, child);
+    if (child) _zda_avl_node_set_parent(child, parent);
   } else {
     /* Two children */
     replace_node = zda_avl_node_get_min(old_node->right);
+    _zda_avl_tree_change_child(tree, parent, old_node, replace_node);
 
-    if (replace_node->parent == old_node) {
-      assert(old_node->right == replace_node);
-      _zda_avl_node_transplant(tree, old_node, replace_node);
-      replace_node->left         = old_node->left;
-      replace_node->left->parent = replace_node;
+    if (replace_node == old_node->right) {
+      /* The right subtree of replace_node has shrunk */
+      parent  = replace_node;
+      is_left = zda_false;
     } else {
-      _zda_avl_node_transplant(tree, replace_node, replace_node->right);
-      parent       = replace_node->parent;
-      parent->left = replace_node->right;
+      parent  = zda_avl_node_get_parent(replace_node);
+      is_left = zda_true;
+      child   = replace_node->right;
+
+      parent->left = child;
+      if (child) _zda_avl_node_set_parent(child, parent);
 
-      _zda_avl_node_transplant(tree, old_node, replace_node);
-      replace_node->left = old_node->left;
-      if (replace_node->left) replace_node->left->parent = replace_node;
       replace_node->right = old_node->right;
-      if (replace_node->right) replace_node->right->parent = replace_node;
-      _zda_avl_node_update_height(replace_node);
-      _zda_avl_node_update_height(parent);
+      _zda_avl_node_set_parent(replace_node->right, replace_node);
     }
+
+    replace_node->left = old_node->left;
+    _zda_avl_node_set_parent(replace_node->left, replace_node);
+    /* Inherit the parent and balance factor of old_node */
+    replace_node->parent_bf = old_node->parent_bf;
   }
 
-  _zda_avl_tree_remove_fix(tree, parent);
+  _zda_avl_tree_remove_fix(tree, parent, is_left);
 }
 
 /**************************/
 /* Debug APIs */
 /**************************/
-static zda_bool zda_avl_node_verify_properties(zda_avl_node_t *node) zda_noexcept
+/* Check the balance factors and parent links, \p p_height is set to the height of \p node */
+static zda_bool zda_avl_node_verify_properties(
+    zda_avl_node_t *node,
+    zda_avl_node_t *parent,
+    size_t         *p_height
+) zda_noexcept
 {
   size_t lh, rh;
-  if (!node) return zda_true;
-  lh = _zda_avl_node_compute_height(node->left);
-  rh = _zda_avl_node_compute_height(node->right);
+  if (!node) {
+    *p_height = 0;
+    return zda_true;
+  }
+  if (zda_avl_node_get_parent(node) != parent) return zda_false;
+  if (!zda_avl_node_verify_properties(node->left, node, &lh)) return zda_false;
+  if (!zda_avl_node_verify_properties(node->right, node, &rh)) return zda_false;
 
-  int diff = lh - rh;
-  if (diff >= 2 || diff <= -2) {
+  int diff = (int)rh - (int)lh;
+  if (diff >= 2 || diff <= -2 || diff != zda_avl_node_get_bf(node)) {
     return zda_false;
   }
-  return zda_avl_node_verify_properties(node->left) && zda_avl_node_verify_properties(node->right);
+  *p_height = zda_max(lh, rh) + 1;
+  return zda_true;
 }
 
 zda_bool zda_avl_tree_verify_properties(zda_avl_tree_t *tree)
 {
-  return zda_avl_node_verify_properties(tree->node);
+  size_t height;
+  return zda_avl_node_verify_properties(tree->node, NULL, &height);
 }
 
 static zda_inline char *_make_new_prefix(char const *prefix, int entry_len, char const *new_tail)
@@ -331,7 +394,7 @@ static void _zda_avl_tree_print_tree(
   }
 
   int entry_len = print_cb(root);
-  entry_len     += ((printf("(%zu)\n", root->height)) - 1 - 1);
+  entry_len     += ((printf("(%d)\n", zda_avl_node_get_bf(root))) - 1 - 1);
 
   int has_left  = root->left != NULL;
   int has_right = root->right != NULL;
@@ -357,7 +420,7 @@ static void _zda_avl_tree_print_tree(
       new_prefix = _make_new_prefix(prefix, entry_len, "   ");
     }
     assert(new_prefix);
-    assert(root->right->parent == root);
+    assert(zda_avl_node_get_parent(root->right) == root);
     _zda_avl_tree_print_tree(tree, root->right, print_cb, new_prefix);
     free(new_prefix);
   }
@@ -369,7 +432,7 @@ static void _zda_avl_tree_print_tree(
     }
     printf("*── ");
     char *new_prefix = _make_new_prefix(prefix, entry_len, "   ");
-    assert(root->left->parent == root);
+    assert(zda_avl_node_get_parent(root->left) == root);
     _zda_avl_tree_print_tree(tree, root->left, print_cb, new_prefix);
     free(new_prefix);
   }
@@ -0,0 +1,438 @@
+#include "zda/cord.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace zda;
+using namespace zda::detail;
+
+/********************************/
+/* Buffer */
+/********************************/
+static void cord_buffer_free(CordBuffer *buf) zda_noexcept
+{
+    buf->~CordBuffer();
+    free(buf);
+}
+
+CordBuffer *zda::detail::cord_buffer_new(size_t capacity)
+{
+    /* The bytes are placed right after the header */
+    void *mem = malloc(sizeof(CordBuffer) + capacity);
+    if (!mem) throw std::bad_alloc{};
+
+    auto *buf     = new (mem) CordBuffer;
+    buf->refcnt.store(1, std::memory_order_relaxed);
+    buf->capacity = capacity;
+    buf->used     = 0;
+    buf->data     = reinterpret_cast<char *>(buf + 1);
+    buf->destroy  = &cord_buffer_free;
+    return buf;
+}
+
+namespace {
+
+struct CordStringBuffer : CordBuffer {
+    std::string str;
+};
+
+} // namespace
+
+static void cord_string_buffer_free(CordBuffer *buf) zda_noexcept
+{
+    delete static_cast<CordStringBuffer *>(buf);
+}
+
+CordBuffer *zda::detail::cord_buffer_from_string(std::string &&str)
+{
+    auto *buf = new CordStringBuffer;
+    buf->str  = std::move(str);
+    buf->refcnt.store(1, std::memory_order_relaxed);
+    /* The string is not appendable since its capacity is not known
+     * to be stable */
+    buf->capacity = 0;
+    buf->used     = buf->str.size();
+    buf->data     = &buf->str[0];
+    buf->destroy  = &cord_string_buffer_free;
+    return buf;
+}
+
+/********************************/
+/* Special members */
+/********************************/
+Cord::Cord(Cord const &other)
+  : chunks_(other.chunks_)
+  , size_(other.size_)
+{
+    for (auto const &chunk : chunks_)
+        cord_buffer_ref(chunk.buf);
+}
+
+Cord::Cord(Cord &&other) zda_noexcept : size_(other.size_)
+{
+    chunks_.swap(other.chunks_);
+    other.size_ = 0;
+}
+
+Cord &Cord::operator=(Cord const &other)
+{
+    if (this != &other) {
+        Cord tmp(other);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+Cord &Cord::operator=(Cord &&other) zda_noexcept
+{
+    if (this != &other) {
+        unref_all();
+        chunks_.clear();
+        chunks_.swap(other.chunks_);
+        size_       = other.size_;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+Cord::~Cord() zda_noexcept { unref_all(); }
+
+void Cord::unref_all() zda_noexcept
+{
+    for (auto const &chunk : chunks_)
+        cord_buffer_unref(chunk.buf);
+}
+
+/********************************/
+/* Chunk management */
+/********************************/
+
+/*
+ * The reference of chunk.buf is transferred to the cord.
+ * The chunk adjacent to the back is merged to it.
+ */
+void Cord::push_back_chunk(CordChunk chunk)
+{
+    if (!chunks_.empty()) {
+        auto &back = chunks_.back();
+        if (back.buf == chunk.buf && back.data + back.len == chunk.data) {
+            back.len += chunk.len;
+            size_ += chunk.len;
+            cord_buffer_unref(chunk.buf);
+            return;
+        }
+    }
+
+    try {
+        chunks_.push_back(chunk);
+    }
+    catch (...) {
+        cord_buffer_unref(chunk.buf);
+        throw;
+    }
+    size_ += chunk.len;
+}
+
+void Cord::push_front_chunk(CordChunk chunk)
+{
+    if (!chunks_.empty()) {
+        auto &front = chunks_.front();
+        if (front.buf == chunk.buf && chunk.data + chunk.len == front.data) {
+            front.data = chunk.data;
+            front.len += chunk.len;
+            size_ += chunk.len;
+            cord_buffer_unref(chunk.buf);
+            return;
+        }
+    }
+
+    try {
+        chunks_.push_front(chunk);
+    }
+    catch (...) {
+        cord_buffer_unref(chunk.buf);
+        throw;
+    }
+    size_ += chunk.len;
+}
+
+/********************************/
+/* Append */
+/********************************/
+void Cord::append(StringView str)
+{
+    char const *data = str.data();
+    size_t len       = str.size();
+
+    if (len == 0) return;
+
+    /* Fill the free space of the tail buffer if the cord is its only user */
+    if (!chunks_.empty()) {
+        auto &back = chunks_.back();
+        auto *buf  = back.buf;
+        if (buf && buf->capacity > buf->used &&
+            back.data + back.len == buf->data + buf->used &&
+            buf->refcnt.load(std::memory_order_acquire) == 1)
+        {
+            size_t const n = zda_min(len, buf->capacity - buf->used);
+            memcpy(buf->data + buf->used, data, n);
+            buf->used += n;
+            back.len += n;
+            size_ += n;
+            data += n;
+            len -= n;
+            if (len == 0) return;
+        }
+    }
+
+    auto *buf = cord_buffer_new(zda_max(len, BLOCK_SIZE));
+    memcpy(buf->data, data, len);
+    buf->used = len;
+    push_back_chunk({buf, buf->data, len});
+}
+
+void Cord::append(std::string &&str)
+{
+    if (str.size() < MOVE_THRESHOLD) {
+        append(StringView(str));
+        return;
+    }
+
+    auto *buf = cord_buffer_from_string(std::move(str));
+    push_back_chunk({buf, buf->data, buf->used});
+}
+
+void Cord::append(Cord const &cord)
+{
+    if (&cord == this) {
+        Cord tmp(cord);
+        append(std::move(tmp));
+        return;
+    }
+
+    for (auto const &chunk : cord.chunks_) {
+        cord_buffer_ref(chunk.buf);
+        push_back_chunk(chunk);
+    }
+}
+
+void Cord::append(Cord &&cord)
+{
+    if (&cord == this) {
+        append(static_cast<Cord const &>(cord));
+        return;
+    }
+
+    if (is_empty()) {
+        *this = std::move(cord);
+        return;
+    }
+
+    /* Pop the chunk before pushing it so that the reference is always
+     * owned by one of the cords */
+    while (!cord.chunks_.empty()) {
+        auto const chunk = cord.chunks_.front();
+        cord.chunks_.pop_front();
+        cord.size_ -= chunk.len;
+        push_back_chunk(chunk);
+    }
+}
+
+void Cord::append_borrowed(StringView str)
+{
+    if (str.size() == 0) return;
+    push_back_chunk({nullptr, str.data(), str.size()});
+}
+
+/********************************/
+/* Prepend */
+/********************************/
+void Cord::prepend(StringView str)
+{
+    if (str.size() == 0) return;
+
+    auto *buf = cord_buffer_new(str.size());
+    memcpy(buf->data, str.data(), str.size());
+    buf->used = str.size();
+    push_front_chunk({buf, buf->data, buf->used});
+}
+
+void Cord::prepend(std::string &&str)
+{
+    if (str.size() < MOVE_THRESHOLD) {
+        prepend(StringView(str));
+        return;
+    }
+
+    auto *buf = cord_buffer_from_string(std::move(str));
+    push_front_chunk({buf, buf->data, buf->used});
+}
+
+void Cord::prepend(Cord const &cord)
+{
+    if (&cord == this) {
+        Cord tmp(cord);
+        prepend(tmp);
+        return;
+    }
+
+    for (auto it = cord.chunks_.rbegin(); it != cord.chunks_.rend(); ++it) {
+        cord_buffer_ref(it->buf);
+        push_front_chunk(*it);
+    }
+}
+
+void Cord::prepend_borrowed(StringView str)
+{
+    if (str.size() == 0) return;
+    push_front_chunk({nullptr, str.data(), str.size()});
+}
+
+/********************************/
+/* Remove */
+/********************************/
+void Cord::remove_prefix(size_t n) zda_noexcept
+{
+    n = zda_min(n, size_);
+    size_ -= n;
+
+    while (n > 0) {
+        auto &front = chunks_.front();
+        if (front.len > n) {
+            front.data += n;
+            front.len -= n;
+            break;
+        }
+
+        n -= front.len;
+        cord_buffer_unref(front.buf);
+        chunks_.pop_front();
+    }
+}
+
+void Cord::remove_suffix(size_t n) zda_noexcept
+{
+    n = zda_min(n, size_);
+    size_ -= n;
+
+    while (n > 0) {
+        auto &back = chunks_.back();
+        if (back.len > n) {
+            back.len -= n;
+            break;
+        }
+
+        n -= back.len;
+        cord_buffer_unref(back.buf);
+        chunks_.pop_back();
+    }
+}
+
+void Cord::clear() zda_noexcept
+{
+    unref_all();
+    chunks_.clear();
+    size_ = 0;
+}
+
+Cord Cord::substr(size_t pos, size_t n) const
+{
+    Cord ret;
+
+    if (pos >= size_) return ret;
+    n = zda_min(n, size_ - pos);
+
+    for (auto const &chunk : chunks_) {
+        if (n == 0) break;
+        if (pos >= chunk.len) {
+            pos -= chunk.len;
+            continue;
+        }
+
+        size_t const len = zda_min(chunk.len - pos, n);
+        cord_buffer_ref(chunk.buf);
+        ret.push_back_chunk({chunk.buf, chunk.data + pos, len});
+        n -= len;
+        pos = 0;
+    }
+
+    return ret;
+}
+
+/********************************/
+/* Output */
+/********************************/
+size_t Cord::to_iovec(struct iovec *iov, size_t iovcnt) const zda_noexcept
+{
+    size_t const n = zda_min(iovcnt, chunks_.size());
+
+    for (size_t i = 0; i < n; ++i) {
+        iov[i].iov_base = const_cast<char *>(chunks_[i].data);
+        iov[i].iov_len  = chunks_[i].len;
+    }
+    return n;
+}
+
+size_t Cord::copy_to(char *buf, size_t n) const zda_noexcept
+{
+    size_t copied = 0;
+
+    for (auto const &chunk : chunks_) {
+        if (copied == n) break;
+        size_t const len = zda_min(chunk.len, n - copied);
+        memcpy(buf + copied, chunk.data, len);
+        copied += len;
+    }
+    return copied;
+}
+
+void Cord::append_to(std::string *p_str) const
+{
+    size_t const old_size = p_str->size();
+    p_str->resize(old_size + size_);
+    copy_to(&(*p_str)[old_size], size_);
+}
+
+std::string Cord::to_string() const
+{
+    std::string ret;
+    append_to(&ret);
+    return ret;
+}
+
+StringView Cord::flatten()
+{
+    if (chunks_.empty()) return StringView(nullptr, 0);
+
+    if (chunks_.size() > 1) {
+        auto *buf = cord_buffer_new(size_);
+        buf->used = copy_to(buf->data, size_);
+
+        std::deque<CordChunk> flat;
+        try {
+            flat.push_back({buf, buf->data, buf->used});
+        }
+        catch (...) {
+            cord_buffer_unref(buf);
+            throw;
+        }
+
+        unref_all();
+        chunks_.swap(flat);
+    }
+
+    return chunk(0);
+}
+
+bool Cord::equals(StringView str) const zda_noexcept
+{
+    if (str.size() != size_) return false;
+
+    char const *p = str.data();
+    for (auto const &chunk : chunks_) {
+        if (memcmp(chunk.data, p, chunk.len) != 0) return false;
+        p += chunk.len;
+    }
+    return true;
+}
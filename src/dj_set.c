@@ -3,8 +3,8 @@
 zda_dj_set_node_t *zda_dj_set_union(zda_dj_set_node_t *lnode,
                                     zda_dj_set_node_t *rnode) zda_noexcept
 {
-    zda_dj_set_node_t *left = zda_dj_set_find(lnode);
-    zda_dj_set_node_t *right = zda_dj_set_find(rnode);
+    zda_dj_set_node_t *left = zda_dj_set_find_halving(lnode);
+    zda_dj_set_node_t *right = zda_dj_set_find_halving(rnode);
     
     if (left == right) return NULL;
 
@@ -20,4 +20,60 @@ zda_dj_set_node_t *zda_dj_set_union(zda_dj_set_node_t *lnode,
         new_root = left;
     }
     return new_root;
-}
\ No newline at end of file
+}
+
+zda_dj_set_node_t *zda_dj_set_union_size(zda_dj_set_node_t *lnode,
+                                         zda_dj_set_node_t *rnode) zda_noexcept
+{
+    zda_dj_set_node_t *left = zda_dj_set_find_halving(lnode);
+    zda_dj_set_node_t *right = zda_dj_set_find_halving(rnode);
+    zda_dj_set_node_t *tmp;
+
+    if (left == right) return NULL;
+
+    /* Make the left is the larger one */
+    if (left->rank < right->rank) {
+        tmp = left;
+        left = right;
+        right = tmp;
+    }
+
+    right->parent = left;
+    left->rank += right->rank;
+    return left;
+}
+
+zda_dj_set_node_t *zda_dj_set_cunion(zda_dj_set_node_t *lnode,
+                                     zda_dj_set_node_t *rnode) zda_noexcept
+{
+    zda_dj_set_node_t *tmp;
+
+    for (;;) {
+        lnode = zda_dj_set_cfind(lnode);
+        rnode = zda_dj_set_cfind(rnode);
+        if (lnode == rnode) return NULL;
+
+        /* Link the lower priority root to the higher one */
+        if (_zda_dj_set_priority(lnode) > _zda_dj_set_priority(rnode)) {
+            tmp = lnode;
+            lnode = rnode;
+            rnode = tmp;
+        }
+
+        /* Fails if lnode is not a root anymore */
+        if (_zda_dj_set_cas_parent(lnode, lnode, rnode)) return rnode;
+    }
+}
+
+zda_bool zda_dj_set_csame(zda_dj_set_node_t *lnode,
+                          zda_dj_set_node_t *rnode) zda_noexcept
+{
+    for (;;) {
+        lnode = zda_dj_set_cfind(lnode);
+        rnode = zda_dj_set_cfind(rnode);
+        if (lnode == rnode) return zda_true;
+        /* lnode is still root, so rnode is not in the same set at the moment that
+         * rnode is found. Otherwise, lnode is linked by other thread, retry. */
+        if (_zda_dj_set_load_parent(lnode) == lnode) return zda_false;
+    }
+}
@@ -0,0 +1,63 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#include "zda/dj_set_array.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+zda_bool zda_dj_set_array_init(zda_dj_set_array_t *set, uint32_t n) zda_noexcept
+{
+    set->n = n;
+    set->parent = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)n);
+    /* All ranks are 0 */
+    set->rank = (uint8_t *)calloc(n, sizeof(uint8_t));
+    if ((!set->parent || !set->rank) && n != 0) {
+        zda_dj_set_array_destroy(set);
+        return zda_false;
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        set->parent[i] = i;
+    }
+    return zda_true;
+}
+
+void zda_dj_set_array_destroy(zda_dj_set_array_t *set) zda_noexcept
+{
+    free(set->parent);
+    free(set->rank);
+    set->parent = NULL;
+    set->rank = NULL;
+    set->n = 0;
+}
+
+size_t zda_dj_set_array_union_edges(zda_dj_set_array_t *set,
+                                    uint32_t const *edges,
+                                    size_t n) zda_noexcept
+{
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += zda_dj_set_array_union(set, edges[2 * i], edges[2 * i + 1]) !=
+                 ZDA_DJ_SET_ARRAY_NONE;
+    }
+    return count;
+}
+
+uint32_t zda_dj_set_array_flatten(zda_dj_set_array_t *set, uint32_t *ids) zda_noexcept
+{
+    uint32_t count = 0;
+    uint32_t root;
+
+    /* The ids[root] is the id of the set, it may be assigned
+     * before the root is visited since the root can be greater than the element. */
+    memset(ids, 0xff, sizeof(uint32_t) * (size_t)set->n);
+
+    for (uint32_t i = 0; i < set->n; ++i) {
+        root = zda_dj_set_array_find(set, i);
+        set->parent[i] = root;
+        if (ids[root] == ZDA_DJ_SET_ARRAY_NONE) {
+            ids[root] = count++;
+        }
+        ids[i] = ids[root];
+    }
+    return count;
+}
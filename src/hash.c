@@ -0,0 +1,294 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#include "zda/hash.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  if defined(__GNUC__) && defined(__SSE2__)
+#    define _ZDA_HASH_X86 1
+#    include <immintrin.h>
+#  endif
+#endif
+
+/* Inputs longer than this use the stripe accumulation */
+#define _ZDA_HASH_LONG_THRESHOLD 256
+
+#define _ZDA_HASH_STRIPE_LEN       64
+#define _ZDA_HASH_STRIPES_PER_BLOCK 16
+#define _ZDA_HASH_BLOCK_LEN        (_ZDA_HASH_STRIPE_LEN * _ZDA_HASH_STRIPES_PER_BLOCK)
+
+static uint64_t const _zda_hash_p0 = 0xa0761d6478bd642fULL;
+static uint64_t const _zda_hash_p1 = 0xe7037ed1a0b428dbULL;
+static uint64_t const _zda_hash_p2 = 0x8ebc6af09c88c6e3ULL;
+static uint64_t const _zda_hash_p3 = 0x589965cc75374cc3ULL;
+
+/*
+ * The stripe s is mixed with the secret[8*s, 8*s+64), the different keys
+ * make the permuted stripes in a block hash differently.
+ * The values are generated by splitmix64.
+ */
+static uint64_t const _zda_hash_secret[24] = {
+    0x2cb0f69f4abea221ULL, 0x9417034723148989ULL, 0xdd555950609dfe03ULL,
+    0xdbafb150deb12800ULL, 0x7e789b2e6c442cb6ULL, 0xf41e5636c7e4f8c4ULL,
+    0x0959d150f8fba7e4ULL, 0xa97316f13cdb9eeaULL, 0x74cd8258f9520068ULL,
+    0x55c74a62e116868bULL, 0xd2f4c799a2023cbdULL, 0xdf98cb79a37b51b9ULL,
+    0x396f5885524f3905ULL, 0xaf1d56386ca3b276ULL, 0xa9ffbe6b5104e85aULL,
+    0x6bd0c51b9fd533b3ULL, 0x980ce91c50ab4b56ULL, 0x28ac395780fe62c5ULL,
+    0x768912e3a6bcedc7ULL, 0x50b3e8c9332c7c88ULL, 0xce3bbfe520bd47daULL,
+    0xcba6c8e8e0bb7c4fULL, 0xbf194db8434a346dULL, 0x7d8f2a7b60416d7fULL,
+};
+
+#define _ZDA_HASH_SECRET ((char const *)_zda_hash_secret)
+
+static zda_inline uint64_t _zda_hash_read64(char const *p)
+{
+    uint64_t ret;
+    memcpy(&ret, p, 8);
+    return ret;
+}
+
+static zda_inline uint64_t _zda_hash_read32(char const *p)
+{
+    uint32_t ret;
+    memcpy(&ret, p, 4);
+    return ret;
+}
+
+/* Read the 1~3 bytes: the first, middle and last byte */
+static zda_inline uint64_t _zda_hash_read_small(char const *p, size_t k)
+{
+    unsigned char const *up = (unsigned char const *)p;
+    return ((uint64_t)up[0] << 16) | ((uint64_t)up[k >> 1] << 8) | up[k - 1];
+}
+
+static zda_inline void _zda_hash_mum128(uint64_t *a, uint64_t *b)
+{
+    unsigned __int128 const r = (unsigned __int128)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+}
+
+static zda_inline uint64_t _zda_hash_mum(uint64_t a, uint64_t b)
+{
+    _zda_hash_mum128(&a, &b);
+    return a ^ b;
+}
+
+/***************************/
+/* Stripe accumulation */
+/***************************/
+/*
+ * For each 8-byte lane i of the stripe:
+ *   k = data[i] ^ key[i]
+ *   acc[i] += lo32(k) * hi32(k)
+ *   acc[i^1] += data[i]
+ * The 32x32->64 multiply is native in SSE2/AVX2(pmuludq), so all kernels
+ * compute the same result.
+ */
+typedef void (*_zda_hash_accumulate_fn)(
+    uint64_t   *acc,
+    char const *p,
+    char const *secret,
+    size_t      nstripes
+);
+
+static void
+_zda_hash_accumulate_scalar(uint64_t *acc, char const *p, char const *secret, size_t nstripes)
+{
+    for (size_t s = 0; s < nstripes; ++s) {
+        char const *stripe = p + s * _ZDA_HASH_STRIPE_LEN;
+        char const *key    = secret + s * 8;
+        for (int i = 0; i < 8; ++i) {
+            uint64_t const d = _zda_hash_read64(stripe + 8 * i);
+            uint64_t const k = d ^ _zda_hash_read64(key + 8 * i);
+            acc[i ^ 1] += d;
+            acc[i] += (k & 0xffffffff) * (k >> 32);
+        }
+    }
+}
+
+#ifdef _ZDA_HASH_X86
+static void
+_zda_hash_accumulate_sse2(uint64_t *acc, char const *p, char const *secret, size_t nstripes)
+{
+    __m128i a[4];
+
+    for (int j = 0; j < 4; ++j)
+        a[j] = _mm_loadu_si128((__m128i const *)(acc + 2 * j));
+
+    for (size_t s = 0; s < nstripes; ++s) {
+        char const *stripe = p + s * _ZDA_HASH_STRIPE_LEN;
+        char const *key    = secret + s * 8;
+        for (int j = 0; j < 4; ++j) {
+            __m128i const d    = _mm_loadu_si128((__m128i const *)(stripe + 16 * j));
+            __m128i const k    = _mm_xor_si128(d, _mm_loadu_si128((__m128i const *)(key + 16 * j)));
+            __m128i const prod = _mm_mul_epu32(k, _mm_srli_epi64(k, 32));
+            __m128i const swap = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+            a[j]               = _mm_add_epi64(a[j], _mm_add_epi64(prod, swap));
+        }
+    }
+
+    for (int j = 0; j < 4; ++j)
+        _mm_storeu_si128((__m128i *)(acc + 2 * j), a[j]);
+}
+
+__attribute__((target("avx2"))) static void
+_zda_hash_accumulate_avx2(uint64_t *acc, char const *p, char const *secret, size_t nstripes)
+{
+    __m256i a[2];
+
+    for (int j = 0; j < 2; ++j)
+        a[j] = _mm256_loadu_si256((__m256i const *)(acc + 4 * j));
+
+    for (size_t s = 0; s < nstripes; ++s) {
+        char const *stripe = p + s * _ZDA_HASH_STRIPE_LEN;
+        char const *key    = secret + s * 8;
+        for (int j = 0; j < 2; ++j) {
+            __m256i const d = _mm256_loadu_si256((__m256i const *)(stripe + 32 * j));
+            __m256i const k =
+                _mm256_xor_si256(d, _mm256_loadu_si256((__m256i const *)(key + 32 * j)));
+            __m256i const prod = _mm256_mul_epu32(k, _mm256_srli_epi64(k, 32));
+            __m256i const swap = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+            a[j]               = _mm256_add_epi64(a[j], _mm256_add_epi64(prod, swap));
+        }
+    }
+
+    for (int j = 0; j < 2; ++j)
+        _mm256_storeu_si256((__m256i *)(acc + 4 * j), a[j]);
+}
+#endif /* _ZDA_HASH_X86 */
+
+static void _zda_hash_accumulate_resolve(uint64_t *, char const *, char const *, size_t);
+
+static _zda_hash_accumulate_fn _zda_hash_accumulate_impl = _zda_hash_accumulate_resolve;
+
+static void
+_zda_hash_accumulate_resolve(uint64_t *acc, char const *p, char const *secret, size_t nstripes)
+{
+    _zda_hash_accumulate_fn fn = _zda_hash_accumulate_scalar;
+#ifdef _ZDA_HASH_X86
+    __builtin_cpu_init();
+    fn = __builtin_cpu_supports("avx2") ? _zda_hash_accumulate_avx2 : _zda_hash_accumulate_sse2;
+#endif
+    __atomic_store_n(&_zda_hash_accumulate_impl, fn, __ATOMIC_RELAXED);
+    fn(acc, p, secret, nstripes);
+}
+
+/* Spread the high bits of the accumulators to the low bits used by pmuludq */
+static void _zda_hash_scramble(uint64_t *acc, char const *secret)
+{
+    for (int i = 0; i < 8; ++i) {
+        acc[i] ^= acc[i] >> 47;
+        acc[i] ^= _zda_hash_read64(secret + 8 * i);
+        acc[i] *= 0x9e3779b1ULL;
+    }
+}
+
+/* Precondition: len > _ZDA_HASH_LONG_THRESHOLD */
+static uint64_t _zda_hash_long(char const *p, size_t len, uint64_t seed)
+{
+    _zda_hash_accumulate_fn const accumulate =
+        __atomic_load_n(&_zda_hash_accumulate_impl, __ATOMIC_RELAXED);
+    uint64_t acc[8] = {
+        _zda_hash_p0 ^ seed,
+        _zda_hash_p1,
+        _zda_hash_p2,
+        _zda_hash_p3,
+        _zda_hash_p0,
+        _zda_hash_p1 ^ seed,
+        _zda_hash_p2,
+        _zda_hash_p3,
+    };
+    size_t const nblocks = (len - 1) / _ZDA_HASH_BLOCK_LEN;
+    size_t       nstripes;
+    uint64_t     ret;
+
+    for (size_t b = 0; b < nblocks; ++b) {
+        accumulate(acc, p + b * _ZDA_HASH_BLOCK_LEN, _ZDA_HASH_SECRET, _ZDA_HASH_STRIPES_PER_BLOCK);
+        _zda_hash_scramble(acc, _ZDA_HASH_SECRET + 128);
+    }
+
+    /* The last partial block and the last(maybe overlapped) stripe */
+    nstripes = ((len - 1) - nblocks * _ZDA_HASH_BLOCK_LEN) / _ZDA_HASH_STRIPE_LEN;
+    accumulate(acc, p + nblocks * _ZDA_HASH_BLOCK_LEN, _ZDA_HASH_SECRET, nstripes);
+    accumulate(acc, p + len - _ZDA_HASH_STRIPE_LEN, _ZDA_HASH_SECRET + 121, 1);
+
+    ret = (uint64_t)len * _zda_hash_p0;
+    for (int i = 0; i < 4; ++i) {
+        ret += _zda_hash_mum(
+            acc[2 * i] ^ _zda_hash_secret[2 * i + 3],
+            acc[2 * i + 1] ^ _zda_hash_secret[2 * i + 4]
+        );
+    }
+    return ret ^ seed;
+}
+
+/***************************/
+/* Public APIs */
+/***************************/
+uint64_t zda_hash_bytes(void const *data, size_t len, uint64_t seed) zda_noexcept
+{
+    char const *p = (char const *)data;
+    uint64_t    a, b;
+
+    seed ^= _zda_hash_mum(seed ^ _zda_hash_p0, _zda_hash_p1);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            /* Two overlapping 8-byte words from four 4-byte loads */
+            size_t const off = (len >> 3) << 2;
+            a = (_zda_hash_read32(p) << 32) | _zda_hash_read32(p + off);
+            b = (_zda_hash_read32(p + len - 4) << 32) | _zda_hash_read32(p + len - 4 - off);
+        } else if (len > 0) {
+            a = _zda_hash_read_small(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else if (len <= _ZDA_HASH_LONG_THRESHOLD) {
+        size_t i = len;
+
+        if (i > 48) {
+            /* Three independent lanes to hide the multiply latency */
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+            do {
+                seed = _zda_hash_mum(
+                    _zda_hash_read64(p) ^ _zda_hash_p1,
+                    _zda_hash_read64(p + 8) ^ seed
+                );
+                see1 = _zda_hash_mum(
+                    _zda_hash_read64(p + 16) ^ _zda_hash_p2,
+                    _zda_hash_read64(p + 24) ^ see1
+                );
+                see2 = _zda_hash_mum(
+                    _zda_hash_read64(p + 32) ^ _zda_hash_p3,
+                    _zda_hash_read64(p + 40) ^ see2
+                );
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16) {
+            seed = _zda_hash_mum(_zda_hash_read64(p) ^ _zda_hash_p1, _zda_hash_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        /* The last 16 bytes, maybe overlapped with the processed bytes */
+        a = _zda_hash_read64(p + i - 16);
+        b = _zda_hash_read64(p + i - 8);
+    } else {
+        seed = _zda_hash_long(p, len, seed);
+        a    = _zda_hash_read64(p + len - 16);
+        b    = _zda_hash_read64(p + len - 8);
+    }
+
+    a ^= _zda_hash_p1;
+    b ^= seed;
+    _zda_hash_mum128(&a, &b);
+    return _zda_hash_mum(a ^ _zda_hash_p0 ^ len, b ^ _zda_hash_p1);
+}
@@ -0,0 +1,181 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#define _FILE_OFFSET_BITS 64
+
+#include "zda/ht_snapshot.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  define _ZDA_HT_SNAPSHOT_MMAP 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#define _ZDA_HT_SNAPSHOT_MAGIC   "ZDAHTSNP"
+#define _ZDA_HT_SNAPSHOT_ENDIAN  0x0102030405060708ULL
+#define _ZDA_HT_SNAPSHOT_VERSION 1
+
+typedef struct _zda_ht_snapshot_header {
+  char     magic[8];
+  uint64_t endian;
+  uint64_t version;
+  uint64_t bkt_capa;
+  uint64_t cnt;
+  uint64_t bkts_off;
+  uint64_t size;
+  uint64_t reserved;
+} _zda_ht_snapshot_header_t;
+
+static int _zda_ht_snapshot_write_record(FILE *fp, void const *data, size_t len) zda_noexcept
+{
+  static char const padding[8] = {0};
+  uint64_t const    len64      = len;
+  size_t const      pad        = (size_t)(_zda_ht_snapshot_record_stride(len) - 8 - len);
+
+  if (fwrite(&len64, sizeof len64, 1, fp) != 1) return -1;
+  if (len && fwrite(data, len, 1, fp) != 1) return -1;
+  if (pad && fwrite(padding, pad, 1, fp) != 1) return -1;
+  return 0;
+}
+
+int zda_ht_snapshot_write(
+    zda_ht_t const       *ht,
+    FILE                 *fp,
+    zda_ht_serialize_cb_t serialize,
+    void                 *ctx
+) zda_noexcept
+{
+  _zda_ht_snapshot_header_t header;
+  size_t const              bkts_size = (ht->bkt_capa + 1) * sizeof(uint64_t);
+  uint64_t                 *bkts      = (uint64_t *)malloc(bkts_size);
+  size_t                    buf_size  = 256;
+  void                     *buf       = malloc(buf_size);
+  off_t const               base      = ftello(fp);
+  uint64_t                  off       = sizeof header + bkts_size;
+  int                       ret       = -1;
+
+  if (!bkts || !buf || base < 0) goto out;
+
+  /* The header and bucket offsets are written after the records */
+  if (fseeko(fp, base + (off_t)off, SEEK_SET) != 0) goto out;
+
+  for (size_t i = 0; i < ht->bkt_capa; ++i) {
+    bkts[i] = off;
+    for (zda_ht_node_t const *pos = ht->tb[i].node.next; pos != NULL; pos = pos->next) {
+      size_t len = serialize(pos, buf, buf_size, ctx);
+
+      if (len == (size_t)-1) goto out;
+      if (len > buf_size) {
+        void *new_buf = realloc(buf, len);
+        if (!new_buf) goto out;
+        buf      = new_buf;
+        buf_size = len;
+        len      = serialize(pos, buf, buf_size, ctx);
+        if (len == (size_t)-1 || len > buf_size) goto out;
+      }
+
+      if (_zda_ht_snapshot_write_record(fp, buf, len) != 0) goto out;
+      off += _zda_ht_snapshot_record_stride(len);
+    }
+  }
+  bkts[ht->bkt_capa] = off;
+
+  memset(&header, 0, sizeof header);
+  memcpy(header.magic, _ZDA_HT_SNAPSHOT_MAGIC, sizeof header.magic);
+  header.endian   = _ZDA_HT_SNAPSHOT_ENDIAN;
+  header.version  = _ZDA_HT_SNAPSHOT_VERSION;
+  header.bkt_capa = ht->bkt_capa;
+  header.cnt      = ht->cnt;
+  header.bkts_off = sizeof header;
+  header.size     = off;
+
+  if (fseeko(fp, base, SEEK_SET) != 0) goto out;
+  if (fwrite(&header, sizeof header, 1, fp) != 1) goto out;
+  if (fwrite(bkts, bkts_size, 1, fp) != 1) goto out;
+  if (fseeko(fp, base + (off_t)off, SEEK_SET) != 0) goto out;
+  if (fflush(fp) != 0) goto out;
+  ret = 0;
+
+out:
+  free(bkts);
+  free(buf);
+  return ret;
+}
+
+/*
+ * Only the O(1) checks are done, checking every record would read the whole file and defeat
+ * the purpose of mmap().
+ */
+int zda_ht_snapshot_init(zda_ht_snapshot_t *snap, void const *base, size_t size) zda_noexcept
+{
+  _zda_ht_snapshot_header_t const *header = (_zda_ht_snapshot_header_t const *)base;
+  uint64_t                         bkts_end;
+  uint64_t const                  *bkts;
+
+  if (size < sizeof *header || ((uintptr_t)base & 7) != 0) return -1;
+  if (memcmp(header->magic, _ZDA_HT_SNAPSHOT_MAGIC, sizeof header->magic) != 0) return -1;
+  if (header->endian != _ZDA_HT_SNAPSHOT_ENDIAN) return -1;
+  if (header->version != _ZDA_HT_SNAPSHOT_VERSION) return -1;
+  if (header->bkt_capa & (header->bkt_capa - 1)) return -1;
+  if (header->bkts_off != sizeof *header || header->size > size) return -1;
+  if (header->bkt_capa >= (size - sizeof *header) / sizeof(uint64_t)) return -1;
+
+  bkts     = (uint64_t const *)((char const *)base + header->bkts_off);
+  bkts_end = header->bkts_off + (header->bkt_capa + 1) * sizeof(uint64_t);
+  if (bkts[0] != bkts_end || bkts[header->bkt_capa] != header->size) return -1;
+  if (header->cnt > 0 && header->bkt_capa == 0) return -1;
+
+  snap->base     = (char const *)base;
+  snap->size     = size;
+  snap->bkts     = bkts;
+  snap->bkt_capa = (size_t)header->bkt_capa;
+  snap->cnt      = (size_t)header->cnt;
+  snap->mask     = header->bkt_capa ? (size_t)header->bkt_capa - 1 : 0;
+  snap->mapped   = zda_false;
+  return 0;
+}
+
+int zda_ht_snapshot_open(zda_ht_snapshot_t *snap, char const *path) zda_noexcept
+{
+#ifdef _ZDA_HT_SNAPSHOT_MMAP
+  struct stat st;
+  void       *base;
+  int const   fd = open(path, O_RDONLY);
+
+  if (fd < 0) return -1;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return -1;
+  }
+
+  base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  /* The mapping keeps the file referenced */
+  close(fd);
+  if (base == MAP_FAILED) return -1;
+
+  if (zda_ht_snapshot_init(snap, base, (size_t)st.st_size) != 0) {
+    munmap(base, (size_t)st.st_size);
+    return -1;
+  }
+  snap->mapped = zda_true;
+  return 0;
+#else
+  (void)snap;
+  (void)path;
+  return -1;
+#endif
+}
+
+void zda_ht_snapshot_close(zda_ht_snapshot_t *snap) zda_noexcept
+{
+#ifdef _ZDA_HT_SNAPSHOT_MMAP
+  if (snap->mapped) munmap((void *)snap->base, snap->size);
+#endif
+  snap->base   = NULL;
+  snap->size   = 0;
+  snap->cnt    = 0;
+  snap->mapped = zda_false;
+}
@@ -169,40 +169,13 @@ zda_rb_node_t *zda_rb_node_get_successor(zda_rb_header_t *header, zda_rb_node_t
    * Because nodes in the find path > node.
    */
   zda_rb_node_t *parent = node->parent;
-  while (parent->right == node) {
+  /* The header is the parent of root, and its right pointer to the maximum, so stop at it to
+   * return the header as the terminator when the node is the maximum */
+  while (!_zda_rb_node_is_header(header, parent) && parent->right == node) {
     node   = parent;
     parent = node->parent;
   }
 
-  /*
-   * when parent == header and node == root,
-   * then parent == root, node == header, will break the loop and
-   * I expect to return header as the terminator.
-   *
-   * 1. If the `header->left` pointer to the maximum node,
-   * ie. `header->right` pointer to the minimum node.
-   *  1.1 `parent->right` may pointer to the root when root is the minimum node.
-   * the parent will be the root and return it.
-   * This will trigger infinite iterate of tree nodes.
-   *
-   *  1.2 `parent->right` may pointer to the root whien root is the maximum node.
-   * ie. the tree contains the root only.
-   * the parent will be the root.
-   *
-   * 2. If the `header->right` pointer to the maximum node,
-   *  2.1 The `parent->right` don't pointer to the minimum node when the nodes count of tree > 1.
-   *  2.2 `parent->right` may pointer to the maximum node when root is the only node of tree.
-   * the parent will be the root.
-   *
-   * Becase the 2. cases need to handle is less than 1.
-   * I select the 2. plan.
-   */
-
-  /* The reverse condition can meet only when node is the header */
-  if (node->right == parent) {
-    return node;
-  }
-
   return parent;
 }
 
@@ -435,6 +408,50 @@ int zda_rb_tree_find_insert_slot(
   return 1;
 }
 
+/***************************************/
+/* Bulk build APIs */
+/***************************************/
+/* Link nodes[lo, hi) as the subtree of \p parent, the nodes whose depth is \p red_depth(i.e. the
+ * incomplete last level) are red to keep the black height same */
+static zda_rb_node_t *_zda_rb_tree_build_sorted(
+    zda_rb_header_t *header,
+    zda_rb_node_t  **nodes,
+    size_t           lo,
+    size_t           hi,
+    zda_rb_node_t   *parent,
+    size_t           depth,
+    size_t           red_depth
+)
+{
+  if (lo == hi) return ZDA_RB_HEADER_NODE;
+
+  size_t const   mid  = lo + (hi - lo) / 2;
+  zda_rb_node_t *node = nodes[mid];
+  node->parent        = parent;
+  node->color         = depth == red_depth ? ZDA_RB_COLOR_RED : ZDA_RB_COLOR_BLACK;
+  node->left  = _zda_rb_tree_build_sorted(header, nodes, lo, mid, node, depth + 1, red_depth);
+  node->right = _zda_rb_tree_build_sorted(header, nodes, mid + 1, hi, node, depth + 1, red_depth);
+  return node;
+}
+
+void zda_rb_tree_build_sorted(zda_rb_header_t *header, zda_rb_node_t **nodes, size_t n) zda_noexcept
+{
+  size_t red_depth = 0;
+  assert(zda_rb_tree_is_empty(header));
+  if (n == 0) return;
+
+  /* The midpoint split makes the null links at the depth floor(log2(n+1)) or one more,
+   * the nodes at floor(log2(n+1)) exist only if the last level is not full */
+  while (((size_t)2 << red_depth) - 1 <= n) ++red_depth;
+
+  _zda_rb_node_set_root(
+      header,
+      _zda_rb_tree_build_sorted(header, nodes, 0, n, ZDA_RB_HEADER_NODE, 0, red_depth)
+  );
+  _zda_rb_header_set_minimum(header, nodes[0]);
+  _zda_rb_header_set_maximum(header, nodes[n - 1]);
+}
+
 /***************************************/
 /* Search APIs */
 /***************************************/
@@ -456,6 +473,71 @@ zda_rb_node_t *zda_rb_tree_search(zda_rb_header_t *header, void const *key, zda_
   return p_result;
 }
 
+/* The fake entry type to reuse the integer macros,
+ * the key is loaded by the offset relative to the node */
+typedef struct _zda_rb_raw_entry {
+  zda_rb_node_t node;
+} _zda_rb_raw_entry_t;
+
+#define _ZDA_RB_RAW_KEY(entry, key_type)                                                           \
+  (*(key_type const *)((char const *)&(entry)->node + key_offset))
+#define _ZDA_RB_RAW_U32_KEY(entry) _ZDA_RB_RAW_KEY(entry, uint32_t)
+#define _ZDA_RB_RAW_U64_KEY(entry) _ZDA_RB_RAW_KEY(entry, uint64_t)
+
+zda_rb_node_t *zda_rb_tree_search_u32(zda_rb_header_t *header, uint32_t key, ptrdiff_t key_offset)
+    zda_noexcept
+{
+  _zda_rb_raw_entry_t *p_result;
+  zda_rb_tree_search_int_inplace(header, key, _zda_rb_raw_entry_t, _ZDA_RB_RAW_U32_KEY, p_result);
+  return p_result ? &p_result->node : &header->node;
+}
+
+zda_rb_node_t *zda_rb_tree_search_u64(zda_rb_header_t *header, uint64_t key, ptrdiff_t key_offset)
+    zda_noexcept
+{
+  _zda_rb_raw_entry_t *p_result;
+  zda_rb_tree_search_int_inplace(header, key, _zda_rb_raw_entry_t, _ZDA_RB_RAW_U64_KEY, p_result);
+  return p_result ? &p_result->node : &header->node;
+}
+
+zda_rb_node_t *zda_rb_tree_insert_check_u32(
+    zda_rb_header_t     *header,
+    uint32_t             key,
+    ptrdiff_t            key_offset,
+    zda_rb_commit_ctx_t *p_ctx
+) zda_noexcept
+{
+  _zda_rb_raw_entry_t *p_dup;
+  zda_rb_tree_insert_check_int_inplace(
+      header,
+      key,
+      _zda_rb_raw_entry_t,
+      _ZDA_RB_RAW_U32_KEY,
+      *p_ctx,
+      p_dup
+  );
+  return p_dup ? &p_dup->node : NULL;
+}
+
+zda_rb_node_t *zda_rb_tree_insert_check_u64(
+    zda_rb_header_t     *header,
+    uint64_t             key,
+    ptrdiff_t            key_offset,
+    zda_rb_commit_ctx_t *p_ctx
+) zda_noexcept
+{
+  _zda_rb_raw_entry_t *p_dup;
+  zda_rb_tree_insert_check_int_inplace(
+      header,
+      key,
+      _zda_rb_raw_entry_t,
+      _ZDA_RB_RAW_U64_KEY,
+      *p_ctx,
+      p_dup
+  );
+  return p_dup ? &p_dup->node : NULL;
+}
+
 /*--------------------------------------------------------------------------------------*/
 /* Remove aux */
 /*--------------------------------------------------------------------------------------*/
@@ -744,6 +826,9 @@ size_t zda_rb_tree_get_height(zda_rb_header_t *header, zda_rb_node_t *root)
 
 size_t zda_rb_tree_get_234_height(zda_rb_header_t *header, zda_rb_node_t *root)
 {
+  /* The links of header pointer to the minimum and maximum instead of children */
+  if (zda_rb_node_is_nil(header, root)) return 0;
+
   size_t lh = 0;
   if (!zda_rb_node_is_nil(header, root->left)) {
     lh = zda_rb_tree_get_234_height(header, root->left);
@@ -0,0 +1,157 @@
+#include "zda/string_pool.hpp"
+#include "zda/hash.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+using namespace zda;
+using namespace zda::detail;
+
+/********************************/
+/* Arena */
+/********************************/
+StringArena::~StringArena() zda_noexcept
+{
+    while (block_) {
+        Block *next = block_->next;
+        free(block_);
+        block_ = next;
+    }
+}
+
+char *StringArena::allocate_slow(size_t n, size_t align)
+{
+    /* The large request takes a dedicated block to not waste the current one */
+    bool const large      = n + align > BLOCK_SIZE / 4;
+    size_t const capacity = large ? sizeof(Block) + n + align : BLOCK_SIZE;
+    auto *block           = (Block *)malloc(capacity);
+    if (!block) throw std::bad_alloc{};
+
+    char *begin = (char *)(block + 1);
+    char *end   = (char *)block + capacity;
+    char *ret   = begin + ((size_t)(-(uintptr_t)begin) & (align - 1));
+
+    size_ += capacity;
+    if (large && block_) {
+        /* Keep the current block for the following small requests */
+        block->next  = block_->next;
+        block_->next = block;
+        return ret;
+    }
+
+    block->next = block_;
+    block_      = block;
+    cur_        = ret + n;
+    end_        = end;
+    return ret;
+}
+
+/********************************/
+/* Table callbacks */
+/********************************/
+static zda_inline StringPoolKey const &pool_get_key(StringPoolEntry const *entry) zda_noexcept
+{
+    return entry->key;
+}
+
+static zda_inline size_t pool_hash(StringPoolKey const &key) zda_noexcept
+{
+    return (size_t)key.hash;
+}
+
+static zda_inline bool pool_equal(StringPoolKey const &x, StringPoolKey const &y) zda_noexcept
+{
+    return x.hash == y.hash && x.len == y.len && memcmp(x.data, y.data, x.len) == 0;
+}
+
+static zda_inline StringPoolKey pool_make_key(StringView str) zda_noexcept
+{
+    return StringPoolKey{str.data(), str.size(), zda_hash_bytes(str.data(), str.size(), 0)};
+}
+
+/********************************/
+/* Pool */
+/********************************/
+#if __cplusplus < 201703L
+/* The static constexpr member isn't implicitly inline before C++17 */
+constexpr StringPool::Id StringPool::INVALID_ID;
+#endif
+
+StringPool::~StringPool() zda_noexcept
+{
+    /* The entries are in the arena */
+    free(ht_.tb);
+}
+
+StringPool::Id StringPool::intern(StringView str)
+{
+    StringPoolKey key = pool_make_key(str);
+    StringPoolEntry *p_dup;
+    zda_ht_commit_ctx_t commit_ctx;
+
+    if (frozen_) {
+        zda_ht_search_inplace(&ht_,
+                              key,
+                              StringPoolEntry,
+                              pool_get_key,
+                              pool_hash,
+                              pool_equal,
+                              p_dup);
+        return p_dup ? p_dup->id : INVALID_ID;
+    }
+
+    zda_ht_insert_check_inplace(&ht_,
+                                key,
+                                StringPoolEntry,
+                                pool_get_key,
+                                pool_hash,
+                                pool_equal,
+                                commit_ctx,
+                                p_dup);
+    if (p_dup) return p_dup->id;
+
+    if (entries_.size() >= INVALID_ID) throw std::length_error("StringPool: id exhausted");
+
+    char *data = bytes_.allocate(key.len + 1);
+    if (key.len) memcpy(data, key.data, key.len);
+    data[key.len] = 0;
+    key.data      = data;
+
+    auto *entry = (StringPoolEntry *)nodes_.allocate(sizeof(StringPoolEntry),
+                                                     alignof(StringPoolEntry));
+    entry->key  = key;
+    entry->id   = (Id)entries_.size();
+    entries_.push_back(entry);
+
+    zda_ht_insert_commit_inplace(&ht_, commit_ctx, &entry->node);
+    return entry->id;
+}
+
+StringPool::Id StringPool::find(StringView str) const zda_noexcept
+{
+    StringPoolKey const key = pool_make_key(str);
+    StringPoolEntry *result;
+
+    zda_ht_search_inplace((zda_ht_t *)&ht_,
+                          key,
+                          StringPoolEntry,
+                          pool_get_key,
+                          pool_hash,
+                          pool_equal,
+                          result);
+    return result ? result->id : INVALID_ID;
+}
+
+void StringPool::freeze()
+{
+    entries_.shrink_to_fit();
+    frozen_ = true;
+}
+
+size_t StringPool::memory_usage() const zda_noexcept
+{
+    return bytes_.memory_usage() + nodes_.memory_usage() +
+           entries_.capacity() * sizeof(entries_[0]) + ht_.bkt_capa * sizeof(zda_ht_list_t);
+}
@@ -1,89 +1,579 @@
 #include "zda/string_util.hpp"
 #include "zda/string_view.hpp"
+#include "zda/string_view_util.h"
 
+#include <cfloat>
+#include <cmath>
 #include <cstdarg>
+#include <cstdint>
 #include <cstring>
 
 using namespace zda;
 
+/********************************/
+/* Integer formatting */
+/********************************/
+static char const kDigitPairs[201] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+static uint64_t const kPow10[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+/*
+ * floor(log10(v)) + 1 by the bit length, no division.
+ * v | 1 has the same count since 10^k - 1 is odd, and make 0 be 1 digit.
+ */
+static zda_inline unsigned count_digits(uint64_t v) zda_noexcept
+{
+    v |= 1;
+    unsigned const t = ((64 - __builtin_clzll(v)) * 1233) >> 12;
+    return t + (v >= kPow10[t]);
+}
+
+/* Write the \p len digits of \p v to buf[0, len) backward, two digits a step */
+static zda_inline void write_digits(char *buf, uint64_t v, unsigned len) zda_noexcept
+{
+    char *p = buf + len;
+
+    while (v >= 100) {
+        unsigned const i = (unsigned)(v % 100) * 2;
+        v /= 100;
+        p -= 2;
+        memcpy(p, kDigitPairs + i, 2);
+    }
+
+    if (v >= 10) {
+        p -= 2;
+        memcpy(p, kDigitPairs + v * 2, 2);
+    } else {
+        *--p = (char)('0' + v);
+    }
+}
+
+size_t zda::u64_to_chars(char *buf, uint64_t v) zda_noexcept
+{
+    unsigned const len = count_digits(v);
+    write_digits(buf, v, len);
+    return len;
+}
+
+size_t zda::s64_to_chars(char *buf, int64_t v) zda_noexcept
+{
+    if (v < 0) {
+        *buf = '-';
+        return 1 + u64_to_chars(buf + 1, 0 - (uint64_t)v);
+    }
+    return u64_to_chars(buf, (uint64_t)v);
+}
+
+size_t zda::u64_to_hex_chars(char *buf, uint64_t v, bool upper) zda_noexcept
+{
+    char const *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    size_t const len = (67 - __builtin_clzll(v | 1)) >> 2;
+
+    for (size_t i = len; i > 0; --i) {
+        buf[i - 1] = digits[v & 0xf];
+        v >>= 4;
+    }
+    return len;
+}
+
+/********************************/
+/* Floating-point formatting */
+/********************************/
+#include "string_util_schubfach.inc"
+
+namespace {
+
+/* value = digits * 10^exp */
+struct Decimal {
+    uint64_t digits;
+    int exp;
+};
+
+typedef unsigned __int128 u128;
+
+constexpr int kQMin = -1074;
+constexpr uint64_t kCMin = uint64_t(1) << 52;
+constexpr uint64_t kCTiny = 3;
+constexpr uint64_t kMask63 = (uint64_t(1) << 63) - 1;
+
+zda_inline uint64_t mul_high(uint64_t x, uint64_t y) zda_noexcept
+{
+    return (uint64_t)(((u128)x * y) >> 64);
+}
+
+/* floor(q * log10(2)) */
+zda_inline int flog10pow2(int q) zda_noexcept
+{
+    return (int)(((int64_t)q * 661971961083LL) >> 41);
+}
+
+/* floor(log10(3/4 * 2^q)) */
+zda_inline int flog10_three_quarters_pow2(int q) zda_noexcept
+{
+    return (int)(((int64_t)q * 661971961083LL - 274743187321LL) >> 41);
+}
+
+/* floor(e * log2(10)) */
+zda_inline int flog2pow10(int e) zda_noexcept
+{
+    return (int)(((int64_t)e * 913124641741LL) >> 38);
+}
+
+/* Round to odd of g * cp / 2^127 */
+zda_inline uint64_t rop(uint64_t g1, uint64_t g0, uint64_t cp) zda_noexcept
+{
+    uint64_t const x1 = mul_high(g0, cp);
+    uint64_t const y0 = g1 * cp;
+    uint64_t const y1 = mul_high(g1, cp);
+    uint64_t const z = (y0 >> 1) + x1;
+    uint64_t const vbp = y1 + (z >> 63);
+    return vbp | (((z & kMask63) + kMask63) >> 63);
+}
+
+/*
+ * Schubfach(Raffaello Giulietti):
+ * The rounding interval of c * 2^q is scaled by 10^(-k) such that it
+ * contains at most one multiple of 10 or it's determined by the closest one,
+ * therefore the shortest decimal in the interval is found without iteration.
+ * See "The Schubfach way to render doubles".
+ */
+Decimal to_decimal(int q, uint64_t c, int dk) zda_noexcept
+{
+    uint64_t const out = c & 1;
+    uint64_t const cb = c << 2;
+    uint64_t const cbr = cb + 2;
+    uint64_t cbl;
+    int k;
+
+    if (c != kCMin || q == kQMin) {
+        cbl = cb - 2;
+        k = flog10pow2(q);
+    } else {
+        /* The lower neighbor is closer at the power of 2 */
+        cbl = cb - 1;
+        k = flog10_three_quarters_pow2(q);
+    }
+
+    int const h = q + flog2pow10(-k) + 2;
+    uint64_t const *g = &_zda_schubfach_g[2 * (k - _ZDA_G_K_MIN)];
+    uint64_t const vb = rop(g[0], g[1], cb << h);
+    uint64_t const vbl = rop(g[0], g[1], cbl << h);
+    uint64_t const vbr = rop(g[0], g[1], cbr << h);
+    uint64_t const s = vb >> 2;
+
+    if (s >= 100) {
+        /* s / 10 * 10 */
+        uint64_t const sp10 = 10 * mul_high(s, 115292150460684698ULL << 4);
+        uint64_t const tp10 = sp10 + 10;
+        bool const upin = vbl + out <= sp10 << 2;
+        bool const wpin = (tp10 << 2) + out <= vbr;
+        if (upin != wpin) return {upin ? sp10 : tp10, k};
+    }
+
+    uint64_t const t = s + 1;
+    bool const uin = vbl + out <= s << 2;
+    bool const win = (t << 2) + out <= vbr;
+    if (uin != win) return {uin ? s : t, k + dk};
+
+    /* Both are in the interval, pick the closest, even if tie */
+    int64_t const cmp = (int64_t)(vb - ((s + t) << 1));
+    return {(cmp < 0 || (cmp == 0 && (s & 1) == 0)) ? s : t, k + dk};
+}
+
+/* The \p v must be finite and non-zero */
+Decimal double_to_decimal(double v) zda_noexcept
+{
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof bits);
+
+    uint64_t const t = bits & (kCMin - 1);
+    int const bq = (int)(bits >> 52) & 0x7FF;
+
+    if (bq != 0) {
+        int const mq = -kQMin + 1 - bq;
+        uint64_t const c = kCMin | t;
+        /* Integer value */
+        if (0 < mq && mq < 53) {
+            uint64_t const f = c >> mq;
+            if (f << mq == c) return {f, 0};
+        }
+        return to_decimal(-mq, c, 0);
+    }
+
+    /* Subnormal */
+    return t < kCTiny ? to_decimal(kQMin, 10 * t, -1) : to_decimal(kQMin, t, 0);
+}
+
+/* Return the length of the special value, 0 if \p v is finite and non-zero */
+size_t special_to_chars(char *buf, double v) zda_noexcept
+{
+    char *p = buf;
+
+    if (std::signbit(v)) *p++ = '-';
+    if (std::isnan(v)) {
+        /* The sign of nan is not meaningful */
+        memcpy(buf, "nan", 3);
+        return 3;
+    }
+    if (std::isinf(v)) {
+        memcpy(p, "inf", 3);
+        return p - buf + 3;
+    }
+    if (v == 0) {
+        *p = '0';
+        return p - buf + 1;
+    }
+    return 0;
+}
+
+/* Remove the trailing zeros of the digits */
+zda_inline void normalize(Decimal &dec) zda_noexcept
+{
+    while (dec.digits % 10 == 0) {
+        dec.digits /= 10;
+        ++dec.exp;
+    }
+}
+
+/* Write digits * 10^exp in scientific notation as the printf("%e") */
+size_t write_scientific(char *buf, Decimal dec) zda_noexcept;
+
+zda_inline bool round_trips(Decimal dec, double v) zda_noexcept
+{
+    char buf[ZDA_DOUBLE_CHARS_MAX];
+    zda_string_view_t sv;
+    double parsed;
+
+    zda_string_view_init(&sv, buf, write_scientific(buf, dec));
+    return zda_string_view_to_double(sv, &parsed) &&
+           memcmp(&parsed, &v, sizeof v) == 0;
+}
+
+/*
+ * The precision of the small subnormal is so low that the rounding interval
+ * may contain the decimals shorter than the result of Schubfach, which finds
+ * the closest one with 2 digits at least in this case(e.g. 4.9e-324 instead
+ * of 5e-324). Try to drop the digits and check if it still round-trips.
+ * \p v must be positive.
+ */
+Decimal shorten_subnormal(Decimal dec, double v) zda_noexcept
+{
+    while (dec.digits >= 10) {
+        uint64_t const lo = dec.digits / 10;
+        uint64_t const hi = lo + 1;
+        bool const lo_first = dec.digits % 10 <= 5;
+        Decimal const first = {lo_first ? lo : hi, dec.exp + 1};
+        Decimal const second = {lo_first ? hi : lo, dec.exp + 1};
+
+        if (first.digits && round_trips(first, v))
+            dec = first;
+        else if (second.digits && round_trips(second, v))
+            dec = second;
+        else
+            break;
+        normalize(dec);
+    }
+    return dec;
+}
+
+/* The \p v must be finite and non-zero */
+Decimal shortest_decimal(double v) zda_noexcept
+{
+    Decimal dec = double_to_decimal(v);
+    normalize(dec);
+    if (std::fabs(v) < DBL_MIN) dec = shorten_subnormal(dec, std::fabs(v));
+    return dec;
+}
+
+/* Write digits * 10^exp in fixed notation */
+size_t write_fixed(char *buf, Decimal dec) zda_noexcept
+{
+    unsigned const len = count_digits(dec.digits);
+    int const point = (int)len + dec.exp; /* Digits before the point */
+    char *p = buf;
+
+    if (dec.exp >= 0) {
+        write_digits(p, dec.digits, len);
+        p += len;
+        memset(p, '0', dec.exp);
+        return p - buf + dec.exp;
+    }
+
+    if (point > 0) {
+        /* Write the digits and move the integer part forward to insert the point */
+        write_digits(p + 1, dec.digits, len);
+        memmove(p, p + 1, point);
+        p[point] = '.';
+        return len + 1;
+    }
+
+    *p++ = '0';
+    *p++ = '.';
+    memset(p, '0', -point);
+    p += -point;
+    write_digits(p, dec.digits, len);
+    return p - buf + len;
+}
+
+size_t write_scientific(char *buf, Decimal dec) zda_noexcept
+{
+    unsigned const len = count_digits(dec.digits);
+    int sci_exp = dec.exp + (int)len - 1;
+    char *p = buf;
+
+    write_digits(p + 1, dec.digits, len);
+    p[0] = p[1];
+    if (len > 1) {
+        p[1] = '.';
+        p += len + 1;
+    } else {
+        p += 1;
+    }
+
+    *p++ = 'e';
+    if (sci_exp < 0) {
+        *p++ = '-';
+        sci_exp = -sci_exp;
+    } else {
+        *p++ = '+';
+    }
+
+    if (sci_exp >= 100) {
+        *p++ = (char)('0' + sci_exp / 100);
+        sci_exp %= 100;
+    }
+    memcpy(p, kDigitPairs + sci_exp * 2, 2);
+    return p - buf + 2;
+}
+
+} // namespace
+
+size_t zda::double_to_chars(char *buf, double v) zda_noexcept
+{
+    size_t const special_len = special_to_chars(buf, v);
+    if (special_len) return special_len;
+
+    size_t const sign = std::signbit(v);
+    Decimal const dec = shortest_decimal(v);
+    buf[0] = '-';
+
+    /* Same as the printf("%.17g") */
+    int const sci_exp = dec.exp + (int)count_digits(dec.digits) - 1;
+    if (sci_exp < -4 || sci_exp >= 17) return sign + write_scientific(buf + sign, dec);
+    return sign + write_fixed(buf + sign, dec);
+}
+
+size_t zda::double_to_fixed_chars(char *buf, double v) zda_noexcept
+{
+    size_t const special_len = special_to_chars(buf, v);
+    if (special_len) return special_len;
+
+    size_t const sign = std::signbit(v);
+    Decimal const dec = shortest_decimal(v);
+    buf[0] = '-';
+    return sign + write_fixed(buf + sign, dec);
+}
+
+void zda::str_append_int(std::string *p_str, int64_t v)
+{
+    char buf[ZDA_INT_CHARS_MAX];
+    p_str->append(buf, s64_to_chars(buf, v));
+}
+
+void zda::str_append_uint(std::string *p_str, uint64_t v)
+{
+    char buf[ZDA_INT_CHARS_MAX];
+    p_str->append(buf, u64_to_chars(buf, v));
+}
+
+void zda::str_append_double(std::string *p_str, double v)
+{
+    char buf[ZDA_DOUBLE_CHARS_MAX];
+    p_str->append(buf, double_to_chars(buf, v));
+}
+
+/********************************/
+/* Format APIs */
+/********************************/
+namespace {
+
+/*
+ * Write to the buffer as much as possible,
+ * but always count the full size.
+ */
+struct BufWriter {
+    char *buf;
+    size_t n;
+    size_t ret;
+
+    void write(char const *s, size_t len) zda_noexcept
+    {
+        if (buf && ret + 1 < n) {
+            size_t const room = n - 1 - ret;
+            memcpy(buf + ret, s, len < room ? len : room);
+        }
+        ret += len;
+    }
+
+    void put(char c) zda_noexcept { write(&c, 1); }
+};
+
+enum LengthModifier {
+    LM_NONE,
+    LM_LONG,
+    LM_LONG_LONG,
+    LM_SIZE,
+};
+
+zda_inline uint64_t va_arg_unsigned(va_list *ap, LengthModifier lm)
+{
+    switch (lm) {
+        case LM_LONG:
+            return va_arg(*ap, unsigned long);
+        case LM_LONG_LONG:
+            return va_arg(*ap, unsigned long long);
+        case LM_SIZE:
+            return va_arg(*ap, size_t);
+        default:
+            return va_arg(*ap, unsigned);
+    }
+}
+
+zda_inline int64_t va_arg_signed(va_list *ap, LengthModifier lm)
+{
+    switch (lm) {
+        case LM_LONG:
+            return va_arg(*ap, long);
+        case LM_LONG_LONG:
+            return va_arg(*ap, long long);
+        case LM_SIZE:
+            return (int64_t)va_arg(*ap, size_t);
+        default:
+            return va_arg(*ap, int);
+    }
+}
+
+} // namespace
+
 size_t zda::vbuf_catf(char *buf, size_t n, char const *fmt,
                       va_list slist) zda_noexcept
 {
-    char const *p_c = fmt;
-    bool present_occur = false;
-    size_t ret = 0;
-
-    for (; *p_c; ++p_c) {
-        if (present_occur) {
-            switch (*p_c) {
-                case '%':
-                    ++ret;
-                    if (buf && ret < n) {
-                        *buf = '%';
-                        ++buf;
-                    }
-                    break;
-                case 'c': {
-                    ++ret;
-                    const char c = (char)va_arg(slist, int);
-                    if (buf && ret < n) {
-                        *buf = c;
-                        ++buf;
-                    }
-                } break;
-                case 's': {
-                    char const *s = va_arg(slist, char const *);
-                    /*
-                                        const auto len = strlen(s);
-                                        ret += len;
-                                        if (p_str && ret < n) {
-                                            memcpy(p_str, s, len);
-                                            p_str += len;
-                                        }
-                    */
-                    for (;; ++s) {
-                        if (*s) {
-                            if (++ret < n) {
-                                if (buf) *buf++ = *s;
-                            }
-                        } else
-                            break;
-                    }
-                } break;
-                case 'v': {
-                    auto s = va_arg(slist, zda::StringView);
-                    ret += s.size();
-                    if (buf && ret < n) {
-                        memcpy(buf, s.data(), s.size());
-                        buf += s.size();
-                    }
-                } break;
-                case 'S': {
-                    std::string const *p_s = va_arg(slist, std::string const *);
-                    ret += p_s->size();
-                    if (buf && ret < n) {
-                        memcpy(buf, p_s->data(), p_s->size());
-                        buf += p_s->size();
-                    }
-                } break;
-                default:
-                    return -1;
-            }
-            present_occur = false;
-        } else {
-            if (*p_c == '%') {
-                present_occur = true;
-            } else {
-                ++ret;
-                if (buf && ret < n) {
-                    *buf++ = *p_c;
-                }
+    BufWriter writer{buf, n, 0};
+    char num_buf[ZDA_DOUBLE_FIXED_CHARS_MAX];
+    LengthModifier lm;
+    va_list ap;
+
+    /* The va_list parameter may be an array type decayed to pointer,
+     * copy it so that it can be passed by pointer to the helpers */
+    va_copy(ap, slist);
+
+    for (char const *p_c = fmt; *p_c; ++p_c) {
+        if (*p_c != '%') {
+            /* Write the plain text until next specifier once */
+            char const *next = strchr(p_c, '%');
+            size_t const len = next ? next - p_c : strlen(p_c);
+            writer.write(p_c, len);
+            p_c += len - 1;
+            continue;
+        }
+
+        ++p_c;
+        lm = LM_NONE;
+        if (*p_c == 'l') {
+            ++p_c;
+            lm = LM_LONG;
+            if (*p_c == 'l') {
+                ++p_c;
+                lm = LM_LONG_LONG;
             }
+        } else if (*p_c == 'z') {
+            ++p_c;
+            lm = LM_SIZE;
+        }
+
+        switch (*p_c) {
+            case '%':
+                writer.put('%');
+                break;
+            case 'c':
+                writer.put((char)va_arg(ap, int));
+                break;
+            case 's': {
+                char const *s = va_arg(ap, char const *);
+                writer.write(s, strlen(s));
+            } break;
+            case 'v': {
+                auto s = va_arg(ap, zda::StringView);
+                writer.write(s.data(), s.size());
+            } break;
+            case 'S': {
+                std::string const *p_s = va_arg(ap, std::string const *);
+                writer.write(p_s->data(), p_s->size());
+            } break;
+            case 'd':
+            case 'i':
+                writer.write(num_buf,
+                             s64_to_chars(num_buf, va_arg_signed(&ap, lm)));
+                break;
+            case 'u':
+                writer.write(num_buf,
+                             u64_to_chars(num_buf, va_arg_unsigned(&ap, lm)));
+                break;
+            case 'x':
+            case 'X':
+                writer.write(num_buf,
+                             u64_to_hex_chars(num_buf,
+                                              va_arg_unsigned(&ap, lm),
+                                              *p_c == 'X'));
+                break;
+            case 'f':
+                writer.write(
+                    num_buf,
+                    double_to_fixed_chars(num_buf, va_arg(ap, double)));
+                break;
+            case 'g':
+                writer.write(num_buf,
+                             double_to_chars(num_buf, va_arg(ap, double)));
+                break;
+            default:
+                va_end(ap);
+                return -1;
         }
     }
 
-    if (buf) *buf = 0;
-    return ret;
+    va_end(ap);
+    if (buf && n > 0) buf[writer.ret < n ? writer.ret : n - 1] = 0;
+    return writer.ret;
 }
 
 size_t zda::buf_catf(char *buf, size_t n, const char *fmt, ...) noexcept
@@ -103,7 +593,7 @@ size_t zda::vstr_appendf(std::string *p_str, char const *fmt,
     const auto request_len = vbuf_catf(nullptr, 0, fmt, slist2);
     va_end(slist2);
 
-    if (request_len == -1) return -1;
+    if (request_len == (size_t)-1) return -1;
 
     const auto old_size = p_str->size();
     p_str->resize(request_len + old_size);
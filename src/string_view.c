@@ -0,0 +1,1092 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#include "zda/string_view.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  if defined(__GNUC__) && defined(__SSE2__)
+#    define _ZDA_STRING_VIEW_X86 1
+#    include <immintrin.h>
+#  endif
+#endif
+
+/* Needles longer than this use the Two-Way algorithm in forward search */
+#define _ZDA_STRING_VIEW_TWO_WAY_THRESHOLD 64
+
+typedef size_t (*_zda_string_view_search_fn)(
+    char const *hs,
+    size_t      n,
+    char const *ne,
+    size_t      m
+);
+
+/*
+ * All search kernels below have the same precondition:
+ * 2 <= m <= n.
+ * The single character and empty needle are handled by the callers.
+ */
+
+/***************************/
+/* Scalar kernels */
+/***************************/
+static size_t _zda_string_view_find_scalar(char const *hs, size_t n, char const *ne, size_t m)
+{
+    char const *first = hs;
+    char const *last  = hs + n - m + 1;
+    char const *pos;
+
+    while (first < last) {
+        pos = (char const *)memchr(first, ne[0], last - first);
+        if (!pos) break;
+        if (pos[m - 1] == ne[m - 1] && memcmp(pos + 1, ne + 1, m - 2) == 0) return pos - hs;
+        first = pos + 1;
+    }
+    return ZDA_STRING_VIEW_NPOS;
+}
+
+/* Search candidates in [0, end) backward */
+static size_t _zda_string_view_rfind_scalar_tail(
+    char const *hs,
+    size_t      end,
+    char const *ne,
+    size_t      m
+)
+{
+    while (end > 0) {
+        --end;
+        if (hs[end] == ne[0] && hs[end + m - 1] == ne[m - 1] &&
+            memcmp(hs + end + 1, ne + 1, m - 2) == 0)
+        {
+            return end;
+        }
+    }
+    return ZDA_STRING_VIEW_NPOS;
+}
+
+#ifndef _ZDA_STRING_VIEW_X86
+static size_t _zda_string_view_rfind_scalar(char const *hs, size_t n, char const *ne, size_t m)
+{
+    return _zda_string_view_rfind_scalar_tail(hs, n - m + 1, ne, m);
+}
+#endif
+
+/*
+ * Two-Way string matching(Crochemore and Perrin).
+ * The needle is factorized to u and v by the critical position,
+ * then match v from left to right and u from right to left.
+ * The shift table of the last character is used to skip quickly
+ * like the Boyer-Moore-Horspool.
+ *
+ * Time: O(n + m), Space: O(1)(the tables are fixed size).
+ */
+#define _ZDA_BITOP(a, b, op)                                                                       \
+    ((a)[(size_t)(b) / (8 * sizeof *(a))] op((size_t)1 << ((size_t)(b) % (8 * sizeof *(a)))))
+
+static size_t _zda_string_view_find_two_way(char const *hs, size_t n, char const *nee, size_t m)
+{
+    unsigned char const *h  = (unsigned char const *)hs;
+    unsigned char const *ne = (unsigned char const *)nee;
+    size_t               byteset[32 / sizeof(size_t)] = {0};
+    size_t               shift[256];
+    size_t               i, ip, jp, k, p, ms, p0, mem, mem0;
+    size_t               pos;
+
+    for (i = 0; i < m; ++i) {
+        _ZDA_BITOP(byteset, ne[i], |=);
+        shift[ne[i]] = i + 1;
+    }
+
+    /* Compute maximal suffix */
+    ip = (size_t)-1;
+    jp = 0;
+    k = p = 1;
+    while (jp + k < m) {
+        if (ne[ip + k] == ne[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else
+                ++k;
+        } else if (ne[ip + k] > ne[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    ms = ip;
+    p0 = p;
+
+    /* And with the opposite comparison */
+    ip = (size_t)-1;
+    jp = 0;
+    k = p = 1;
+    while (jp + k < m) {
+        if (ne[ip + k] == ne[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else
+                ++k;
+        } else if (ne[ip + k] < ne[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    if (ip + 1 > ms + 1)
+        ms = ip;
+    else
+        p = p0;
+
+    /* Periodic needle? */
+    if (memcmp(ne, ne + p, ms + 1)) {
+        mem0 = 0;
+        p    = zda_max(ms, m - ms - 1) + 1;
+    } else
+        mem0 = m - p;
+    mem = 0;
+
+    for (pos = 0; n - pos >= m;) {
+        /* Check last byte first, advance by shift on mismatch */
+        if (_ZDA_BITOP(byteset, h[pos + m - 1], &)) {
+            k = m - shift[h[pos + m - 1]];
+            if (k) {
+                if (k < mem) k = mem;
+                pos += k;
+                mem = 0;
+                continue;
+            }
+        } else {
+            pos += m;
+            mem = 0;
+            continue;
+        }
+
+        /* Compare right half */
+        for (k = zda_max(ms + 1, mem); k < m && ne[k] == h[pos + k]; ++k)
+            ;
+        if (k < m) {
+            pos += k - ms;
+            mem = 0;
+            continue;
+        }
+
+        /* Compare left half */
+        for (k = ms + 1; k > mem && ne[k - 1] == h[pos + k - 1]; --k)
+            ;
+        if (k <= mem) return pos;
+        pos += p;
+        mem = mem0;
+    }
+
+    return ZDA_STRING_VIEW_NPOS;
+}
+
+/***************************/
+/* SIMD kernels */
+/***************************/
+/*
+ * The first and last characters of the needle are broadcasted to vectors,
+ * then compare with the two blocks: hs[i, i+W) and hs[i+m-1, i+m-1+W).
+ * Only the positions matching both are candidates, and most of them are
+ * filtered out in a few instructions. The candidates are verified by memcmp.
+ */
+#ifdef _ZDA_STRING_VIEW_X86
+static size_t _zda_string_view_find_sse2(char const *hs, size_t n, char const *ne, size_t m)
+{
+    __m128i const first = _mm_set1_epi8(ne[0]);
+    __m128i const last  = _mm_set1_epi8(ne[m - 1]);
+    size_t        i     = 0;
+    __m128i       block_first, block_last;
+    unsigned      mask, bit;
+
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        block_first = _mm_loadu_si128((__m128i const *)(hs + i));
+        block_last  = _mm_loadu_si128((__m128i const *)(hs + i + m - 1));
+        mask        = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))
+        );
+        while (mask) {
+            bit = (unsigned)__builtin_ctz(mask);
+            if (memcmp(hs + i + bit + 1, ne + 1, m - 2) == 0) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    if (n - i < m) return ZDA_STRING_VIEW_NPOS;
+    {
+        size_t ret = _zda_string_view_find_scalar(hs + i, n - i, ne, m);
+        return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + i;
+    }
+}
+
+static size_t _zda_string_view_rfind_sse2(char const *hs, size_t n, char const *ne, size_t m)
+{
+    __m128i const first = _mm_set1_epi8(ne[0]);
+    __m128i const last  = _mm_set1_epi8(ne[m - 1]);
+    size_t        end   = n - m + 1; /* Candidates in [0, end) */
+    __m128i       block_first, block_last;
+    unsigned      mask, bit;
+
+    for (; end >= 16; end -= 16) {
+        block_first = _mm_loadu_si128((__m128i const *)(hs + end - 16));
+        block_last  = _mm_loadu_si128((__m128i const *)(hs + end - 16 + m - 1));
+        mask        = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))
+        );
+        while (mask) {
+            bit = 31 - (unsigned)__builtin_clz(mask);
+            if (memcmp(hs + end - 16 + bit + 1, ne + 1, m - 2) == 0) return end - 16 + bit;
+            mask &= ~(1u << bit);
+        }
+    }
+
+    return _zda_string_view_rfind_scalar_tail(hs, end, ne, m);
+}
+
+__attribute__((target("avx2"))) static size_t
+_zda_string_view_find_avx2(char const *hs, size_t n, char const *ne, size_t m)
+{
+    __m256i const first = _mm256_set1_epi8(ne[0]);
+    __m256i const last  = _mm256_set1_epi8(ne[m - 1]);
+    size_t        i     = 0;
+    __m256i       block_first, block_last;
+    unsigned      mask, bit;
+
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        block_first = _mm256_loadu_si256((__m256i const *)(hs + i));
+        block_last  = _mm256_loadu_si256((__m256i const *)(hs + i + m - 1));
+        mask        = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first),
+            _mm256_cmpeq_epi8(block_last, last)
+        ));
+        while (mask) {
+            bit = (unsigned)__builtin_ctz(mask);
+            if (memcmp(hs + i + bit + 1, ne + 1, m - 2) == 0) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    if (n - i < m) return ZDA_STRING_VIEW_NPOS;
+    {
+        size_t ret = _zda_string_view_find_sse2(hs + i, n - i, ne, m);
+        return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + i;
+    }
+}
+
+__attribute__((target("avx2"))) static size_t
+_zda_string_view_rfind_avx2(char const *hs, size_t n, char const *ne, size_t m)
+{
+    __m256i const first = _mm256_set1_epi8(ne[0]);
+    __m256i const last  = _mm256_set1_epi8(ne[m - 1]);
+    size_t        end   = n - m + 1;
+    __m256i       block_first, block_last;
+    unsigned      mask, bit;
+
+    for (; end >= 32; end -= 32) {
+        block_first = _mm256_loadu_si256((__m256i const *)(hs + end - 32));
+        block_last  = _mm256_loadu_si256((__m256i const *)(hs + end - 32 + m - 1));
+        mask        = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first),
+            _mm256_cmpeq_epi8(block_last, last)
+        ));
+        while (mask) {
+            bit = 31 - (unsigned)__builtin_clz(mask);
+            if (memcmp(hs + end - 32 + bit + 1, ne + 1, m - 2) == 0) return end - 32 + bit;
+            mask &= ~(1u << bit);
+        }
+    }
+
+    /* The remaining candidates are in [0, end), i.e. the haystack is hs[0, end+m-1) */
+    if (end == 0) return ZDA_STRING_VIEW_NPOS;
+    return _zda_string_view_rfind_sse2(hs, end + m - 1, ne, m);
+}
+#endif /* _ZDA_STRING_VIEW_X86 */
+
+/***************************/
+/* Runtime dispatch */
+/***************************/
+/*
+ * The kernel is resolved at the first call by the CPU features.
+ * The resolve is idempotent, so the race between threads is harmless,
+ * but the atomic builtins are used to make it well-defined.
+ */
+static size_t _zda_string_view_find_resolve(char const *, size_t, char const *, size_t);
+static size_t _zda_string_view_rfind_resolve(char const *, size_t, char const *, size_t);
+
+static _zda_string_view_search_fn _zda_string_view_find_impl  = _zda_string_view_find_resolve;
+static _zda_string_view_search_fn _zda_string_view_rfind_impl = _zda_string_view_rfind_resolve;
+
+#ifdef _ZDA_STRING_VIEW_X86
+static zda_bool _zda_string_view_has_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? zda_true : zda_false;
+}
+#endif
+
+static size_t _zda_string_view_find_resolve(char const *hs, size_t n, char const *ne, size_t m)
+{
+    _zda_string_view_search_fn fn;
+#ifdef _ZDA_STRING_VIEW_X86
+    fn = _zda_string_view_has_avx2() ? _zda_string_view_find_avx2 : _zda_string_view_find_sse2;
+#else
+    fn = _zda_string_view_find_scalar;
+#endif
+    __atomic_store_n(&_zda_string_view_find_impl, fn, __ATOMIC_RELAXED);
+    return fn(hs, n, ne, m);
+}
+
+static size_t _zda_string_view_rfind_resolve(char const *hs, size_t n, char const *ne, size_t m)
+{
+    _zda_string_view_search_fn fn;
+#ifdef _ZDA_STRING_VIEW_X86
+    fn = _zda_string_view_has_avx2() ? _zda_string_view_rfind_avx2 : _zda_string_view_rfind_sse2;
+#else
+    fn = _zda_string_view_rfind_scalar;
+#endif
+    __atomic_store_n(&_zda_string_view_rfind_impl, fn, __ATOMIC_RELAXED);
+    return fn(hs, n, ne, m);
+}
+
+/***************************/
+/* Public APIs */
+/***************************/
+size_t zda_string_view_find(zda_string_view_t const *view, zda_string_view_t str, size_t pos)
+    zda_noexcept
+{
+    size_t      n;
+    size_t      ret;
+    char const *p;
+
+    if (pos > view->len) return ZDA_STRING_VIEW_NPOS;
+    n = view->len - pos;
+    if (str.len > n) return ZDA_STRING_VIEW_NPOS;
+    if (str.len == 0) return pos;
+
+    if (str.len == 1) {
+        p = (char const *)memchr(view->data + pos, str.data[0], n);
+        return p ? (size_t)(p - view->data) : ZDA_STRING_VIEW_NPOS;
+    }
+
+    if (str.len > _ZDA_STRING_VIEW_TWO_WAY_THRESHOLD)
+        ret = _zda_string_view_find_two_way(view->data + pos, n, str.data, str.len);
+    else
+        ret = __atomic_load_n(&_zda_string_view_find_impl, __ATOMIC_RELAXED)(
+            view->data + pos,
+            n,
+            str.data,
+            str.len
+        );
+
+    return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + pos;
+}
+
+size_t zda_string_view_rfind(zda_string_view_t const *view, zda_string_view_t str, size_t pos)
+    zda_noexcept
+{
+    size_t n;
+
+    if (str.len > view->len) return ZDA_STRING_VIEW_NPOS;
+    if (pos > view->len - str.len) pos = view->len - str.len;
+    if (str.len == 0) return pos;
+
+    /* The match must start at or before pos */
+    n = pos + str.len;
+    if (str.len == 1) {
+        for (; n > 0; --n) {
+            if (view->data[n - 1] == str.data[0]) return n - 1;
+        }
+        return ZDA_STRING_VIEW_NPOS;
+    }
+
+    return __atomic_load_n(&_zda_string_view_rfind_impl, __ATOMIC_RELAXED)(
+        view->data,
+        n,
+        str.data,
+        str.len
+    );
+}
+
+/***************************/
+/* Char set scanning */
+/***************************/
+/*
+ * The kernels scan data[0, n) and return the index of the first(or last)
+ * character whose membership is equal to \p in, or NPOS if not found.
+ */
+typedef size_t (*_zda_string_view_scan_fn)(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+);
+
+static size_t _zda_string_view_scan_scalar(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (zda_char_set_contains(set, data[i]) == in) return i;
+    }
+    return ZDA_STRING_VIEW_NPOS;
+}
+
+static size_t _zda_string_view_rscan_scalar(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+)
+{
+    while (n > 0) {
+        --n;
+        if (zda_char_set_contains(set, data[n]) == in) return n;
+    }
+    return ZDA_STRING_VIEW_NPOS;
+}
+
+#ifdef _ZDA_STRING_VIEW_X86
+/* bit_tbl[h] = 1 << (h & 7) */
+#  define _ZDA_CHAR_SET_BIT_TBL                                                                    \
+      1, 2, 4, 8, 16, 32, 64, (char)128, 1, 2, 4, 8, 16, 32, 64, (char)128
+
+/* Return 0xff in the byte whose membership is true */
+__attribute__((target("ssse3"))) static zda_inline __m128i _zda_char_set_match_ssse3(
+    __m128i v,
+    __m128i lo_ascii,
+    __m128i lo_high,
+    __m128i bit_tbl
+)
+{
+    /* PSHUFB returns zero if the highest bit of the index is set,
+     * so the ASCII and non-ASCII rows are selected automatically */
+    __m128i const row = _mm_or_si128(
+        _mm_shuffle_epi8(lo_ascii, v),
+        _mm_shuffle_epi8(lo_high, _mm_xor_si128(v, _mm_set1_epi8((char)0x80)))
+    );
+    __m128i const hi  = _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f));
+    __m128i const bit = _mm_shuffle_epi8(bit_tbl, hi);
+    return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+}
+
+__attribute__((target("ssse3"))) static size_t _zda_string_view_scan_ssse3(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+)
+{
+    __m128i const  lo_ascii = _mm_loadu_si128((__m128i const *)set->lo_ascii);
+    __m128i const  lo_high  = _mm_loadu_si128((__m128i const *)set->lo_high);
+    __m128i const  bit_tbl  = _mm_setr_epi8(_ZDA_CHAR_SET_BIT_TBL);
+    unsigned const flip     = in ? 0 : 0xffff;
+    size_t         i        = 0;
+    unsigned       mask;
+    size_t         ret;
+
+    for (; i + 16 <= n; i += 16) {
+        mask = (unsigned)_mm_movemask_epi8(_zda_char_set_match_ssse3(
+                   _mm_loadu_si128((__m128i const *)(data + i)),
+                   lo_ascii,
+                   lo_high,
+                   bit_tbl
+               )) ^
+               flip;
+        if (mask) return i + (unsigned)__builtin_ctz(mask);
+    }
+
+    ret = _zda_string_view_scan_scalar(data + i, n - i, set, in);
+    return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + i;
+}
+
+__attribute__((target("ssse3"))) static size_t _zda_string_view_rscan_ssse3(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+)
+{
+    __m128i const  lo_ascii = _mm_loadu_si128((__m128i const *)set->lo_ascii);
+    __m128i const  lo_high  = _mm_loadu_si128((__m128i const *)set->lo_high);
+    __m128i const  bit_tbl  = _mm_setr_epi8(_ZDA_CHAR_SET_BIT_TBL);
+    unsigned const flip     = in ? 0 : 0xffff;
+    unsigned       mask;
+
+    for (; n >= 16; n -= 16) {
+        mask = (unsigned)_mm_movemask_epi8(_zda_char_set_match_ssse3(
+                   _mm_loadu_si128((__m128i const *)(data + n - 16)),
+                   lo_ascii,
+                   lo_high,
+                   bit_tbl
+               )) ^
+               flip;
+        if (mask) return n - 16 + 31 - (unsigned)__builtin_clz(mask);
+    }
+
+    return _zda_string_view_rscan_scalar(data, n, set, in);
+}
+
+__attribute__((target("avx2"))) static zda_inline __m256i _zda_char_set_match_avx2(
+    __m256i v,
+    __m256i lo_ascii,
+    __m256i lo_high,
+    __m256i bit_tbl
+)
+{
+    __m256i const row = _mm256_or_si256(
+        _mm256_shuffle_epi8(lo_ascii, v),
+        _mm256_shuffle_epi8(lo_high, _mm256_xor_si256(v, _mm256_set1_epi8((char)0x80)))
+    );
+    __m256i const hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+    __m256i const bit = _mm256_shuffle_epi8(bit_tbl, hi);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+}
+
+/* VPSHUFB shuffles in each 128-bit lane, so the tables are broadcasted to both lanes */
+__attribute__((target("avx2"))) static size_t _zda_string_view_scan_avx2(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+)
+{
+    __m256i const lo_ascii =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)set->lo_ascii));
+    __m256i const lo_high =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)set->lo_high));
+    __m256i const  bit_tbl = _mm256_setr_epi8(_ZDA_CHAR_SET_BIT_TBL, _ZDA_CHAR_SET_BIT_TBL);
+    unsigned const flip    = in ? 0 : 0xffffffffu;
+    size_t         i       = 0;
+    unsigned       mask;
+    size_t         ret;
+
+    for (; i + 32 <= n; i += 32) {
+        mask = (unsigned)_mm256_movemask_epi8(_zda_char_set_match_avx2(
+                   _mm256_loadu_si256((__m256i const *)(data + i)),
+                   lo_ascii,
+                   lo_high,
+                   bit_tbl
+               )) ^
+               flip;
+        if (mask) return i + (unsigned)__builtin_ctz(mask);
+    }
+
+    ret = _zda_string_view_scan_ssse3(data + i, n - i, set, in);
+    return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + i;
+}
+
+__attribute__((target("avx2"))) static size_t _zda_string_view_rscan_avx2(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+)
+{
+    __m256i const lo_ascii =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)set->lo_ascii));
+    __m256i const lo_high =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)set->lo_high));
+    __m256i const  bit_tbl = _mm256_setr_epi8(_ZDA_CHAR_SET_BIT_TBL, _ZDA_CHAR_SET_BIT_TBL);
+    unsigned const flip    = in ? 0 : 0xffffffffu;
+    unsigned       mask;
+
+    for (; n >= 32; n -= 32) {
+        mask = (unsigned)_mm256_movemask_epi8(_zda_char_set_match_avx2(
+                   _mm256_loadu_si256((__m256i const *)(data + n - 32)),
+                   lo_ascii,
+                   lo_high,
+                   bit_tbl
+               )) ^
+               flip;
+        if (mask) return n - 32 + 31 - (unsigned)__builtin_clz(mask);
+    }
+
+    return _zda_string_view_rscan_ssse3(data, n, set, in);
+}
+#endif /* _ZDA_STRING_VIEW_X86 */
+
+static size_t _zda_string_view_scan_resolve(char const *, size_t, zda_char_set_t const *, zda_bool);
+static size_t
+_zda_string_view_rscan_resolve(char const *, size_t, zda_char_set_t const *, zda_bool);
+
+static _zda_string_view_scan_fn _zda_string_view_scan_impl  = _zda_string_view_scan_resolve;
+static _zda_string_view_scan_fn _zda_string_view_rscan_impl = _zda_string_view_rscan_resolve;
+
+static size_t _zda_string_view_scan_resolve(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+)
+{
+    _zda_string_view_scan_fn fn = _zda_string_view_scan_scalar;
+#ifdef _ZDA_STRING_VIEW_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        fn = _zda_string_view_scan_avx2;
+    else if (__builtin_cpu_supports("ssse3"))
+        fn = _zda_string_view_scan_ssse3;
+#endif
+    __atomic_store_n(&_zda_string_view_scan_impl, fn, __ATOMIC_RELAXED);
+    return fn(data, n, set, in);
+}
+
+static size_t _zda_string_view_rscan_resolve(
+    char const           *data,
+    size_t                n,
+    zda_char_set_t const *set,
+    zda_bool              in
+)
+{
+    _zda_string_view_scan_fn fn = _zda_string_view_rscan_scalar;
+#ifdef _ZDA_STRING_VIEW_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        fn = _zda_string_view_rscan_avx2;
+    else if (__builtin_cpu_supports("ssse3"))
+        fn = _zda_string_view_rscan_ssse3;
+#endif
+    __atomic_store_n(&_zda_string_view_rscan_impl, fn, __ATOMIC_RELAXED);
+    return fn(data, n, set, in);
+}
+
+static zda_inline size_t _zda_string_view_scan(
+    zda_string_view_t const *view,
+    zda_char_set_t const    *set,
+    size_t                   pos,
+    zda_bool                 in
+)
+{
+    size_t ret;
+
+    if (pos >= view->len) return ZDA_STRING_VIEW_NPOS;
+    ret = __atomic_load_n(&_zda_string_view_scan_impl, __ATOMIC_RELAXED)(
+        view->data + pos,
+        view->len - pos,
+        set,
+        in
+    );
+    return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + pos;
+}
+
+static zda_inline size_t _zda_string_view_rscan(
+    zda_string_view_t const *view,
+    zda_char_set_t const    *set,
+    size_t                   pos,
+    zda_bool                 in
+)
+{
+    if (view->len == 0) return ZDA_STRING_VIEW_NPOS;
+    if (pos >= view->len) pos = view->len - 1;
+    return __atomic_load_n(&_zda_string_view_rscan_impl, __ATOMIC_RELAXED)(
+        view->data,
+        pos + 1,
+        set,
+        in
+    );
+}
+
+size_t zda_string_view_find_first_of_set(
+    zda_string_view_t const *view,
+    zda_char_set_t const    *set,
+    size_t                   pos
+) zda_noexcept
+{
+    return _zda_string_view_scan(view, set, pos, zda_true);
+}
+
+size_t zda_string_view_find_first_not_of_set(
+    zda_string_view_t const *view,
+    zda_char_set_t const    *set,
+    size_t                   pos
+) zda_noexcept
+{
+    return _zda_string_view_scan(view, set, pos, zda_false);
+}
+
+size_t zda_string_view_find_last_of_set(
+    zda_string_view_t const *view,
+    zda_char_set_t const    *set,
+    size_t                   pos
+) zda_noexcept
+{
+    return _zda_string_view_rscan(view, set, pos, zda_true);
+}
+
+size_t zda_string_view_find_last_not_of_set(
+    zda_string_view_t const *view,
+    zda_char_set_t const    *set,
+    size_t                   pos
+) zda_noexcept
+{
+    return _zda_string_view_rscan(view, set, pos, zda_false);
+}
+
+/***************************/
+/* ASCII case folding */
+/***************************/
+/*
+ * The letters in [first, first+26) are flipped by XOR 0x20, where first is
+ * 'A' for lowering and 'a' for uppering.
+ *
+ * The vectorized range check uses the signed comparison:
+ *   (int8_t)(c + 0x80 - first) < -0x80 + 26
+ * which is true iff c is in [first, first+26).
+ */
+typedef void (*_zda_ascii_convert_fn)(char *dst, char const *src, size_t n, char first);
+
+/* Return the difference of the first mismatched lowercase bytes, or 0 */
+typedef int (*_zda_ascii_case_cmp_fn)(char const *s1, char const *s2, size_t n);
+
+/* The precondition is same as the search kernels: 1 <= m <= n */
+typedef size_t (*_zda_ascii_case_find_fn)(char const *hs, size_t n, char const *ne, size_t m);
+
+static zda_inline unsigned char _zda_ascii_lower(char c)
+{
+    return (unsigned char)zda_ascii_to_lower(c);
+}
+
+static void _zda_ascii_convert_scalar(char *dst, char const *src, size_t n, char first)
+{
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char const c = (unsigned char)src[i];
+        dst[i] = (char)((unsigned char)(c - first) < 26 ? c ^ 0x20 : c);
+    }
+}
+
+static int _zda_ascii_case_cmp_scalar(char const *s1, char const *s2, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        int const c1 = _zda_ascii_lower(s1[i]);
+        int const c2 = _zda_ascii_lower(s2[i]);
+        if (c1 != c2) return c1 - c2;
+    }
+    return 0;
+}
+
+static size_t _zda_ascii_case_find_tail(char const *hs, size_t n, char const *ne, size_t m)
+{
+    unsigned char const first = _zda_ascii_lower(ne[0]);
+
+    for (size_t i = 0; i + m <= n; ++i) {
+        if (_zda_ascii_lower(hs[i]) == first &&
+            _zda_ascii_case_cmp_scalar(hs + i + 1, ne + 1, m - 1) == 0)
+            return i;
+    }
+    return ZDA_STRING_VIEW_NPOS;
+}
+
+#ifndef _ZDA_STRING_VIEW_X86
+static size_t _zda_ascii_case_find_scalar(char const *hs, size_t n, char const *ne, size_t m)
+{
+    return _zda_ascii_case_find_tail(hs, n, ne, m);
+}
+#endif
+
+#ifdef _ZDA_STRING_VIEW_X86
+static zda_inline __m128i _zda_ascii_flip_sse2(__m128i x, __m128i shift)
+{
+    __m128i const mask =
+        _mm_cmplt_epi8(_mm_add_epi8(x, shift), _mm_set1_epi8((char)(-0x80 + 26)));
+    return _mm_xor_si128(x, _mm_and_si128(mask, _mm_set1_epi8(0x20)));
+}
+
+static void _zda_ascii_convert_sse2(char *dst, char const *src, size_t n, char first)
+{
+    __m128i const shift = _mm_set1_epi8((char)(0x80 - first));
+    size_t        i     = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i const x = _mm_loadu_si128((__m128i const *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _zda_ascii_flip_sse2(x, shift));
+    }
+    _zda_ascii_convert_scalar(dst + i, src + i, n - i, first);
+}
+
+static int _zda_ascii_case_cmp_sse2(char const *s1, char const *s2, size_t n)
+{
+    __m128i const shift = _mm_set1_epi8((char)(0x80 - 'A'));
+    size_t        i     = 0;
+    unsigned      mask, bit;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i const x = _zda_ascii_flip_sse2(_mm_loadu_si128((__m128i const *)(s1 + i)), shift);
+        __m128i const y = _zda_ascii_flip_sse2(_mm_loadu_si128((__m128i const *)(s2 + i)), shift);
+        mask            = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xffff;
+        if (mask) {
+            bit = (unsigned)__builtin_ctz(mask);
+            return _zda_ascii_lower(s1[i + bit]) - _zda_ascii_lower(s2[i + bit]);
+        }
+    }
+    return _zda_ascii_case_cmp_scalar(s1 + i, s2 + i, n - i);
+}
+
+/* Same as the _zda_string_view_find_sse2() but the blocks are lowered */
+static size_t _zda_ascii_case_find_sse2(char const *hs, size_t n, char const *ne, size_t m)
+{
+    __m128i const shift = _mm_set1_epi8((char)(0x80 - 'A'));
+    __m128i const first = _mm_set1_epi8((char)_zda_ascii_lower(ne[0]));
+    __m128i const last  = _mm_set1_epi8((char)_zda_ascii_lower(ne[m - 1]));
+    size_t        i     = 0;
+    __m128i       block_first, block_last;
+    unsigned      mask, bit;
+
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        block_first = _zda_ascii_flip_sse2(_mm_loadu_si128((__m128i const *)(hs + i)), shift);
+        block_last  = _zda_ascii_flip_sse2(_mm_loadu_si128((__m128i const *)(hs + i + m - 1)), shift);
+        mask        = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))
+        );
+        while (mask) {
+            bit = (unsigned)__builtin_ctz(mask);
+            if (m <= 2 || _zda_ascii_case_cmp_sse2(hs + i + bit + 1, ne + 1, m - 2) == 0)
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    {
+        size_t ret = _zda_ascii_case_find_tail(hs + i, n - i, ne, m);
+        return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + i;
+    }
+}
+
+__attribute__((target("avx2"))) static zda_inline __m256i
+_zda_ascii_flip_avx2(__m256i x, __m256i shift)
+{
+    /* AVX2 has no cmplt_epi8, swap the operands of cmpgt */
+    __m256i const mask =
+        _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-0x80 + 26)), _mm256_add_epi8(x, shift));
+    return _mm256_xor_si256(x, _mm256_and_si256(mask, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2"))) static void
+_zda_ascii_convert_avx2(char *dst, char const *src, size_t n, char first)
+{
+    __m256i const shift = _mm256_set1_epi8((char)(0x80 - first));
+    size_t        i     = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i const x = _mm256_loadu_si256((__m256i const *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _zda_ascii_flip_avx2(x, shift));
+    }
+    _zda_ascii_convert_sse2(dst + i, src + i, n - i, first);
+}
+
+__attribute__((target("avx2"))) static int
+_zda_ascii_case_cmp_avx2(char const *s1, char const *s2, size_t n)
+{
+    __m256i const shift = _mm256_set1_epi8((char)(0x80 - 'A'));
+    size_t        i     = 0;
+    unsigned      mask, bit;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i const x =
+            _zda_ascii_flip_avx2(_mm256_loadu_si256((__m256i const *)(s1 + i)), shift);
+        __m256i const y =
+            _zda_ascii_flip_avx2(_mm256_loadu_si256((__m256i const *)(s2 + i)), shift);
+        mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+        if (mask) {
+            bit = (unsigned)__builtin_ctz(mask);
+            return _zda_ascii_lower(s1[i + bit]) - _zda_ascii_lower(s2[i + bit]);
+        }
+    }
+    return _zda_ascii_case_cmp_sse2(s1 + i, s2 + i, n - i);
+}
+
+__attribute__((target("avx2"))) static size_t
+_zda_ascii_case_find_avx2(char const *hs, size_t n, char const *ne, size_t m)
+{
+    __m256i const shift = _mm256_set1_epi8((char)(0x80 - 'A'));
+    __m256i const first = _mm256_set1_epi8((char)_zda_ascii_lower(ne[0]));
+    __m256i const last  = _mm256_set1_epi8((char)_zda_ascii_lower(ne[m - 1]));
+    size_t        i     = 0;
+    __m256i       block_first, block_last;
+    unsigned      mask, bit;
+
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        block_first =
+            _zda_ascii_flip_avx2(_mm256_loadu_si256((__m256i const *)(hs + i)), shift);
+        block_last =
+            _zda_ascii_flip_avx2(_mm256_loadu_si256((__m256i const *)(hs + i + m - 1)), shift);
+        mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first),
+            _mm256_cmpeq_epi8(block_last, last)
+        ));
+        while (mask) {
+            bit = (unsigned)__builtin_ctz(mask);
+            if (m <= 2 || _zda_ascii_case_cmp_avx2(hs + i + bit + 1, ne + 1, m - 2) == 0)
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    if (n - i < m) return ZDA_STRING_VIEW_NPOS;
+    {
+        size_t ret = _zda_ascii_case_find_sse2(hs + i, n - i, ne, m);
+        return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + i;
+    }
+}
+#endif /* _ZDA_STRING_VIEW_X86 */
+
+static void   _zda_ascii_convert_resolve(char *, char const *, size_t, char);
+static int    _zda_ascii_case_cmp_resolve(char const *, char const *, size_t);
+static size_t _zda_ascii_case_find_resolve(char const *, size_t, char const *, size_t);
+
+static _zda_ascii_convert_fn   _zda_ascii_convert_impl   = _zda_ascii_convert_resolve;
+static _zda_ascii_case_cmp_fn  _zda_ascii_case_cmp_impl  = _zda_ascii_case_cmp_resolve;
+static _zda_ascii_case_find_fn _zda_ascii_case_find_impl = _zda_ascii_case_find_resolve;
+
+static void _zda_ascii_convert_resolve(char *dst, char const *src, size_t n, char first)
+{
+    _zda_ascii_convert_fn fn;
+#ifdef _ZDA_STRING_VIEW_X86
+    fn = _zda_string_view_has_avx2() ? _zda_ascii_convert_avx2 : _zda_ascii_convert_sse2;
+#else
+    fn = _zda_ascii_convert_scalar;
+#endif
+    __atomic_store_n(&_zda_ascii_convert_impl, fn, __ATOMIC_RELAXED);
+    fn(dst, src, n, first);
+}
+
+static int _zda_ascii_case_cmp_resolve(char const *s1, char const *s2, size_t n)
+{
+    _zda_ascii_case_cmp_fn fn;
+#ifdef _ZDA_STRING_VIEW_X86
+    fn = _zda_string_view_has_avx2() ? _zda_ascii_case_cmp_avx2 : _zda_ascii_case_cmp_sse2;
+#else
+    fn = _zda_ascii_case_cmp_scalar;
+#endif
+    __atomic_store_n(&_zda_ascii_case_cmp_impl, fn, __ATOMIC_RELAXED);
+    return fn(s1, s2, n);
+}
+
+static size_t _zda_ascii_case_find_resolve(char const *hs, size_t n, char const *ne, size_t m)
+{
+    _zda_ascii_case_find_fn fn;
+#ifdef _ZDA_STRING_VIEW_X86
+    fn = _zda_string_view_has_avx2() ? _zda_ascii_case_find_avx2 : _zda_ascii_case_find_sse2;
+#else
+    fn = _zda_ascii_case_find_scalar;
+#endif
+    __atomic_store_n(&_zda_ascii_case_find_impl, fn, __ATOMIC_RELAXED);
+    return fn(hs, n, ne, m);
+}
+
+int zda_string_view_case_compare(zda_string_view_t const *view, zda_string_view_t str)
+    zda_noexcept
+{
+    int const r = __atomic_load_n(&_zda_ascii_case_cmp_impl, __ATOMIC_RELAXED)(
+        view->data,
+        str.data,
+        zda_min(view->len, str.len)
+    );
+
+    if (r != 0) return r;
+    if (view->len < str.len) return -1;
+    return view->len > str.len ? 1 : 0;
+}
+
+zda_bool zda_string_view_case_equal(zda_string_view_t const *view, zda_string_view_t str)
+    zda_noexcept
+{
+    return view->len == str.len &&
+           __atomic_load_n(&_zda_ascii_case_cmp_impl, __ATOMIC_RELAXED)(
+               view->data,
+               str.data,
+               str.len
+           ) == 0;
+}
+
+size_t zda_string_view_case_find(zda_string_view_t const *view, zda_string_view_t str, size_t pos)
+    zda_noexcept
+{
+    size_t n;
+    size_t ret;
+
+    if (pos > view->len) return ZDA_STRING_VIEW_NPOS;
+    n = view->len - pos;
+    if (str.len > n) return ZDA_STRING_VIEW_NPOS;
+    if (str.len == 0) return pos;
+
+    ret = __atomic_load_n(&_zda_ascii_case_find_impl, __ATOMIC_RELAXED)(
+        view->data + pos,
+        n,
+        str.data,
+        str.len
+    );
+    return ret == ZDA_STRING_VIEW_NPOS ? ret : ret + pos;
+}
+
+void zda_string_view_to_upper_string(zda_string_view_t const *view, char *buf, size_t n)
+    zda_noexcept
+{
+    assert(n >= view->len);
+    (void)n;
+    __atomic_load_n(&_zda_ascii_convert_impl, __ATOMIC_RELAXED)(buf, view->data, view->len, 'a');
+}
+
+void zda_string_view_to_lower_string(zda_string_view_t const *view, char *buf, size_t n)
+    zda_noexcept
+{
+    assert(n >= view->len);
+    (void)n;
+    __atomic_load_n(&_zda_ascii_convert_impl, __ATOMIC_RELAXED)(buf, view->data, view->len, 'A');
+}
+
+/*
+ * The 8 bytes are lowered at once by SWAR:
+ * The high bit of each byte is cleared to avoid the carry between bytes,
+ * then the high bit of (b + 0x80 - 'A') is set iff b >= 'A', and the high bit
+ * of (b + 0x7f - 'Z') is set iff b > 'Z'. The non-ASCII bytes are excluded.
+ */
+static zda_inline uint64_t _zda_ascii_lower_swar(uint64_t x)
+{
+    uint64_t const ones    = 0x0101010101010101ULL;
+    uint64_t const heptets = x & (0x7f * ones);
+    uint64_t const ge_a    = heptets + (0x80 - 'A') * ones;
+    uint64_t const gt_z    = heptets + (0x7f - 'Z') * ones;
+    uint64_t const upper   = (ge_a ^ gt_z) & ~x & (0x80 * ones);
+
+    return x | (upper >> 2);
+}
+
+static zda_inline uint64_t _zda_case_hash_mix(uint64_t a, uint64_t b)
+{
+    unsigned __int128 const r = (unsigned __int128)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+uint64_t zda_string_view_case_hash(zda_string_view_t const *view) zda_noexcept
+{
+    uint64_t const k0 = 0xa0761d6478bd642fULL;
+    uint64_t const k1 = 0xe7037ed1a0b428dbULL;
+    char const    *p  = view->data;
+    size_t         n  = view->len;
+    uint64_t       h  = k0 ^ (uint64_t)n;
+    uint64_t       w;
+
+    for (; n >= 8; n -= 8, p += 8) {
+        memcpy(&w, p, 8);
+        h = _zda_case_hash_mix(h ^ _zda_ascii_lower_swar(w), k1);
+    }
+
+    if (n > 0) {
+        w = 0;
+        memcpy(&w, p, n);
+        h = _zda_case_hash_mix(h ^ _zda_ascii_lower_swar(w), k1);
+    }
+
+    return _zda_case_hash_mix(h, k0 ^ k1);
+}
@@ -1,64 +1,478 @@
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE /* strtod_l() */
+#endif
+
 #include "zda/string_view_util.h"
-#include "zda/util/assert.h"
 
+#include <locale.h>
+#include <math.h>
 #include <stdlib.h>
 
-zda_bool zda_string_view_to_u64(zda_string_view_t sv, int base, uint64_t *o_u64) zda_noexcept
+#include "string_view_util_pow5.inc"
+
+/*********************************/
+/* Digit helpers */
+/*********************************/
+static zda_inline uint64_t _zda_load_u64_le(char const *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof v);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/* Check if the 8 characters are all decimal digits in a SWAR way */
+static zda_inline zda_bool _zda_is_8digits(uint64_t v)
+{
+    return (((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+            0x3333333333333333);
+}
+
+/*
+ * Convert the 8 decimal digits to the integer by 3 multiplications
+ * instead of 8 dependent multiply-add.
+ */
+static zda_inline uint32_t _zda_parse_8digits(uint64_t v)
 {
-    zda_assert0(sv.len < 64);
-    static char buf[64];
-    memcpy(buf, sv.data, sv.len);
-    buf[sv.len] = 0;
-    char *end = NULL;
-    uint64_t ret = (uint64_t)strtoull(buf, &end, base);
-    if (ret == 0 && end == buf) {
-        return zda_false;
+    uint64_t const mask = 0x000000FF000000FF;
+    uint64_t const mul1 = 0x000F424000000064; /* 100 + (1000000ULL << 32) */
+    uint64_t const mul2 = 0x0000271000000001; /* 1 + (10000ULL << 32) */
+
+    v -= 0x3030303030303030;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)v;
+}
+
+/* 0-9, a-z, A-Z to 0-35, otherwise 0xff */
+static zda_inline unsigned _zda_digit_value(char c)
+{
+    unsigned char const uc = (unsigned char)c;
+
+    if (uc - '0' < 10) return uc - '0';
+    if ((uc | 0x20) - 'a' < 26) return (uc | 0x20) - 'a' + 10;
+    return 0xff;
+}
+
+/*********************************/
+/* Integer parsing */
+/*********************************/
+/*
+ * Parse the digits with the optional base prefix:
+ * - base 0: "0x"/"0X" is hex, "0b"/"0B" is binary, "0" is octal, otherwise decimal
+ * - base 16: the "0x" prefix is optional
+ * - base 2: the "0b" prefix is optional
+ * All characters must be consumed and the value must be not greater than \p max.
+ */
+static zda_bool _zda_parse_uint(char const *p, size_t n, int base, uint64_t max, uint64_t *out)
+{
+    char const *end = p + n;
+    uint64_t    v   = 0;
+    unsigned    d;
+
+    if (n == 0 || base < 0 || base == 1 || base > 36) return zda_false;
+
+    if (n >= 2 && p[0] == '0') {
+        if ((base == 0 || base == 16) && (p[1] | 0x20) == 'x') {
+            p += 2;
+            base = 16;
+            if (p == end) return zda_false;
+        } else if ((base == 0 || base == 2) && (p[1] | 0x20) == 'b') {
+            p += 2;
+            base = 2;
+            if (p == end) return zda_false;
+        } else if (base == 0) {
+            base = 8;
+        }
     }
-    *o_u64 = ret;
+    if (base == 0) base = 10;
+
+    if (base == 10) {
+        /* Leading zeros don't contribute to the overflow */
+        while (end - p > 1 && *p == '0')
+            ++p;
+
+        /* 10^19 < 2^64 < 10^20, so only the 20th digit may overflow */
+        if (end - p > 20) return zda_false;
+
+        /* At most 16 digits are handled here, v < 10^16 never overflows */
+        while (end - p >= 8 && _zda_is_8digits(_zda_load_u64_le(p))) {
+            v = v * 100000000 + _zda_parse_8digits(_zda_load_u64_le(p));
+            p += 8;
+        }
+    }
+
+    for (; p != end; ++p) {
+        d = _zda_digit_value(*p);
+        if (d >= (unsigned)base) return zda_false;
+        if (__builtin_mul_overflow(v, (uint64_t)base, &v) || __builtin_add_overflow(v, d, &v))
+            return zda_false;
+    }
+
+    if (v > max) return zda_false;
+    *out = v;
     return zda_true;
 }
 
-zda_bool zda_string_view_to_u32(zda_string_view_t sv, int base, uint32_t *o_u32) zda_noexcept
+static zda_bool _zda_parse_int(char const *p, size_t n, int base, uint64_t max, int64_t *out)
 {
-    zda_assert0(sv.len < 32);
-    static char buf[32];
-    memcpy(buf, sv.data, sv.len);
-    buf[sv.len] = 0;
-    char *end = NULL;
-    uint32_t ret = (uint32_t)strtoul(buf, &end, base);
-    if (ret == 0 && end == buf) {
-        return zda_false;
+    zda_bool neg = zda_false;
+    uint64_t mag;
+
+    if (n > 0 && (p[0] == '-' || p[0] == '+')) {
+        neg = p[0] == '-';
+        ++p;
+        --n;
     }
-    *o_u32 = ret;
+
+    /* The magnitude of the minimum is max + 1 */
+    if (!_zda_parse_uint(p, n, base, max + neg, &mag)) return zda_false;
+    *out = neg && mag ? -(int64_t)(mag - 1) - 1 : (int64_t)mag;
+    return zda_true;
+}
+
+zda_bool zda_string_view_to_u64(zda_string_view_t sv, int base, uint64_t *o_u64) zda_noexcept
+{
+    uint64_t v;
+    if (sv.len > 0 && sv.data[0] == '+') zda_string_view_remove_prefix(&sv, 1);
+    if (!_zda_parse_uint(sv.data, sv.len, base, UINT64_MAX, &v)) return zda_false;
+    *o_u64 = v;
+    return zda_true;
+}
+
+zda_bool zda_string_view_to_u32(zda_string_view_t sv, int base, uint32_t *o_u32) zda_noexcept
+{
+    uint64_t v;
+    if (sv.len > 0 && sv.data[0] == '+') zda_string_view_remove_prefix(&sv, 1);
+    if (!_zda_parse_uint(sv.data, sv.len, base, UINT32_MAX, &v)) return zda_false;
+    *o_u32 = (uint32_t)v;
     return zda_true;
 }
 
 zda_bool zda_string_view_to_s64(zda_string_view_t sv, int base, int64_t *o_64) zda_noexcept
 {
-    zda_assert0(sv.len < 64);
-    static char buf[64];
-    memcpy(buf, sv.data, sv.len);
-    buf[sv.len] = 0;
-    char *end = NULL;
-    int64_t ret = (int64_t)strtoll(buf, &end, base);
-    if (ret == 0 && end == buf) {
-        return zda_false;
+    return _zda_parse_int(sv.data, sv.len, base, INT64_MAX, o_64);
+}
+
+zda_bool zda_string_view_to_s32(zda_string_view_t sv, int base, int32_t *o_32) zda_noexcept
+{
+    int64_t v;
+    if (!_zda_parse_int(sv.data, sv.len, base, INT32_MAX, &v)) return zda_false;
+    *o_32 = (int32_t)v;
+    return zda_true;
+}
+
+/*********************************/
+/* Floating-point parsing */
+/*********************************/
+#define _ZDA_DOUBLE_MANTISSA_BITS 52
+#define _ZDA_DOUBLE_MIN_EXP       (-1023)
+#define _ZDA_DOUBLE_INF_POWER     0x7FF
+
+/* Exactly representable powers of ten for the Clinger's fast path */
+static double const _zda_pow10_exact[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static zda_inline double _zda_make_double(zda_bool neg, uint64_t mantissa, int32_t power2)
+{
+    uint64_t bits = mantissa | ((uint64_t)power2 << _ZDA_DOUBLE_MANTISSA_BITS) |
+                    ((uint64_t)neg << 63);
+    double   ret;
+    memcpy(&ret, &bits, sizeof ret);
+    return ret;
+}
+
+/*
+ * Eisel-Lemire algorithm:
+ * w * 10^q is approximated by the product of w and the 128-bit truncated 5^q,
+ * then the 2^q factor is folded into the binary exponent.
+ * The product is accurate enough to round correctly except some rare cases
+ * in which the low bits are ambiguous.
+ *
+ * \p w must be not zero, \p q in [_ZDA_POW5_MIN_EXP, _ZDA_POW5_MAX_EXP].
+ * Return zda_false if the result can't be decided.
+ */
+static zda_bool
+_zda_eisel_lemire(uint64_t w, int64_t q, uint64_t *o_mantissa, int32_t *o_power2)
+{
+    typedef unsigned __int128 u128;
+    uint64_t const *pow5 = &_zda_pow5_128[2 * (q - _ZDA_POW5_MIN_EXP)];
+    int const       lz   = __builtin_clzll(w);
+    u128            product;
+    u128            second;
+    uint64_t        high, low;
+    uint64_t        mantissa;
+    int             upperbit, shift;
+    int32_t         power2;
+
+    w <<= lz;
+
+    product = (u128)w * pow5[0];
+    high    = (uint64_t)(product >> 64);
+    low     = (uint64_t)product;
+    /* The low bits of the high word are not precise enough, refine by the low 64 bits of 5^q */
+    if ((high & 0x1FF) == 0x1FF) {
+        second = (u128)w * pow5[1];
+        low += (uint64_t)(second >> 64);
+        if ((uint64_t)(second >> 64) > low) ++high;
+    }
+
+    /* The truncated bits may carry over the rounding bit */
+    if (low == UINT64_MAX && (q < -27 || q > 55)) return zda_false;
+
+    upperbit = (int)(high >> 63);
+    shift    = upperbit + 64 - _ZDA_DOUBLE_MANTISSA_BITS - 3;
+    mantissa = high >> shift;
+    /* power(q) = floor(q * log2(10)) + 63 */
+    power2 = (int32_t)((((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - _ZDA_DOUBLE_MIN_EXP);
+
+    if (power2 <= 0) {
+        /* Subnormal */
+        if (-power2 + 1 >= 64) {
+            *o_mantissa = 0;
+            *o_power2   = 0;
+            return zda_true;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        *o_mantissa = mantissa;
+        *o_power2   = mantissa < ((uint64_t)1 << _ZDA_DOUBLE_MANTISSA_BITS) ? 0 : 1;
+        return zda_true;
+    }
+
+    /* Exactly halfway between two doubles: round to even */
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1) {
+        if ((mantissa << shift) == high) mantissa &= ~(uint64_t)1;
+    }
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= ((uint64_t)2 << _ZDA_DOUBLE_MANTISSA_BITS)) {
+        mantissa = (uint64_t)1 << _ZDA_DOUBLE_MANTISSA_BITS;
+        ++power2;
+    }
+    mantissa &= ~((uint64_t)1 << _ZDA_DOUBLE_MANTISSA_BITS);
+
+    if (power2 >= _ZDA_DOUBLE_INF_POWER) {
+        power2   = _ZDA_DOUBLE_INF_POWER;
+        mantissa = 0;
+    }
+    *o_mantissa = mantissa;
+    *o_power2   = power2;
+    return zda_true;
+}
+
+/* Compute w * 10^q, return zda_false if the result can't be decided */
+static zda_bool _zda_compute_double(zda_bool neg, uint64_t w, int64_t q, double *out)
+{
+    uint64_t mantissa;
+    int32_t  power2;
+    double   d;
+
+    if (w == 0 || q < _ZDA_POW5_MIN_EXP) {
+        *out = neg ? -0.0 : 0.0;
+        return zda_true;
+    }
+    if (q > _ZDA_POW5_MAX_EXP) {
+        *out = neg ? -HUGE_VAL : HUGE_VAL;
+        return zda_true;
     }
-    *o_64 = ret;
+
+    /* Clinger's fast path: w and 10^q are exact, so the result is correctly rounded */
+    if (q >= -22 && q <= 22 && w <= ((uint64_t)1 << 53)) {
+        d    = (double)w;
+        d    = q < 0 ? d / _zda_pow10_exact[-q] : d * _zda_pow10_exact[q];
+        *out = neg ? -d : d;
+        return zda_true;
+    }
+
+    if (!_zda_eisel_lemire(w, q, &mantissa, &power2)) return zda_false;
+    *out = _zda_make_double(neg, mantissa, power2);
     return zda_true;
 }
 
-zda_bool zda_string_view_to_s32(zda_string_view_t sv, int base, int32_t *o_32) zda_noexcept
+/* The slow path for the rare ambiguous input, the decimal point is always '.' */
+static zda_bool _zda_strtod_c(char const *p, size_t n, double *out)
 {
-    zda_assert0(sv.len < 32);
-    static char buf[32];
-    memcpy(buf, sv.data, sv.len);
-    buf[sv.len] = 0;
-    char *end = NULL;
-    int32_t ret = (int32_t)strtol(buf, &end, base);
-    if (ret == 0 && end == buf) {
-        return zda_false;
+    static locale_t c_locale;
+    locale_t        loc = __atomic_load_n(&c_locale, __ATOMIC_ACQUIRE);
+    locale_t        expected;
+    char            stack_buf[128];
+    char           *buf = stack_buf;
+    char           *end;
+
+    if (!loc) {
+        loc = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+        if (!loc) return zda_false;
+        expected = (locale_t)0;
+        if (!__atomic_compare_exchange_n(
+                &c_locale,
+                &expected,
+                loc,
+                zda_false,
+                __ATOMIC_ACQ_REL,
+                __ATOMIC_ACQUIRE
+            ))
+        {
+            freelocale(loc);
+            loc = expected;
+        }
+    }
+
+    if (n >= sizeof stack_buf) {
+        buf = (char *)malloc(n + 1);
+        if (!buf) return zda_false;
     }
-    *o_32 = ret;
+    memcpy(buf, p, n);
+    buf[n] = 0;
+    *out   = strtod_l(buf, &end, loc);
+    if (buf != stack_buf) free(buf);
     return zda_true;
-}
\ No newline at end of file
+}
+
+static zda_inline zda_bool _zda_case_equal(char const *p, char const *lower, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        if ((p[i] | 0x20) != lower[i]) return zda_false;
+    return zda_true;
+}
+
+/*
+ * Accepted grammar(no whitespace):
+ *   [+-] (digits [. digits*] | . digits) [(e|E) [+-] digits]
+ *   [+-] (inf | infinity | nan)         (case-insensitive)
+ */
+zda_bool zda_string_view_to_double(zda_string_view_t sv, double *o_d) zda_noexcept
+{
+    char const *p   = sv.data;
+    char const *end = sv.data + sv.len;
+    char const *int_begin, *int_end, *frac_begin, *frac_end;
+    char const *digit;
+    zda_bool    neg = zda_false;
+    zda_bool    exp_neg;
+    zda_bool    truncated = zda_false;
+    int64_t     exp       = 0;
+    int64_t     q;
+    uint64_t    w = 0;
+    size_t      ndigits;
+    size_t      int_len;
+    size_t      nfrac;
+    size_t      taken;
+    double      d, d_up;
+
+    if (p != end && (*p == '-' || *p == '+')) {
+        neg = *p == '-';
+        ++p;
+    }
+
+    if (end - p == 3 && _zda_case_equal(p, "inf", 3)) {
+        *o_d = neg ? -HUGE_VAL : HUGE_VAL;
+        return zda_true;
+    }
+    if (end - p == 8 && _zda_case_equal(p, "infinity", 8)) {
+        *o_d = neg ? -HUGE_VAL : HUGE_VAL;
+        return zda_true;
+    }
+    if (end - p == 3 && _zda_case_equal(p, "nan", 3)) {
+        *o_d = neg ? -NAN : NAN;
+        return zda_true;
+    }
+
+    /* Scan the structure */
+    int_begin = p;
+    while (p != end && (unsigned char)(*p - '0') < 10)
+        ++p;
+    int_end    = p;
+    frac_begin = frac_end = p;
+    if (p != end && *p == '.') {
+        frac_begin = ++p;
+        while (p != end && (unsigned char)(*p - '0') < 10)
+            ++p;
+        frac_end = p;
+    }
+    if (int_begin == int_end && frac_begin == frac_end) return zda_false;
+
+    if (p != end && (*p | 0x20) == 'e') {
+        ++p;
+        exp_neg = zda_false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            exp_neg = *p == '-';
+            ++p;
+        }
+        if (p == end) return zda_false;
+        for (; p != end && (unsigned char)(*p - '0') < 10; ++p) {
+            /* Saturate, the result is zero or infinity anyway */
+            if (exp < 0x10000000) exp = exp * 10 + (*p - '0');
+        }
+        if (exp_neg) exp = -exp;
+    }
+    if (p != end) return zda_false;
+
+    /* Skip the leading zeros of the integer part and the fraction part */
+    nfrac = (size_t)(frac_end - frac_begin);
+    while (int_begin != int_end && *int_begin == '0')
+        ++int_begin;
+    if (int_begin == int_end) {
+        while (frac_begin != frac_end && *frac_begin == '0')
+            ++frac_begin;
+    }
+
+    /*
+     * The value is D * 10^(exp - nfrac) where D is the significant digits.
+     * Take 19 digits at most to w since 10^19 < 2^64.
+     */
+    ndigits = (size_t)(int_end - int_begin) + (size_t)(frac_end - frac_begin);
+    taken   = 0;
+    for (digit = int_begin; digit != int_end && taken < 19;) {
+        if (int_end - digit >= 8 && taken + 8 <= 19) {
+            w = w * 100000000 + _zda_parse_8digits(_zda_load_u64_le(digit));
+            digit += 8;
+            taken += 8;
+        } else {
+            w = w * 10 + (uint64_t)(*digit++ - '0');
+            ++taken;
+        }
+    }
+    for (digit = frac_begin; digit != frac_end && taken < 19;) {
+        if (frac_end - digit >= 8 && taken + 8 <= 19) {
+            w = w * 100000000 + _zda_parse_8digits(_zda_load_u64_le(digit));
+            digit += 8;
+            taken += 8;
+        } else {
+            w = w * 10 + (uint64_t)(*digit++ - '0');
+            ++taken;
+        }
+    }
+
+    q = exp - (int64_t)nfrac + (int64_t)(ndigits - taken);
+    if (ndigits > taken) {
+        /* The digits after the first 19 are dropped, check they are not all zeros */
+        int_len = (size_t)(int_end - int_begin);
+        digit   = taken < int_len ? int_begin + taken : frac_begin + (taken - int_len);
+        for (; digit != frac_end; ++digit) {
+            if (*digit != '0' && *digit != '.') {
+                truncated = zda_true;
+                break;
+            }
+        }
+    }
+
+    if (!truncated) {
+        if (_zda_compute_double(neg, w, q, o_d)) return zda_true;
+    } else {
+        /* w * 10^q <= value < (w+1) * 10^q, the result is decided if both are same */
+        if (_zda_compute_double(neg, w, q, &d) && _zda_compute_double(neg, w + 1, q, &d_up) &&
+            memcmp(&d, &d_up, sizeof d) == 0)
+        {
+            *o_d = d;
+            return zda_true;
+        }
+    }
+
+    return _zda_strtod_c(sv.data, sv.len, o_d);
+}
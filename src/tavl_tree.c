@@ -0,0 +1,80 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#include "zda/tavl_tree.h"
+#include "zda/util/assert.h"
+
+void zda_tavl_tree_insert_commit(
+    zda_tavl_tree_t      *tree,
+    zda_avl_commit_ctx_t *p_ctx,
+    zda_tavl_node_t      *new_node
+) zda_noexcept
+{
+  zda_tavl_node_t *parent;
+
+  if (!p_ctx->p_parent) {
+    assert(!tree->first);
+    new_node->prev = new_node->next = NULL;
+    tree->first = tree->last = new_node;
+  } else {
+    parent = zda_tavl_node_from_avl(p_ctx->p_parent);
+    /* The new leaf is the left child of parent:
+     * parent is its successor, the old predecessor of parent is its predecessor.
+     * The right child is symmetric. */
+    if (p_ctx->pp_slot == &p_ctx->p_parent->left) {
+      new_node->next = parent;
+      new_node->prev = parent->prev;
+      if (parent->prev) {
+        parent->prev->next = new_node;
+      } else {
+        tree->first = new_node;
+      }
+      parent->prev = new_node;
+    } else {
+      assert(p_ctx->pp_slot == &p_ctx->p_parent->right);
+      new_node->prev = parent;
+      new_node->next = parent->next;
+      if (parent->next) {
+        parent->next->prev = new_node;
+      } else {
+        tree->last = new_node;
+      }
+      parent->next = new_node;
+    }
+  }
+
+  zda_avl_tree_insert_commit(&tree->tree, p_ctx, &new_node->avl);
+}
+
+void zda_tavl_tree_remove_node(zda_tavl_tree_t *tree, zda_tavl_node_t *old_node) zda_noexcept
+{
+  if (old_node->prev) {
+    old_node->prev->next = old_node->next;
+  } else {
+    tree->first = old_node->next;
+  }
+
+  if (old_node->next) {
+    old_node->next->prev = old_node->prev;
+  } else {
+    tree->last = old_node->prev;
+  }
+
+  zda_avl_tree_remove_node(&tree->tree, &old_node->avl);
+}
+
+zda_bool zda_tavl_tree_verify_properties(zda_tavl_tree_t *tree) zda_noexcept
+{
+  zda_avl_node_t  *pos;
+  zda_tavl_node_t *thread = tree->first;
+  zda_tavl_node_t *prev   = NULL;
+
+  if (!zda_avl_tree_verify_properties(&tree->tree)) return zda_false;
+
+  for (pos = zda_avl_tree_get_first(&tree->tree); pos != NULL; pos = zda_avl_node_get_next(pos)) {
+    if (thread != zda_tavl_node_from_avl(pos)) return zda_false;
+    if (thread->prev != prev) return zda_false;
+    prev   = thread;
+    thread = thread->next;
+  }
+
+  return thread == NULL && tree->last == prev;
+}
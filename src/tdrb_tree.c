@@ -0,0 +1,129 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#include "zda/tdrb_tree.h"
+#include "zda/util/assert.h"
+#include "zda/util/macro.h"
+
+/*
+ * Case 1: The sibling of q(i.e. the child at !dir) is red:
+ *   rotate q to dir, then q is red and p is updated to the new parent.
+ * Case 2: Both children of q are black:
+ *   - The children of the sibling s are black: color flip to merge p, q, s into a 4-node
+ *   - Otherwise, borrow a node from s by the rotation at p.
+ */
+void _zda_tdrb_tree_push_red(zda_tdrb_remove_ctx_t *ctx) zda_noexcept
+{
+  zda_tdrb_node_t *q    = ctx->q;
+  zda_tdrb_node_t *p    = ctx->p;
+  zda_tdrb_node_t *g    = ctx->g;
+  const int        dir  = ctx->dir;
+  const int        last = ctx->last;
+  zda_tdrb_node_t *s;
+  zda_tdrb_node_t *new_root;
+  int              gdir;
+
+  if (q->red || _zda_tdrb_node_is_red(q->link[dir])) return;
+
+  if (_zda_tdrb_node_is_red(q->link[!dir])) {
+    new_root      = _zda_tdrb_node_rotate(q, dir);
+    p->link[last] = new_root;
+    if (q == ctx->f) {
+      ctx->fp   = new_root;
+      ctx->fdir = dir;
+    }
+    ctx->p = new_root;
+    return;
+  }
+
+  s = p->link[!last];
+  if (!s) return;
+
+  if (!_zda_tdrb_node_is_red(s->link[0]) && !_zda_tdrb_node_is_red(s->link[1])) {
+    p->red = zda_false;
+    s->red = q->red = zda_true;
+  } else {
+    /* p is red since q and s are black, then p is not root and g is not NULL */
+    assert(g);
+    gdir = g->link[1] == p;
+    if (_zda_tdrb_node_is_red(s->link[last])) {
+      new_root = _zda_tdrb_node_rotate2(p, last);
+    } else {
+      new_root = _zda_tdrb_node_rotate(p, last);
+    }
+    g->link[gdir] = new_root;
+
+    q->red                 = zda_true;
+    new_root->red          = zda_true;
+    new_root->link[0]->red = zda_false;
+    new_root->link[1]->red = zda_false;
+    /* p is moved to the child of new root */
+    if (p == ctx->f) {
+      ctx->fp   = new_root;
+      ctx->fdir = last;
+    }
+  }
+}
+
+void _zda_tdrb_tree_remove_finish(zda_tdrb_tree_t *tree, zda_tdrb_remove_ctx_t *ctx) zda_noexcept
+{
+  zda_tdrb_node_t *q = ctx->q;
+  zda_tdrb_node_t *f = ctx->f;
+  zda_tdrb_node_t *p = ctx->p;
+
+  if (f) {
+    /* q has one child at most */
+    p->link[p->link[1] == q] = q->link[q->link[0] == NULL];
+
+    /* q is the predecessor of f, replace f with it */
+    if (q != f) {
+      assert(ctx->fp->link[ctx->fdir] == f);
+      q->link[0]               = f->link[0];
+      q->link[1]               = f->link[1];
+      q->red                   = f->red;
+      ctx->fp->link[ctx->fdir] = q;
+    }
+  }
+
+  tree->root = ctx->head.link[1];
+  if (tree->root) tree->root->red = zda_false;
+}
+
+/**************************/
+/* Debug APIs */
+/**************************/
+static size_t _zda_tdrb_node_get_height(zda_tdrb_node_t *node) zda_noexcept
+{
+  size_t lh, rh;
+  if (!node) return 0;
+  lh = _zda_tdrb_node_get_height(node->link[0]);
+  rh = _zda_tdrb_node_get_height(node->link[1]);
+  return zda_max(lh, rh) + 1;
+}
+
+size_t zda_tdrb_tree_get_height(zda_tdrb_tree_t *tree) zda_noexcept
+{
+  return _zda_tdrb_node_get_height(tree->root);
+}
+
+/* Return the black height of \p node, 0 if the properties are violated */
+static size_t _zda_tdrb_node_verify(zda_tdrb_node_t *node) zda_noexcept
+{
+  size_t lbh, rbh;
+  if (!node) return 1;
+
+  if (node->red &&
+      (_zda_tdrb_node_is_red(node->link[0]) || _zda_tdrb_node_is_red(node->link[1])))
+  {
+    return 0;
+  }
+
+  lbh = _zda_tdrb_node_verify(node->link[0]);
+  rbh = _zda_tdrb_node_verify(node->link[1]);
+  if (lbh == 0 || lbh != rbh) return 0;
+  return lbh + !node->red;
+}
+
+zda_bool zda_tdrb_tree_verify_properties(zda_tdrb_tree_t *tree) zda_noexcept
+{
+  if (_zda_tdrb_node_is_red(tree->root)) return zda_false;
+  return _zda_tdrb_node_verify(tree->root) != 0;
+}
@@ -0,0 +1,205 @@
+#include "zda/thread_pool.hpp"
+
+namespace zda {
+
+struct ThreadPool::Worker {
+    Worker(ThreadPool *p, int i)
+      : pool(p)
+      , index(i)
+      , seed((uint32_t)i * 2654435761u + 1)
+    {
+    }
+
+    /* xorshift32, to choose the victim */
+    uint32_t next_random() noexcept
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    ThreadPool *pool;
+    int index;
+    uint32_t seed;
+    WorkStealingDeque<detail::PoolTask> deque;
+    std::thread thread;
+};
+
+thread_local ThreadPool::Worker *ThreadPool::tls_worker_ = nullptr;
+
+ThreadPool::ThreadPool(size_t nthread)
+  : injected_count_(0)
+  , epoch_(0)
+  , sleepers_(0)
+  , stop_(false)
+{
+    if (nthread == 0) nthread = zda_max(std::thread::hardware_concurrency(), 1u);
+
+    /* The workers_ must be stable before any worker runs */
+    workers_.reserve(nthread);
+    for (size_t i = 0; i < nthread; ++i)
+        workers_.emplace_back(new Worker(this, (int)i));
+
+    try {
+        for (auto &worker : workers_)
+            worker->thread = std::thread(&ThreadPool::worker_loop, this, worker.get());
+    }
+    catch (...) {
+        shutdown();
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept { shutdown(); }
+
+void ThreadPool::shutdown() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cond_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+ThreadPool &ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+int ThreadPool::current_worker() const noexcept
+{
+    Worker *worker = current();
+    return worker ? worker->index : -1;
+}
+
+ThreadPool::Worker *ThreadPool::current() const noexcept
+{
+    return (tls_worker_ && tls_worker_->pool == this) ? tls_worker_ : nullptr;
+}
+
+void ThreadPool::notify_one()
+{
+    /* Pairs with the check of epoch after increasing sleepers in worker_loop(),
+     * one of them must see the update of the other */
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) != 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cond_.notify_one();
+    }
+}
+
+void ThreadPool::fork(Worker *worker, detail::PoolTask *task)
+{
+    worker->deque.push(task);
+    notify_one();
+}
+
+void ThreadPool::join(Worker *worker, detail::PoolTask *task)
+{
+    /* Run other tasks instead of blocking until the task is done.
+     * If the task is not stolen, it is popped here. */
+    while (!task->done.load(std::memory_order_acquire)) {
+        detail::PoolTask *other = find_task(worker);
+        if (other)
+            execute(other);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void ThreadPool::submit_and_wait(detail::PoolTask *task)
+{
+    task->external = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        injected_.push_back(task);
+        injected_count_.fetch_add(1, std::memory_order_release);
+    }
+    notify_one();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cond_.wait(lock, [task]() { return task->done.load(std::memory_order_acquire); });
+}
+
+detail::PoolTask *ThreadPool::find_task(Worker *worker)
+{
+    detail::PoolTask *task = worker->deque.pop();
+    if (task) return task;
+
+    size_t const n = workers_.size();
+    if (n > 1) {
+        /* The steal may fail due to the contention, retry if someone is not empty */
+        bool retry = true;
+        for (int round = 0; retry && round < 4; ++round) {
+            retry = false;
+            size_t const start = worker->next_random() % n;
+            for (size_t i = 0; i < n; ++i) {
+                Worker *victim = workers_[(start + i) % n].get();
+                if (victim == worker) continue;
+                task = victim->deque.steal();
+                if (task) return task;
+                if (!victim->deque.empty()) retry = true;
+            }
+        }
+    }
+
+    if (injected_count_.load(std::memory_order_acquire) != 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!injected_.empty()) {
+            task = injected_.front();
+            injected_.pop_front();
+            injected_count_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+    return task;
+}
+
+void ThreadPool::execute(detail::PoolTask *task)
+{
+    /* The task may be destroyed once done is set */
+    bool const external = task->external;
+
+    try {
+        task->fn(task);
+    }
+    catch (...) {
+        task->error = std::current_exception();
+    }
+
+    if (external) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task->done.store(true, std::memory_order_release);
+        done_cond_.notify_all();
+    } else {
+        task->done.store(true, std::memory_order_release);
+    }
+}
+
+void ThreadPool::worker_loop(Worker *worker)
+{
+    tls_worker_ = worker;
+
+    for (;;) {
+        uint64_t const epoch = epoch_.load(std::memory_order_seq_cst);
+        detail::PoolTask *task = find_task(worker);
+        if (task) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stop_) break;
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        cond_.wait(lock, [this, epoch]() {
+            return stop_ || epoch_.load(std::memory_order_seq_cst) != epoch;
+        });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace zda
@@ -0,0 +1,586 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#define _FILE_OFFSET_BITS 64
+
+#include "zda/tree_snapshot.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  define _ZDA_TREE_SNAPSHOT_MMAP 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#define _ZDA_TREE_SNAPSHOT_MAGIC   "ZDATRSNP"
+#define _ZDA_TREE_SNAPSHOT_ENDIAN  0x0102030405060708ULL
+#define _ZDA_TREE_SNAPSHOT_VERSION 1
+
+/* The maximum length of LEB128 varint of uint64_t */
+#define _ZDA_VARINT_MAX_LEN 10
+
+typedef struct _zda_tree_snapshot_header {
+  char     magic[8];
+  uint64_t endian;
+  uint64_t version;
+  uint64_t cnt;
+  uint64_t flags;
+  uint64_t index_off;
+  uint64_t offs_off;
+  uint64_t size;
+} _zda_tree_snapshot_header_t;
+
+static zda_inline uint64_t _zda_align8(uint64_t n) zda_noexcept { return (n + 7) & ~(uint64_t)7; }
+
+static zda_inline size_t _zda_varint_encode(unsigned char *p, uint64_t x) zda_noexcept
+{
+  size_t n = 0;
+  while (x >= 0x80) {
+    p[n++] = (unsigned char)(x | 0x80);
+    x      >>= 7;
+  }
+  p[n++] = (unsigned char)x;
+  return n;
+}
+
+static zda_inline uint64_t _zda_varint_decode(unsigned char const **pp) zda_noexcept
+{
+  unsigned char const *p     = *pp;
+  uint64_t             x     = 0;
+  unsigned             shift = 0;
+  for (;; shift += 7) {
+    unsigned char const c = *p++;
+    x                     |= (uint64_t)(c & 0x7f) << shift;
+    if (!(c & 0x80)) break;
+  }
+  *pp = p;
+  return x;
+}
+
+/************************************/
+/* Writer */
+/************************************/
+/* The records are written in one pass, the keys and record offsets are collected in memory and
+ * written after the records since the size of the compressed keys is unknown before. */
+typedef struct _zda_tree_snapshot_writer {
+  FILE                      *fp;
+  off_t                      base;
+  uint64_t                   off;
+  uint64_t                  *keys;
+  uint64_t                  *offs;
+  size_t                     cnt;
+  size_t                     capa;
+  void                      *buf;
+  size_t                     buf_size;
+  zda_tree_snapshot_key_cb_t get_key;
+  zda_tree_serialize_cb_t    serialize;
+  void                      *ctx;
+} _zda_tree_snapshot_writer_t;
+
+static int _zda_tree_snapshot_writer_init(
+    _zda_tree_snapshot_writer_t *writer,
+    FILE                        *fp,
+    zda_tree_snapshot_key_cb_t   get_key,
+    zda_tree_serialize_cb_t      serialize,
+    void                        *ctx
+) zda_noexcept
+{
+  memset(writer, 0, sizeof *writer);
+  writer->fp        = fp;
+  writer->get_key   = get_key;
+  writer->serialize = serialize;
+  writer->ctx       = ctx;
+  writer->off       = sizeof(_zda_tree_snapshot_header_t);
+  writer->buf_size  = 256;
+  writer->buf       = malloc(writer->buf_size);
+  writer->base      = ftello(fp);
+
+  if (!writer->buf || writer->base < 0) return -1;
+  /* The header is written at last */
+  return fseeko(fp, writer->base + (off_t)writer->off, SEEK_SET);
+}
+
+static void _zda_tree_snapshot_writer_destroy(_zda_tree_snapshot_writer_t *writer) zda_noexcept
+{
+  free(writer->keys);
+  free(writer->offs);
+  free(writer->buf);
+}
+
+static int _zda_tree_snapshot_writer_add(_zda_tree_snapshot_writer_t *writer, void const *node)
+    zda_noexcept
+{
+  static char const padding[8] = {0};
+  uint64_t const    key        = writer->get_key(node, writer->ctx);
+  size_t            len        = writer->serialize(node, writer->buf, writer->buf_size, writer->ctx);
+  uint64_t          len64;
+  size_t            pad;
+
+  if (writer->cnt > 0 && key < writer->keys[writer->cnt - 1]) return -1;
+  if (len == (size_t)-1) return -1;
+  if (len > writer->buf_size) {
+    void *new_buf = realloc(writer->buf, len);
+    if (!new_buf) return -1;
+    writer->buf      = new_buf;
+    writer->buf_size = len;
+    len              = writer->serialize(node, writer->buf, writer->buf_size, writer->ctx);
+    if (len == (size_t)-1 || len > writer->buf_size) return -1;
+  }
+
+  if (writer->cnt == writer->capa) {
+    size_t const new_capa = writer->capa ? writer->capa * 2 : 64;
+    uint64_t    *new_keys = (uint64_t *)realloc(writer->keys, new_capa * sizeof(uint64_t));
+    uint64_t    *new_offs;
+    if (!new_keys) return -1;
+    writer->keys = new_keys;
+    /* The offsets has an extra slot for the end */
+    new_offs = (uint64_t *)realloc(writer->offs, (new_capa + 1) * sizeof(uint64_t));
+    if (!new_offs) return -1;
+    writer->offs = new_offs;
+    writer->capa = new_capa;
+  }
+
+  len64 = len;
+  pad   = (size_t)(_zda_align8(len) - len);
+  if (fwrite(&len64, sizeof len64, 1, writer->fp) != 1) return -1;
+  if (len && fwrite(writer->buf, len, 1, writer->fp) != 1) return -1;
+  if (pad && fwrite(padding, pad, 1, writer->fp) != 1) return -1;
+
+  writer->keys[writer->cnt] = key;
+  writer->offs[writer->cnt] = writer->off;
+  writer->off               += sizeof(uint64_t) + _zda_align8(len);
+  ++writer->cnt;
+  return 0;
+}
+
+/* Write the delta-compressed key index and return its size, or -1 */
+static int64_t _zda_tree_snapshot_write_delta_index(_zda_tree_snapshot_writer_t *writer
+) zda_noexcept
+{
+  static char const padding[8]  = {0};
+  size_t const      nblk        = (writer->cnt + ZDA_TREE_SNAPSHOT_BLOCK - 1) / ZDA_TREE_SNAPSHOT_BLOCK;
+  uint64_t         *blk_keys    = (uint64_t *)malloc((2 * nblk + 1) * sizeof(uint64_t));
+  unsigned char    *deltas      = (unsigned char *)malloc(writer->cnt * _ZDA_VARINT_MAX_LEN + 1);
+  uint64_t         *blk_offs    = blk_keys + nblk;
+  uint64_t const    deltas_base = writer->off + (2 * nblk + 1) * sizeof(uint64_t);
+  size_t            deltas_len  = 0;
+  size_t            pad;
+  int64_t           ret         = -1;
+
+  if (!blk_keys || !deltas) goto out;
+
+  for (size_t i = 0; i < writer->cnt; ++i) {
+    if (i % ZDA_TREE_SNAPSHOT_BLOCK == 0) {
+      blk_keys[i / ZDA_TREE_SNAPSHOT_BLOCK] = writer->keys[i];
+      blk_offs[i / ZDA_TREE_SNAPSHOT_BLOCK] = deltas_base + deltas_len;
+    } else {
+      deltas_len += _zda_varint_encode(deltas + deltas_len, writer->keys[i] - writer->keys[i - 1]);
+    }
+  }
+  blk_offs[nblk] = deltas_base + deltas_len;
+  pad            = (size_t)(_zda_align8(deltas_len) - deltas_len);
+
+  if (fwrite(blk_keys, sizeof(uint64_t), 2 * nblk + 1, writer->fp) != 2 * nblk + 1) goto out;
+  if (deltas_len && fwrite(deltas, deltas_len, 1, writer->fp) != 1) goto out;
+  if (pad && fwrite(padding, pad, 1, writer->fp) != 1) goto out;
+  ret = (int64_t)((2 * nblk + 1) * sizeof(uint64_t) + deltas_len + pad);
+
+out:
+  free(blk_keys);
+  free(deltas);
+  return ret;
+}
+
+static int _zda_tree_snapshot_writer_finish(_zda_tree_snapshot_writer_t *writer, unsigned flags)
+    zda_noexcept
+{
+  _zda_tree_snapshot_header_t header;
+  uint64_t const              index_off = writer->off;
+
+  if (writer->cnt == 0) {
+    /* The offsets needs the end slot */
+    writer->offs = (uint64_t *)malloc(sizeof(uint64_t));
+    if (!writer->offs) return -1;
+  }
+  writer->offs[writer->cnt] = writer->off;
+
+  if (flags & ZDA_TREE_SNAPSHOT_DELTA) {
+    int64_t const index_size = _zda_tree_snapshot_write_delta_index(writer);
+    if (index_size < 0) return -1;
+    writer->off += (uint64_t)index_size;
+  } else {
+    if (writer->cnt && fwrite(writer->keys, sizeof(uint64_t), writer->cnt, writer->fp) != writer->cnt)
+      return -1;
+    writer->off += writer->cnt * sizeof(uint64_t);
+  }
+
+  if (fwrite(writer->offs, sizeof(uint64_t), writer->cnt + 1, writer->fp) != writer->cnt + 1)
+    return -1;
+
+  memset(&header, 0, sizeof header);
+  memcpy(header.magic, _ZDA_TREE_SNAPSHOT_MAGIC, sizeof header.magic);
+  header.endian    = _ZDA_TREE_SNAPSHOT_ENDIAN;
+  header.version   = _ZDA_TREE_SNAPSHOT_VERSION;
+  header.cnt       = writer->cnt;
+  header.flags     = flags;
+  header.index_off = index_off;
+  header.offs_off  = writer->off;
+  header.size      = writer->off + (writer->cnt + 1) * sizeof(uint64_t);
+
+  if (fseeko(writer->fp, writer->base, SEEK_SET) != 0) return -1;
+  if (fwrite(&header, sizeof header, 1, writer->fp) != 1) return -1;
+  if (fseeko(writer->fp, writer->base + (off_t)header.size, SEEK_SET) != 0) return -1;
+  return fflush(writer->fp) == 0 ? 0 : -1;
+}
+
+int zda_rb_tree_snapshot_write(
+    zda_rb_tree_t             *tree,
+    FILE                      *fp,
+    unsigned                   flags,
+    zda_tree_snapshot_key_cb_t get_key,
+    zda_tree_serialize_cb_t    serialize,
+    void                      *ctx
+) zda_noexcept
+{
+  _zda_tree_snapshot_writer_t writer;
+  int                         ret = -1;
+
+  if (flags & ~(unsigned)ZDA_TREE_SNAPSHOT_DELTA) return -1;
+  if (_zda_tree_snapshot_writer_init(&writer, fp, get_key, serialize, ctx) != 0) goto out;
+  zda_rb_tree_iterate(tree)
+  {
+    if (_zda_tree_snapshot_writer_add(&writer, pos) != 0) goto out;
+  }
+  ret = _zda_tree_snapshot_writer_finish(&writer, flags);
+
+out:
+  _zda_tree_snapshot_writer_destroy(&writer);
+  return ret;
+}
+
+int zda_avl_tree_snapshot_write(
+    zda_avl_tree_t            *tree,
+    FILE                      *fp,
+    unsigned                   flags,
+    zda_tree_snapshot_key_cb_t get_key,
+    zda_tree_serialize_cb_t    serialize,
+    void                      *ctx
+) zda_noexcept
+{
+  _zda_tree_snapshot_writer_t writer;
+  int                         ret = -1;
+
+  if (flags & ~(unsigned)ZDA_TREE_SNAPSHOT_DELTA) return -1;
+  if (_zda_tree_snapshot_writer_init(&writer, fp, get_key, serialize, ctx) != 0) goto out;
+  for (zda_avl_node_t *pos = zda_avl_tree_get_first(tree); pos; pos = zda_avl_node_get_next(pos)) {
+    if (_zda_tree_snapshot_writer_add(&writer, pos) != 0) goto out;
+  }
+  ret = _zda_tree_snapshot_writer_finish(&writer, flags);
+
+out:
+  _zda_tree_snapshot_writer_destroy(&writer);
+  return ret;
+}
+
+/************************************/
+/* Reader */
+/************************************/
+/*
+ * Only the O(1) checks are done, checking every record would read the whole file and defeat
+ * the purpose of mmap().
+ */
+int zda_tree_snapshot_init(zda_tree_snapshot_t *snap, void const *base, size_t size) zda_noexcept
+{
+  _zda_tree_snapshot_header_t const *header = (_zda_tree_snapshot_header_t const *)base;
+  char const                        *p      = (char const *)base;
+  uint64_t                           cnt, nblk = 0, index_size;
+  uint64_t const                    *offs;
+
+  if (size < sizeof *header || ((uintptr_t)base & 7) != 0) return -1;
+  if (memcmp(header->magic, _ZDA_TREE_SNAPSHOT_MAGIC, sizeof header->magic) != 0) return -1;
+  if (header->endian != _ZDA_TREE_SNAPSHOT_ENDIAN) return -1;
+  if (header->version != _ZDA_TREE_SNAPSHOT_VERSION) return -1;
+  if (header->flags & ~(uint64_t)ZDA_TREE_SNAPSHOT_DELTA) return -1;
+  if (header->size > size || header->size < sizeof *header) return -1;
+  if ((header->index_off | header->offs_off) & 7) return -1;
+  if (header->index_off < sizeof *header || header->index_off > header->offs_off) return -1;
+  if (header->offs_off > header->size) return -1;
+
+  cnt = header->cnt;
+  if (cnt >= (header->size - header->offs_off) / sizeof(uint64_t)) return -1;
+  if (header->offs_off + (cnt + 1) * sizeof(uint64_t) != header->size) return -1;
+
+  offs       = (uint64_t const *)(p + header->offs_off);
+  index_size = header->offs_off - header->index_off;
+  if (cnt > 0 && offs[0] != sizeof *header) return -1;
+  if (offs[cnt] != header->index_off) return -1;
+
+  if (header->flags & ZDA_TREE_SNAPSHOT_DELTA) {
+    uint64_t const *blk_offs;
+    nblk = (cnt + ZDA_TREE_SNAPSHOT_BLOCK - 1) / ZDA_TREE_SNAPSHOT_BLOCK;
+    if (index_size / sizeof(uint64_t) < 2 * nblk + 1) return -1;
+    blk_offs = (uint64_t const *)(p + header->index_off) + nblk;
+    if (blk_offs[0] != header->index_off + (2 * nblk + 1) * sizeof(uint64_t)) return -1;
+    if (blk_offs[nblk] > header->offs_off) return -1;
+    snap->blk_keys = (uint64_t const *)(p + header->index_off);
+    snap->blk_offs = blk_offs;
+    snap->keys     = NULL;
+  } else {
+    if (index_size / sizeof(uint64_t) < cnt) return -1;
+    snap->keys     = (uint64_t const *)(p + header->index_off);
+    snap->blk_keys = NULL;
+    snap->blk_offs = NULL;
+  }
+
+  snap->base   = p;
+  snap->size   = size;
+  snap->cnt    = (size_t)cnt;
+  snap->offs   = offs;
+  snap->nblk   = (size_t)nblk;
+  snap->flags  = (unsigned)header->flags;
+  snap->mapped = zda_false;
+  return 0;
+}
+
+int zda_tree_snapshot_open(zda_tree_snapshot_t *snap, char const *path) zda_noexcept
+{
+#ifdef _ZDA_TREE_SNAPSHOT_MMAP
+  struct stat st;
+  void       *base;
+  int const   fd = open(path, O_RDONLY);
+
+  if (fd < 0) return -1;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return -1;
+  }
+
+  base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  /* The mapping keeps the file referenced */
+  close(fd);
+  if (base == MAP_FAILED) return -1;
+
+  if (zda_tree_snapshot_init(snap, base, (size_t)st.st_size) != 0) {
+    munmap(base, (size_t)st.st_size);
+    return -1;
+  }
+  snap->mapped = zda_true;
+  return 0;
+#else
+  (void)snap;
+  (void)path;
+  return -1;
+#endif
+}
+
+void zda_tree_snapshot_close(zda_tree_snapshot_t *snap) zda_noexcept
+{
+#ifdef _ZDA_TREE_SNAPSHOT_MMAP
+  if (snap->mapped) munmap((void *)snap->base, snap->size);
+#endif
+  snap->base   = NULL;
+  snap->size   = 0;
+  snap->cnt    = 0;
+  snap->mapped = zda_false;
+}
+
+static zda_inline unsigned char const *
+_zda_tree_snapshot_block_deltas(zda_tree_snapshot_t const *snap, size_t blk) zda_noexcept
+{
+  return (unsigned char const *)snap->base + snap->blk_offs[blk];
+}
+
+uint64_t _zda_tree_snapshot_get_delta_key(zda_tree_snapshot_t const *snap, size_t idx) zda_noexcept
+{
+  size_t const         blk = idx / ZDA_TREE_SNAPSHOT_BLOCK;
+  unsigned char const *pos = _zda_tree_snapshot_block_deltas(snap, blk);
+  uint64_t             key = snap->blk_keys[blk];
+
+  for (size_t i = idx % ZDA_TREE_SNAPSHOT_BLOCK; i > 0; --i)
+    key += _zda_varint_decode(&pos);
+  return key;
+}
+
+/* Return the first index i in [0, n) that keys[i] >= key, or n */
+static zda_inline size_t
+_zda_tree_snapshot_lower_bound_array(uint64_t const *keys, size_t n, uint64_t key) zda_noexcept
+{
+  size_t lo = 0;
+  while (n > 0) {
+    size_t const half = n / 2;
+    if (keys[lo + half] < key) {
+      lo += half + 1;
+      n  -= half + 1;
+    } else {
+      n = half;
+    }
+  }
+  return lo;
+}
+
+/* Same as the zda_tree_snapshot_lower_bound(), and return the key at the index by \p p_key */
+static size_t _zda_tree_snapshot_lower_bound(
+    zda_tree_snapshot_t const *snap,
+    uint64_t                   key,
+    uint64_t                  *p_key
+) zda_noexcept
+{
+  size_t               blk, idx, end;
+  unsigned char const *pos;
+  uint64_t             cur;
+
+  if (!(snap->flags & ZDA_TREE_SNAPSHOT_DELTA)) {
+    idx = _zda_tree_snapshot_lower_bound_array(snap->keys, snap->cnt, key);
+    if (idx < snap->cnt) *p_key = snap->keys[idx];
+    return idx;
+  }
+
+  /* The answer is in the block before the first block whose first key >= key, or is the first
+   * entry of that block */
+  blk = _zda_tree_snapshot_lower_bound_array(snap->blk_keys, snap->nblk, key);
+  if (blk > 0) {
+    idx = (blk - 1) * ZDA_TREE_SNAPSHOT_BLOCK;
+    end = zda_min(idx + ZDA_TREE_SNAPSHOT_BLOCK, snap->cnt);
+    pos = _zda_tree_snapshot_block_deltas(snap, blk - 1);
+    cur = snap->blk_keys[blk - 1];
+    for (;;) {
+      if (cur >= key) {
+        *p_key = cur;
+        return idx;
+      }
+      if (++idx == end) break;
+      cur += _zda_varint_decode(&pos);
+    }
+  }
+
+  if (blk < snap->nblk) *p_key = snap->blk_keys[blk];
+  return zda_min(blk * ZDA_TREE_SNAPSHOT_BLOCK, snap->cnt);
+}
+
+size_t zda_tree_snapshot_lower_bound(zda_tree_snapshot_t const *snap, uint64_t key) zda_noexcept
+{
+  uint64_t found_key;
+  return _zda_tree_snapshot_lower_bound(snap, key, &found_key);
+}
+
+zda_tree_record_t zda_tree_snapshot_search(zda_tree_snapshot_t const *snap, uint64_t key)
+    zda_noexcept
+{
+  uint64_t          found_key;
+  size_t const      idx = _zda_tree_snapshot_lower_bound(snap, key, &found_key);
+  zda_tree_record_t ret;
+
+  if (idx < snap->cnt && found_key == key) return zda_tree_snapshot_get_record(snap, idx);
+  ret.data = NULL;
+  ret.len  = 0;
+  return ret;
+}
+
+/************************************/
+/* Cursor */
+/************************************/
+void zda_tree_snapshot_cursor_seek(
+    zda_tree_snapshot_cursor_t *cursor,
+    zda_tree_snapshot_t const  *snap,
+    size_t                      idx
+) zda_noexcept
+{
+  cursor->snap = snap;
+  cursor->idx  = idx;
+  cursor->key  = 0;
+  cursor->pos  = NULL;
+  if (idx >= snap->cnt) return;
+
+  if (snap->flags & ZDA_TREE_SNAPSHOT_DELTA) {
+    size_t const blk = idx / ZDA_TREE_SNAPSHOT_BLOCK;
+    cursor->pos      = _zda_tree_snapshot_block_deltas(snap, blk);
+    cursor->key      = snap->blk_keys[blk];
+    for (size_t i = idx % ZDA_TREE_SNAPSHOT_BLOCK; i > 0; --i)
+      cursor->key += _zda_varint_decode(&cursor->pos);
+  } else {
+    cursor->key = snap->keys[idx];
+  }
+}
+
+void zda_tree_snapshot_cursor_next(zda_tree_snapshot_cursor_t *cursor) zda_noexcept
+{
+  zda_tree_snapshot_t const *snap = cursor->snap;
+  size_t const               idx  = ++cursor->idx;
+
+  if (idx >= snap->cnt) return;
+  if (!(snap->flags & ZDA_TREE_SNAPSHOT_DELTA)) {
+    cursor->key = snap->keys[idx];
+  } else if (idx % ZDA_TREE_SNAPSHOT_BLOCK == 0) {
+    cursor->pos = _zda_tree_snapshot_block_deltas(snap, idx / ZDA_TREE_SNAPSHOT_BLOCK);
+    cursor->key = snap->blk_keys[idx / ZDA_TREE_SNAPSHOT_BLOCK];
+  } else {
+    cursor->key += _zda_varint_decode(&cursor->pos);
+  }
+}
+
+/************************************/
+/* Reload */
+/************************************/
+int zda_rb_tree_snapshot_load(
+    zda_rb_tree_t                 *tree,
+    zda_tree_snapshot_t const     *snap,
+    zda_rb_tree_snapshot_load_cb_t load_cb,
+    zda_rb_free_t                  free_cb,
+    void                          *ctx
+) zda_noexcept
+{
+  zda_tree_snapshot_cursor_t cursor;
+  zda_rb_node_t            **nodes;
+
+  if (zda_tree_snapshot_is_empty(snap)) return 0;
+  nodes = (zda_rb_node_t **)malloc(snap->cnt * sizeof(zda_rb_node_t *));
+  if (!nodes) return -1;
+
+  zda_tree_snapshot_iterate(snap, cursor)
+  {
+    zda_tree_record_t const rec = zda_tree_snapshot_cursor_get_record(&cursor);
+    if (!(nodes[cursor.idx] = load_cb(cursor.key, &rec, ctx))) {
+      for (size_t i = 0; i < cursor.idx; ++i)
+        free_cb(nodes[i]);
+      free(nodes);
+      return -1;
+    }
+  }
+
+  zda_rb_tree_build_sorted(tree, nodes, snap->cnt);
+  free(nodes);
+  return 0;
+}
+
+int zda_avl_tree_snapshot_load(
+    zda_avl_tree_t                 *tree,
+    zda_tree_snapshot_t const      *snap,
+    zda_avl_tree_snapshot_load_cb_t load_cb,
+    zda_avl_free_t                  free_cb,
+    void                           *ctx
+) zda_noexcept
+{
+  zda_tree_snapshot_cursor_t cursor;
+  zda_avl_node_t           **nodes;
+
+  if (zda_tree_snapshot_is_empty(snap)) return 0;
+  nodes = (zda_avl_node_t **)malloc(snap->cnt * sizeof(zda_avl_node_t *));
+  if (!nodes) return -1;
+
+  zda_tree_snapshot_iterate(snap, cursor)
+  {
+    zda_tree_record_t const rec = zda_tree_snapshot_cursor_get_record(&cursor);
+    if (!(nodes[cursor.idx] = load_cb(cursor.key, &rec, ctx))) {
+      for (size_t i = 0; i < cursor.idx; ++i)
+        free_cb(nodes[i]);
+      free(nodes);
+      return -1;
+    }
+  }
+
+  zda_avl_tree_build_sorted(tree, nodes, snap->cnt);
+  free(nodes);
+  return 0;
+}
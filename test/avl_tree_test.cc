@@ -120,3 +120,27 @@ TEST(avl_tree_test, remove)
     free(entry);
   }
 }
+
+TEST(avl_tree_test, random_remove)
+{
+  static_assert(sizeof(zda_avl_node_t) == 3 * sizeof(void *), "The balance factor should be packed");
+
+  zda_avl_tree_t tree;
+  prepare_avl_tree(&tree, 1000);
+
+  srand(0);
+  int keys[1000];
+  for (int i = 0; i < 1000; ++i)
+    keys[i] = i;
+  for (int i = 999; i > 0; --i)
+    std::swap(keys[i], keys[rand() % (i + 1)]);
+
+  for (int i = 0; i < 1000; ++i) {
+    auto entry = avl_tree_remove_int_entry(&tree, keys[i]);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->key, keys[i]);
+    free(entry);
+    ASSERT_TRUE(zda_avl_tree_verify_properties(&tree)) << "i = " << i;
+  }
+  EXPECT_TRUE(zda_avl_tree_is_empty(&tree));
+}
@@ -0,0 +1,149 @@
+#include "zda/cord.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace zda;
+
+static std::string chunks_to_string(Cord const &cord)
+{
+    std::string ret;
+    cord.for_each_chunk([&ret](StringView chunk) {
+        ret.append(chunk.data(), chunk.size());
+    });
+    return ret;
+}
+
+TEST(CordTest, append)
+{
+    Cord cord;
+    EXPECT_TRUE(cord.is_empty());
+
+    cord.append(StringViewLiteral("abc"));
+    cord.append(StringViewLiteral("def"));
+    /* The small fragments are packed into the tail buffer */
+    EXPECT_EQ(cord.chunk_count(), 1);
+    EXPECT_EQ(cord, StringViewLiteral("abcdef"));
+
+    static char const borrowed[] = "0123456789";
+    cord.append_borrowed(StringView(borrowed, 5));
+    cord.append_borrowed(StringView(borrowed + 5, 5));
+    /* The adjacent borrowed fragments are merged */
+    EXPECT_EQ(cord.chunk_count(), 2);
+    EXPECT_EQ(cord.chunk(1).data(), borrowed);
+
+    std::string large(Cord::MOVE_THRESHOLD, 'x');
+    char const *large_data = large.data();
+    cord.append(std::move(large));
+    EXPECT_EQ(cord.chunk_count(), 3);
+    EXPECT_EQ(cord.chunk(2).data(), large_data);
+
+    cord.append(StringViewLiteral("!"));
+    EXPECT_EQ(cord.size(), 6 + 10 + Cord::MOVE_THRESHOLD + 1);
+    EXPECT_EQ(cord.to_string(), "abcdef0123456789" + std::string(Cord::MOVE_THRESHOLD, 'x') + "!");
+    EXPECT_EQ(chunks_to_string(cord), cord.to_string());
+}
+
+TEST(CordTest, prepend)
+{
+    Cord cord(StringViewLiteral("world"));
+    cord.prepend(StringViewLiteral(", "));
+    cord.prepend_borrowed(StringViewLiteral("hello"));
+    EXPECT_EQ(cord, StringViewLiteral("hello, world"));
+
+    Cord other(StringViewLiteral(">> "));
+    cord.prepend(other);
+    cord.append(other);
+    cord.prepend(cord);
+    EXPECT_EQ(cord.to_string(), ">> hello, world>> >> hello, world>> ");
+}
+
+TEST(CordTest, share)
+{
+    Cord a(StringViewLiteral("shared"));
+    Cord b(a);
+    /* The buffer is shared, so appending to it makes a new chunk */
+    b.append(StringViewLiteral("!"));
+    EXPECT_EQ(a, StringViewLiteral("shared"));
+    EXPECT_EQ(b, StringViewLiteral("shared!"));
+    EXPECT_EQ(b.chunk_count(), 2);
+    EXPECT_EQ(a.chunk(0).data(), b.chunk(0).data());
+
+    Cord c;
+    c.append(std::move(b));
+    EXPECT_TRUE(b.is_empty());
+    c.append(c);
+    EXPECT_EQ(c, StringViewLiteral("shared!shared!"));
+
+    a = c;
+    c.clear();
+    EXPECT_EQ(a, StringViewLiteral("shared!shared!"));
+}
+
+TEST(CordTest, substr_remove)
+{
+    Cord cord;
+    for (int i = 0; i < 10; ++i) {
+        cord.append(std::string(Cord::MOVE_THRESHOLD, (char)('0' + i)));
+    }
+    std::string const expect = cord.to_string();
+
+    auto sub = cord.substr(Cord::MOVE_THRESHOLD - 1, Cord::MOVE_THRESHOLD * 2);
+    EXPECT_EQ(sub.to_string(), expect.substr(Cord::MOVE_THRESHOLD - 1, Cord::MOVE_THRESHOLD * 2));
+    EXPECT_EQ(sub.chunk_count(), 3);
+    EXPECT_TRUE(cord.substr(expect.size(), 1).is_empty());
+    EXPECT_EQ(cord.substr(10, std::string::npos).size(), expect.size() - 10);
+
+    cord.remove_prefix(Cord::MOVE_THRESHOLD + 3);
+    cord.remove_suffix(Cord::MOVE_THRESHOLD * 2 + 1);
+    EXPECT_EQ(cord.to_string(),
+              expect.substr(Cord::MOVE_THRESHOLD + 3,
+                            expect.size() - Cord::MOVE_THRESHOLD * 3 - 4));
+    cord.remove_prefix(expect.size());
+    EXPECT_TRUE(cord.is_empty());
+    EXPECT_EQ(cord.chunk_count(), 0);
+}
+
+TEST(CordTest, iovec_flatten)
+{
+    Cord cord;
+    std::string expect;
+    std::mt19937 rng(12);
+
+    for (int i = 0; i < 100; ++i) {
+        std::string piece(rng() % 1000, (char)('a' + i % 26));
+        expect += piece;
+        if (i % 3 == 0)
+            cord.append(std::move(piece));
+        else
+            cord.append(StringView(piece));
+    }
+    EXPECT_EQ(cord, StringView(expect));
+
+    /* Consume the cord as writev() does */
+    std::string out;
+    struct iovec iov[4];
+    while (!cord.is_empty()) {
+        size_t const n = cord.to_iovec(iov, 4);
+        size_t written = 0;
+        for (size_t i = 0; i < n; ++i) {
+            size_t const len = iov[i].iov_len / 2 + 1;
+            out.append((char const *)iov[i].iov_base, len);
+            written += len;
+            if (len != iov[i].iov_len) break;
+        }
+        cord.remove_prefix(written);
+    }
+    EXPECT_EQ(out, expect);
+
+    Cord cord2{StringView(expect)};
+    cord2.prepend(StringViewLiteral("head"));
+    auto view = cord2.flatten();
+    EXPECT_EQ(cord2.chunk_count(), 1);
+    EXPECT_EQ(std::string(view.data(), view.size()), "head" + expect);
+
+    char buf[8];
+    EXPECT_EQ(cord2.copy_to(buf, sizeof buf), sizeof buf);
+    EXPECT_EQ(std::string(buf, 8), "head" + expect.substr(0, 4));
+}
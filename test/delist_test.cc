@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 typedef struct int_entry {
     int               key;
     zda_delist_node_t node;
@@ -55,3 +57,61 @@ TEST(delist_test, pop_front)
     zda_delist_destroy_inplace(&dl, int_entry_t, free);
 }
 
+#define int_entry_cmp(lhs, rhs) ((lhs)->key - (rhs)->key)
+#define int_entry_key(entry)    ((uint32_t)(entry)->key)
+
+static int int_node_cmp(zda_delist_node_t const *lhs, zda_delist_node_t const *rhs)
+{
+    return int_entry_cmp(
+        zda_delist_entry(lhs, int_entry_t const),
+        zda_delist_entry(rhs, int_entry_t const)
+    );
+}
+
+static uint64_t int_node_key(zda_delist_node_t const *node)
+{
+    return int_entry_key(zda_delist_entry(node, int_entry_t const));
+}
+
+TEST(delist_test, sort)
+{
+    for (int n : {0, 1, 2, 100}) {
+        for (int method = 0; method < 4; ++method) {
+            std::vector<int_entry_t> entries(n + 1);
+            zda_delist_t             dl;
+            zda_delist_init(&dl);
+            for (int i = 0; i < n; ++i) {
+                entries[i].key = (i * 37) % n;
+                zda_delist_push_back(&dl, &entries[i].node);
+            }
+
+            switch (method) {
+            case 0:
+                zda_delist_sort_inplace(&dl, int_entry_t, int_entry_cmp);
+                break;
+            case 1:
+                zda_delist_sort(&dl, int_node_cmp);
+                break;
+            case 2:
+                zda_delist_radix_sort_inplace(&dl, int_entry_t, int_entry_key);
+                break;
+            case 3:
+                zda_delist_radix_sort(&dl, int_node_key);
+                break;
+            }
+
+            /* The tail is updated */
+            entries[n].key = n;
+            zda_delist_push_back(&dl, &entries[n].node);
+            EXPECT_EQ(zda_delist_back(&dl), &entries[n].node);
+
+            int i = 0;
+            zda_delist_iterate(&dl)
+            {
+                EXPECT_EQ(zda_delist_entry(pos, int_entry_t)->key, i);
+                ++i;
+            }
+            EXPECT_EQ(i, n + 1);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include <zda/dj_set_array.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+TEST(dj_set_array_test, union_find)
+{
+  zda_dj_set_array_t set;
+  ASSERT_TRUE(zda_dj_set_array_init(&set, 10));
+
+  EXPECT_NE(zda_dj_set_array_union(&set, 0, 1), ZDA_DJ_SET_ARRAY_NONE);
+  EXPECT_NE(zda_dj_set_array_union(&set, 2, 3), ZDA_DJ_SET_ARRAY_NONE);
+  EXPECT_NE(zda_dj_set_array_union(&set, 1, 3), ZDA_DJ_SET_ARRAY_NONE);
+  EXPECT_EQ(zda_dj_set_array_union(&set, 0, 2), ZDA_DJ_SET_ARRAY_NONE);
+
+  EXPECT_TRUE(zda_dj_set_array_same(&set, 0, 3));
+  EXPECT_FALSE(zda_dj_set_array_same(&set, 0, 4));
+  EXPECT_EQ(zda_dj_set_array_find(&set, 2), zda_dj_set_array_find(&set, 1));
+
+  zda_dj_set_array_destroy(&set);
+}
+
+TEST(dj_set_array_test, flatten)
+{
+  const uint32_t     n = 1000;
+  zda_dj_set_array_t set;
+  ASSERT_TRUE(zda_dj_set_array_init(&set, n));
+
+  /* Connect i and i + 10 for the i % 10 < 5, the others are singleton */
+  std::vector<uint32_t> edges;
+  for (uint32_t i = 0; i + 10 < n; ++i) {
+    if (i % 10 < 5) {
+      edges.push_back(i + 10);
+      edges.push_back(i);
+    }
+  }
+  std::mt19937 rng(0);
+  for (size_t i = edges.size() / 2; i > 1; --i) {
+    size_t j = rng() % i;
+    std::swap(edges[2 * (i - 1)], edges[2 * j]);
+    std::swap(edges[2 * (i - 1) + 1], edges[2 * j + 1]);
+  }
+
+  EXPECT_EQ(zda_dj_set_array_union_edges(&set, edges.data(), edges.size() / 2), edges.size() / 2);
+  /* The duplicate edges don't merge */
+  EXPECT_EQ(zda_dj_set_array_union_edges(&set, edges.data(), edges.size() / 2), 0);
+
+  std::vector<uint32_t> ids(n);
+  uint32_t              count = zda_dj_set_array_flatten(&set, ids.data());
+  EXPECT_EQ(count, 5 + (n / 10) * 5);
+
+  /* The id is numbered by the first element */
+  for (uint32_t i = 0; i < 10; ++i)
+    EXPECT_EQ(ids[i], i);
+  for (uint32_t i = 0; i < n; ++i) {
+    if (i % 10 < 5) {
+      EXPECT_EQ(ids[i], i % 10);
+    } else {
+      EXPECT_EQ(ids[i], 5 + (i / 10) * 5 + (i % 10 - 5)) << i;
+    }
+    EXPECT_EQ(set.parent[set.parent[i]], set.parent[i]);
+  }
+
+  zda_dj_set_array_destroy(&set);
+}
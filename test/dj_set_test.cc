@@ -0,0 +1,129 @@
+#include <zda/dj_set.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+/* Use a flat label array as the reference */
+static void relabel(std::vector<int> &labels, int from, int to)
+{
+  for (auto &label : labels)
+    if (label == from) label = to;
+}
+
+TEST(dj_set_test, union_rank)
+{
+  const int                      n = 200;
+  std::vector<zda_dj_set_node_t> nodes(n);
+  std::vector<int>               labels(n);
+  for (int i = 0; i < n; ++i) {
+    zda_dj_set_init(&nodes[i]);
+    labels[i] = i;
+  }
+
+  std::mt19937 rng(0);
+  for (int k = 0; k < 150; ++k) {
+    int x = rng() % n, y = rng() % n;
+    auto root = zda_dj_set_union(&nodes[x], &nodes[y]);
+    EXPECT_EQ(root == NULL, labels[x] == labels[y]);
+    if (root) {
+      EXPECT_EQ(root, zda_dj_set_find(&nodes[x]));
+    }
+    relabel(labels, labels[y], labels[x]);
+  }
+
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; j += 7) {
+      EXPECT_EQ(zda_dj_set_same(&nodes[i], &nodes[j]), labels[i] == labels[j]);
+    }
+  }
+}
+
+TEST(dj_set_test, union_size)
+{
+  const int                      n = 200;
+  std::vector<zda_dj_set_node_t> nodes(n);
+  std::vector<int>               labels(n);
+  for (int i = 0; i < n; ++i) {
+    zda_dj_set_init_size(&nodes[i]);
+    labels[i] = i;
+  }
+
+  std::mt19937 rng(1);
+  for (int k = 0; k < 150; ++k) {
+    int x = rng() % n, y = rng() % n;
+    zda_dj_set_union_size(&nodes[x], &nodes[y]);
+    relabel(labels, labels[y], labels[x]);
+  }
+
+  for (int i = 0; i < n; ++i) {
+    size_t size = std::count(labels.begin(), labels.end(), labels[i]);
+    EXPECT_EQ(zda_dj_set_get_size(&nodes[i]), size);
+  }
+}
+
+TEST(dj_set_test, compress)
+{
+  /* Build a chain manually: nodes[i]->parent = nodes[i + 1] */
+  const int         n = 64;
+  zda_dj_set_node_t nodes[n];
+  for (int i = 0; i < n; ++i) {
+    zda_dj_set_init(&nodes[i]);
+    if (i > 0) nodes[i - 1].parent = &nodes[i];
+  }
+
+  zda_dj_set_node_t *root = &nodes[n - 1];
+  EXPECT_EQ(zda_dj_set_find(&nodes[0]), root);
+  EXPECT_EQ(nodes[0].parent, &nodes[1]);
+
+  EXPECT_EQ(zda_dj_set_find_halving(&nodes[0]), root);
+  EXPECT_EQ(nodes[0].parent, &nodes[2]);
+  EXPECT_EQ(zda_dj_set_find_splitting(&nodes[1]), root);
+  /* nodes[2] has been linked to nodes[4] by the halving */
+  EXPECT_EQ(nodes[1].parent, &nodes[4]);
+
+  /* The path length is halved for each find */
+  for (int i = 0; i < 8; ++i)
+    EXPECT_EQ(zda_dj_set_find_halving(&nodes[0]), root);
+  EXPECT_EQ(nodes[0].parent, root);
+
+  for (int i = 0; i < n; ++i)
+    EXPECT_EQ(zda_dj_set_find_splitting(&nodes[i]), root);
+}
+
+TEST(dj_set_test, concurrent_union)
+{
+  const int                      n = 1 << 16;
+  const int                      nthread = 4;
+  std::vector<zda_dj_set_node_t> nodes(n);
+  for (auto &node : nodes)
+    zda_dj_set_init(&node);
+
+  /* Every thread unions i and i + stride for the i of its part,
+   * then the nodes that congruent modulo 4 are in the same set. */
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthread; ++t) {
+    threads.emplace_back([&nodes, t]() {
+      std::mt19937 rng(t);
+      for (int k = 0; k < n; ++k) {
+        int i = rng() % (n - 4);
+        zda_dj_set_cunion(&nodes[i], &nodes[i + 4]);
+        zda_dj_set_csame(&nodes[i], &nodes[rng() % n]);
+      }
+      for (int i = t; i < n - 4; i += nthread)
+        zda_dj_set_cunion(&nodes[i], &nodes[i + 4]);
+    });
+  }
+  for (auto &thr : threads)
+    thr.join();
+
+  for (int i = 0; i < n; ++i) {
+    EXPECT_TRUE(zda_dj_set_csame(&nodes[i], &nodes[i % 4]));
+    EXPECT_EQ(zda_dj_set_cfind(&nodes[i]), zda_dj_set_find(&nodes[i % 4]));
+  }
+  for (int i = 1; i < 4; ++i)
+    EXPECT_FALSE(zda_dj_set_csame(&nodes[0], &nodes[i]));
+}
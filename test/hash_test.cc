@@ -0,0 +1,84 @@
+#include "zda/hash.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace zda;
+
+TEST(HashTest, bytes)
+{
+    std::mt19937_64 rng(41);
+    std::string data(5000, 0);
+    for (auto &c : data)
+        c = (char)rng();
+
+    /* All prefixes cover the short, medium and long paths */
+    std::unordered_set<uint64_t> hashes;
+    for (size_t len = 0; len <= data.size(); ++len) {
+        uint64_t const h = zda_hash_bytes(data.data(), len, 0);
+        EXPECT_TRUE(hashes.insert(h).second) << len;
+        EXPECT_EQ(h, zda_hash_bytes(std::string(data, 0, len).data(), len, 0));
+    }
+
+    /* The seed and every byte affect the result */
+    for (size_t len : {1, 3, 4, 8, 15, 16, 17, 48, 49, 100, 256, 257, 1024, 1025, 5000}) {
+        uint64_t const h = zda_hash_bytes(data.data(), len, 0);
+        EXPECT_NE(h, zda_hash_bytes(data.data(), len, 1));
+        for (size_t i = 0; i < len; i += 1 + len / 16) {
+            std::string copy(data, 0, len);
+            copy[i] ^= 1;
+            EXPECT_NE(h, zda_hash_bytes(copy.data(), len, 0)) << len << " " << i;
+        }
+    }
+
+    /* Swapping two stripes of the long input changes the hash */
+    std::string swapped = data;
+    std::swap_ranges(&swapped[0], &swapped[64], &swapped[64]);
+    EXPECT_NE(zda_hash_bytes(data.data(), 1000, 0), zda_hash_bytes(swapped.data(), 1000, 0));
+}
+
+TEST(HashTest, integer)
+{
+    /* The sequential keys spread over the buckets masked by the low bits */
+    size_t const mask = 1023;
+    std::vector<int> buckets(mask + 1);
+    for (uint64_t i = 0; i < 1024 * 16; ++i)
+        ++buckets[Hash<uint64_t>()(i << 12) & mask];
+    for (int count : buckets) {
+        EXPECT_GT(count, 0);
+        EXPECT_LT(count, 48);
+    }
+
+    EXPECT_NE(zda_hash_u64(0), zda_hash_u64(1));
+    EXPECT_EQ(zda_hash_u32(7), zda_hash_u64(7));
+    EXPECT_NE(zda_hash_combine(1, 2), zda_hash_combine(2, 1));
+
+    int x;
+    EXPECT_EQ(Hash<int *>()(&x), Hash<int *>()(&x));
+    EXPECT_EQ(Hash<double>()(0.0), Hash<double>()(-0.0));
+    EXPECT_NE(Hash<double>()(1.0), Hash<double>()(2.0));
+}
+
+TEST(HashTest, string)
+{
+    std::string const str = "Accept-Encoding";
+    size_t const h = Hash<std::string>()(str);
+
+    EXPECT_EQ(h, Hash<StringView>()(StringView(str)));
+    EXPECT_EQ(h, Hash<std::string_view>()(std::string_view(str)));
+    EXPECT_EQ(h, zda_hash_str(str.c_str()));
+    zda_string_view_t view;
+    zda_string_view_init(&view, str.data(), str.size());
+    EXPECT_EQ(h, Hash<zda_string_view_t>()(view));
+
+    std::unordered_map<StringView, int, Hash<StringView>> map;
+    map.emplace(StringViewLiteral("a"), 1);
+    map.emplace(StringViewLiteral("b"), 2);
+    EXPECT_EQ(map.at(StringViewLiteral("b")), 2);
+}
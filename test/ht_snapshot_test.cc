@@ -0,0 +1,164 @@
+#include "zda/ht_snapshot.h"
+#include "zda/hash.h"
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+typedef struct str_entry {
+  std::string   key;
+  uint32_t      value;
+  zda_ht_node_t node;
+} str_entry_t;
+
+/* Record layout: | value(uint32_t) | key bytes | */
+typedef struct str_record {
+  uint32_t value;
+  char     key[];
+} str_record_t;
+
+static zda_inline zda_string_view_t str_entry_get_key(str_entry_t const *entry) noexcept
+{
+  zda_string_view_t ret;
+  zda_string_view_init(&ret, entry->key.data(), entry->key.size());
+  return ret;
+}
+
+static zda_inline zda_string_view_t str_record_get_key(zda_ht_record_t const *rec) noexcept
+{
+  zda_string_view_t ret;
+  zda_string_view_init(&ret, ((str_record_t const *)rec->data)->key, rec->len - sizeof(uint32_t));
+  return ret;
+}
+
+static zda_inline size_t str_hash(zda_string_view_t key) noexcept
+{
+  return zda_hash_string_view(&key);
+}
+
+static zda_inline zda_bool str_equal(zda_string_view_t x, zda_string_view_t y) noexcept
+{
+  return x.len == y.len && memcmp(x.data, y.data, x.len) == 0;
+}
+
+static size_t str_entry_serialize(zda_ht_node_t const *node, void *buf, size_t n, void *)
+{
+  auto const  *entry = zda_ht_entry(node, str_entry_t const);
+  size_t const len   = sizeof(uint32_t) + entry->key.size();
+
+  if (len <= n) {
+    auto *rec  = (str_record_t *)buf;
+    rec->value = entry->value;
+    memcpy(rec->key, entry->key.data(), entry->key.size());
+  }
+  return len;
+}
+
+static zda_def_ht_insert_check(
+    str_insert_check,
+    zda_string_view_t,
+    str_entry_t,
+    str_entry_get_key,
+    str_hash,
+    str_equal
+)
+
+static zda_def_ht_search(str_search, zda_string_view_t, str_entry_t, str_entry_get_key, str_hash, str_equal)
+
+static zda_def_ht_snapshot_search(
+    str_snapshot_search,
+    zda_string_view_t,
+    str_record_get_key,
+    str_hash,
+    str_equal
+)
+
+static void str_entry_free(str_entry_t *entry) { delete entry; }
+
+static zda_def_ht_destroy(str_ht_destroy, str_entry_t, str_entry_free)
+
+static zda_string_view_t make_key(std::string const &str)
+{
+  zda_string_view_t ret;
+  zda_string_view_init(&ret, str.data(), str.size());
+  return ret;
+}
+
+TEST(ht_snapshot_test, write_open)
+{
+  zda_ht_t ht;
+  zda_ht_init(&ht);
+
+  int const n = 10000;
+  for (int i = 0; i < n; ++i) {
+    auto *entry  = new str_entry_t;
+    /* Vary the key length to exercise the record padding */
+    entry->key   = "key" + std::to_string(i) + std::string(i % 13, '#');
+    entry->value = (uint32_t)i * 7;
+
+    zda_ht_commit_ctx_t ctx;
+    ASSERT_EQ(str_insert_check(&ht, make_key(entry->key), &ctx), nullptr);
+    zda_ht_insert_commit(&ht, &ctx, &entry->node);
+  }
+
+  char path[] = "/tmp/zda_ht_snapshot_XXXXXX";
+  int  fd     = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  FILE *fp = fdopen(fd, "w+b");
+  ASSERT_EQ(zda_ht_snapshot_write(&ht, fp, str_entry_serialize, NULL), 0);
+  fclose(fp);
+
+  zda_ht_snapshot_t snap;
+  ASSERT_EQ(zda_ht_snapshot_open(&snap, path), 0);
+  unlink(path);
+  EXPECT_EQ(zda_ht_snapshot_get_count(&snap), (size_t)n);
+
+  for (int i = 0; i < n; ++i) {
+    std::string const key = "key" + std::to_string(i) + std::string(i % 13, '#');
+    auto const        rec = str_snapshot_search(&snap, make_key(key));
+    ASSERT_NE(rec.data, nullptr) << key;
+    EXPECT_EQ(((str_record_t const *)rec.data)->value, (uint32_t)i * 7);
+    EXPECT_EQ(((uintptr_t)rec.data & 7), 0u);
+    EXPECT_EQ(str_search(&ht, make_key(key))->value, (uint32_t)i * 7);
+  }
+
+  std::string const missing = "key" + std::to_string(n);
+  EXPECT_EQ(str_snapshot_search(&snap, make_key(missing)).data, nullptr);
+
+  size_t          cnt = 0;
+  zda_ht_record_t rec;
+  zda_ht_snapshot_iterate(&snap, rec) { ++cnt; }
+  EXPECT_EQ(cnt, (size_t)n);
+
+  zda_ht_snapshot_close(&snap);
+  str_ht_destroy(&ht);
+}
+
+TEST(ht_snapshot_test, invalid)
+{
+  zda_ht_t ht;
+  zda_ht_init(&ht);
+
+  /* The empty table is valid */
+  FILE *fp = tmpfile();
+  ASSERT_EQ(zda_ht_snapshot_write(&ht, fp, str_entry_serialize, NULL), 0);
+  long const size = ftell(fp);
+  std::vector<uint64_t> buf((size + 7) / 8);
+  rewind(fp);
+  ASSERT_EQ(fread(buf.data(), 1, size, fp), (size_t)size);
+  fclose(fp);
+
+  zda_ht_snapshot_t snap;
+  ASSERT_EQ(zda_ht_snapshot_init(&snap, buf.data(), size), 0);
+  EXPECT_TRUE(zda_ht_snapshot_is_empty(&snap));
+  EXPECT_EQ(str_snapshot_search(&snap, make_key("a")).data, nullptr);
+
+  EXPECT_EQ(zda_ht_snapshot_init(&snap, buf.data(), size - 1), -1);
+  ((char *)buf.data())[0] = 'X';
+  EXPECT_EQ(zda_ht_snapshot_init(&snap, buf.data(), size), -1);
+  EXPECT_EQ(zda_ht_snapshot_open(&snap, "/nonexistent/zda_snapshot"), -1);
+}
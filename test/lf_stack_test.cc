@@ -0,0 +1,117 @@
+#include "zda/lf_stack.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+typedef struct int_entry {
+    int                 key;
+    std::atomic<int>    owned;
+    zda_slist_node_t    node;
+} int_entry_t;
+
+TEST(lf_stack_test, push_pop)
+{
+    zda_lf_stack_t stk;
+    zda_lf_stack_init(&stk);
+    EXPECT_TRUE(zda_lf_stack_is_empty(&stk));
+    EXPECT_EQ(zda_lf_stack_pop(&stk), nullptr);
+
+    std::vector<int_entry_t> entries(10);
+    for (int i = 0; i < 10; ++i) {
+        entries[i].key = i;
+        zda_lf_stack_push(&stk, &entries[i].node);
+    }
+    EXPECT_FALSE(zda_lf_stack_is_empty(&stk));
+
+    for (int i = 9; i >= 5; --i) {
+        auto *node = zda_lf_stack_pop(&stk);
+        ASSERT_NE(node, nullptr);
+        EXPECT_EQ(zda_slist_entry(node, int_entry_t)->key, i);
+    }
+
+    /* Push a chain */
+    entries[5].node.next = &entries[6].node;
+    entries[6].node.next = &entries[7].node;
+    zda_lf_stack_push_chain(&stk, &entries[5].node, &entries[7].node);
+
+    zda_slist_t list;
+    EXPECT_TRUE(zda_lf_stack_pop_all(&stk, &list));
+    EXPECT_TRUE(zda_lf_stack_is_empty(&stk));
+
+    int const expect[] = {5, 6, 7, 4, 3, 2, 1, 0};
+    int       i        = 0;
+    zda_slist_iterate(&list)
+    {
+        ASSERT_LT(i, 8);
+        EXPECT_EQ(zda_slist_entry(pos, int_entry_t)->key, expect[i++]);
+    }
+    EXPECT_EQ(i, 8);
+
+    EXPECT_FALSE(zda_lf_stack_pop_all(&stk, &list));
+    EXPECT_TRUE(zda_slist_is_empty(&list));
+}
+
+/* The threads pop and push the same nodes repeatedly, this is the case causing ABA problem.
+ * If a node is popped twice without push, the ownership check fails. */
+TEST(lf_stack_test, concurrent)
+{
+    const int nthread = 4;
+    const int nnode   = 16;
+    const int n       = 200000;
+
+    zda_lf_stack_t stk;
+    zda_lf_stack_init(&stk);
+
+    std::vector<int_entry_t> entries(nnode);
+    for (int i = 0; i < nnode; ++i) {
+        entries[i].key   = i;
+        entries[i].owned = 0;
+        zda_lf_stack_push(&stk, &entries[i].node);
+    }
+
+    std::atomic<int>         errors(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthread; ++t) {
+        threads.emplace_back([&stk, &errors, t]() {
+            zda_slist_node_t *held[2];
+            for (int k = 0; k < n; ++k) {
+                int cnt = 0;
+                for (; cnt < 2; ++cnt) {
+                    held[cnt] = zda_lf_stack_pop(&stk);
+                    if (!held[cnt]) break;
+                    auto *entry = zda_slist_entry(held[cnt], int_entry_t);
+                    if (entry->owned.exchange(1) != 0) ++errors;
+                }
+                while (cnt > 0) {
+                    auto *entry = zda_slist_entry(held[--cnt], int_entry_t);
+                    entry->owned = 0;
+                    zda_lf_stack_push(&stk, held[cnt]);
+                }
+                if (t == 0 && k % 1000 == 0) {
+                    /* Take all and give back */
+                    zda_slist_t list;
+                    if (zda_lf_stack_pop_all(&stk, &list)) {
+                        zda_slist_node_t *last = list.node.next;
+                        while (last->next)
+                            last = last->next;
+                        zda_lf_stack_push_chain(&stk, list.node.next, last);
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thr : threads)
+        thr.join();
+
+    EXPECT_EQ(errors.load(), 0);
+
+    std::vector<int> seen(nnode, 0);
+    zda_slist_node_t *node;
+    while ((node = zda_lf_stack_pop(&stk)) != nullptr)
+        ++seen[zda_slist_entry(node, int_entry_t)->key];
+    for (int i = 0; i < nnode; ++i)
+        EXPECT_EQ(seen[i], 1);
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 typedef struct int_node {
   int             val;
   zda_list_node_t node;
@@ -106,4 +108,62 @@ TEST(list_test2, search)
     EXPECT_EQ(p_entry->val, i);
   }
   zda_list_destroy2(&header, int_node_t, free);
-}
\ No newline at end of file
+}
+
+#define int_node_cmp(lhs, rhs) ((lhs)->val - (rhs)->val)
+#define int_node_key(entry)    ((uint32_t)(entry)->val)
+
+static int int_list_node_cmp(zda_list_node_t const *lhs, zda_list_node_t const *rhs)
+{
+  return int_node_cmp(zda_list_entry(lhs, int_node_t const), zda_list_entry(rhs, int_node_t const));
+}
+
+static uint64_t int_list_node_key(zda_list_node_t const *node)
+{
+  return int_node_key(zda_list_entry(node, int_node_t const));
+}
+
+TEST(list_test, sort)
+{
+  for (int n : {0, 1, 2, 100}) {
+    for (int method = 0; method < 4; ++method) {
+      std::vector<int_node_t> nodes(n);
+      zda_list_header_t       header;
+      zda_list_header_init(&header);
+      for (int i = 0; i < n; ++i) {
+        nodes[i].val = (i * 37) % n;
+        zda_list_push_back(&header, &nodes[i].node);
+      }
+
+      switch (method) {
+      case 0:
+        zda_list_sort_inplace(&header, int_node_t, int_node_cmp);
+        break;
+      case 1:
+        zda_list_sort(&header, int_list_node_cmp);
+        break;
+      case 2:
+        zda_list_radix_sort_inplace(&header, int_node_t, int_node_key);
+        break;
+      case 3:
+        zda_list_radix_sort(&header, int_list_node_key);
+        break;
+      }
+
+      int i = 0;
+      zda_list_iterate(&header)
+      {
+        EXPECT_EQ(zda_list_entry(pos, int_node_t)->val, i);
+        ++i;
+      }
+      EXPECT_EQ(i, n);
+
+      /* The prev links are rebuilt */
+      for (zda_list_node_t *pos = header.node.prev; pos != &header.node; pos = pos->prev) {
+        EXPECT_EQ(zda_list_entry(pos, int_node_t)->val, --i);
+      }
+      EXPECT_EQ(i, 0);
+      EXPECT_EQ(zda_list_is_empty(&header), n == 0);
+    }
+  }
+}
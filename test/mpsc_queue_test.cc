@@ -0,0 +1,127 @@
+#include "zda/mpsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+typedef struct int_entry {
+    int               producer;
+    int               key;
+    zda_delist_node_t node;
+} int_entry_t;
+
+TEST(mpsc_queue_test, push_pop)
+{
+    zda_mpsc_queue_t q;
+    zda_mpsc_queue_init(&q);
+    EXPECT_TRUE(zda_mpsc_queue_is_empty(&q));
+    EXPECT_EQ(zda_mpsc_queue_pop(&q), nullptr);
+
+    std::vector<int_entry_t> entries(10);
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 10; ++i) {
+            entries[i].key = i;
+            zda_mpsc_queue_push(&q, &entries[i].node);
+            EXPECT_FALSE(zda_mpsc_queue_is_empty(&q));
+        }
+
+        for (int i = 0; i < 10; ++i) {
+            auto *node = zda_mpsc_queue_pop(&q);
+            ASSERT_NE(node, nullptr);
+            EXPECT_EQ(zda_delist_entry(node, int_entry_t)->key, i);
+        }
+        EXPECT_EQ(zda_mpsc_queue_pop(&q), nullptr);
+        EXPECT_TRUE(zda_mpsc_queue_is_empty(&q));
+    }
+}
+
+TEST(mpsc_queue_test, pop_all)
+{
+    zda_mpsc_queue_t q;
+    zda_mpsc_queue_init(&q);
+
+    zda_delist_t dl;
+    zda_delist_init(&dl);
+    EXPECT_EQ(zda_mpsc_queue_pop_all(&q, &dl), 0u);
+    EXPECT_TRUE(zda_delist_is_empty(&dl));
+
+    std::vector<int_entry_t> entries(20);
+    for (int i = 0; i < 10; ++i) {
+        entries[i].key = i;
+        zda_mpsc_queue_push(&q, &entries[i].node);
+    }
+    /* The stub is in the middle after popping the single node */
+    EXPECT_EQ(zda_mpsc_queue_pop_all(&q, &dl), 10u);
+    for (int i = 10; i < 20; ++i) {
+        entries[i].key = i;
+        zda_mpsc_queue_push(&q, &entries[i].node);
+        if (i == 10) {
+            auto *node = zda_mpsc_queue_pop(&q);
+            ASSERT_NE(node, nullptr);
+            zda_delist_push_back(&dl, node);
+        }
+    }
+    EXPECT_EQ(zda_mpsc_queue_pop_all(&q, &dl), 9u);
+    EXPECT_TRUE(zda_mpsc_queue_is_empty(&q));
+
+    int i = 0;
+    zda_delist_iterate(&dl)
+    {
+        EXPECT_EQ(zda_delist_entry(pos, int_entry_t)->key, i);
+        ++i;
+    }
+    EXPECT_EQ(i, 20);
+    EXPECT_EQ(zda_delist_entry(zda_delist_back(&dl), int_entry_t)->key, 19);
+}
+
+TEST(mpsc_queue_test, concurrent)
+{
+    const int nproducer = 4;
+    const int n         = 100000;
+
+    zda_mpsc_queue_t q;
+    zda_mpsc_queue_init(&q);
+
+    std::vector<std::vector<int_entry_t>> entries(nproducer, std::vector<int_entry_t>(n));
+    std::vector<std::thread>              threads;
+    for (int t = 0; t < nproducer; ++t) {
+        threads.emplace_back([&q, &entries, t]() {
+            for (int i = 0; i < n; ++i) {
+                entries[t][i].producer = t;
+                entries[t][i].key      = i;
+                zda_mpsc_queue_push(&q, &entries[t][i].node);
+            }
+        });
+    }
+
+    /* The order of each producer is kept */
+    std::vector<int> expect(nproducer, 0);
+    int              cnt = 0;
+    while (cnt < nproducer * n) {
+        zda_delist_t dl;
+        zda_delist_init(&dl);
+        if (cnt % 3 == 0) {
+            cnt += (int)zda_mpsc_queue_pop_all(&q, &dl);
+        } else {
+            auto *node = zda_mpsc_queue_pop(&q);
+            if (!node) continue;
+            zda_delist_push_back(&dl, node);
+            ++cnt;
+        }
+
+        zda_delist_iterate(&dl)
+        {
+            auto *entry = zda_delist_entry(pos, int_entry_t);
+            ASSERT_EQ(entry->key, expect[entry->producer]);
+            ++expect[entry->producer];
+        }
+    }
+
+    for (auto &thr : threads)
+        thr.join();
+    EXPECT_EQ(zda_mpsc_queue_pop(&q), nullptr);
+    EXPECT_TRUE(zda_mpsc_queue_is_empty(&q));
+    for (int t = 0; t < nproducer; ++t)
+        EXPECT_EQ(expect[t], n);
+}
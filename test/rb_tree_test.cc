@@ -107,4 +107,83 @@ TEST(rb_tree_test, remove)
 
   printf("Remove complete: \n");
   zda_rb_tree_print_tree(&header, print_entry);
-}
\ No newline at end of file
+}
+
+typedef struct u64_entry {
+  zda_rb_node_t node;
+  uint64_t      key;
+} u64_entry_t;
+
+static zda_inline uint64_t u64_entry_get_key(u64_entry_t const *entry) { return entry->key; }
+
+zda_def_rb_tree_insert_check_int(u64_rb_tree_insert_check, uint64_t, u64_entry_t, u64_entry_get_key)
+zda_def_rb_tree_search_int(u64_rb_tree_search, uint64_t, u64_entry_t, u64_entry_get_key)
+
+TEST(rb_tree_test, int_key)
+{
+  zda_rb_header_t     header;
+  zda_rb_commit_ctx_t cmt_ctx;
+  const int           n = 1000;
+  zda_rb_header_init(&header);
+
+  /* The large keys make sure the comparison doesn't rely on subtraction */
+  for (int i = 0; i < n; i++) {
+    uint64_t key = (uint64_t)((i * 7919) % n) << 40;
+    ASSERT_FALSE(u64_rb_tree_insert_check(&header, key, &cmt_ctx));
+    auto entry = (u64_entry_t *)malloc(sizeof(u64_entry_t));
+    entry->key = key;
+    zda_rb_tree_insert_commit(&header, &cmt_ctx, &entry->node);
+  }
+  ASSERT_TRUE(zda_rb_tree_verify_properties(&header));
+
+  const ptrdiff_t offset = zda_rb_key_offset(u64_entry_t, key);
+  for (int i = 0; i < n; i++) {
+    uint64_t key = (uint64_t)i << 40;
+
+    auto entry = u64_rb_tree_search(&header, key);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->key, key);
+    EXPECT_EQ(zda_rb_tree_search_u64(&header, key, offset), &entry->node);
+    EXPECT_EQ(zda_rb_tree_insert_check_u64(&header, key, offset, &cmt_ctx), &entry->node);
+
+    EXPECT_FALSE(u64_rb_tree_search(&header, key + 1));
+    EXPECT_TRUE(zda_rb_node_is_nil(&header, zda_rb_tree_search_u64(&header, key + 1, offset)));
+  }
+
+  uint64_t key = (uint64_t)n << 40;
+  ASSERT_FALSE(zda_rb_tree_insert_check_u64(&header, key, offset, &cmt_ctx));
+  auto entry = (u64_entry_t *)malloc(sizeof(u64_entry_t));
+  entry->key = key;
+  zda_rb_tree_insert_commit(&header, &cmt_ctx, &entry->node);
+  EXPECT_EQ(u64_rb_tree_search(&header, key), entry);
+
+  zda_rb_tree_destroy_inplace(&header, u64_entry_t, free);
+}
+
+TEST(rb_tree_test, u32_key)
+{
+  zda_rb_header_t header;
+  zda_rb_header_init(&header);
+
+  /* The key is placed before the node, the offset is negative */
+  typedef struct u32_entry {
+    uint32_t      key;
+    zda_rb_node_t node;
+  } u32_entry_t;
+
+  const ptrdiff_t     offset = zda_rb_key_offset(u32_entry_t, key);
+  zda_rb_commit_ctx_t cmt_ctx;
+  u32_entry_t         entries[100];
+
+  for (uint32_t i = 0; i < 100; i++) {
+    entries[i].key = UINT32_MAX - i;
+    ASSERT_FALSE(zda_rb_tree_insert_check_u32(&header, entries[i].key, offset, &cmt_ctx));
+    zda_rb_tree_insert_commit(&header, &cmt_ctx, &entries[i].node);
+  }
+  ASSERT_TRUE(zda_rb_tree_verify_properties(&header));
+
+  for (uint32_t i = 0; i < 100; i++) {
+    EXPECT_EQ(zda_rb_tree_search_u32(&header, UINT32_MAX - i, offset), &entries[i].node);
+  }
+  EXPECT_TRUE(zda_rb_node_is_nil(&header, zda_rb_tree_search_u32(&header, 0, offset)));
+}
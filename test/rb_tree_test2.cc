@@ -4,4 +4,52 @@
 
 #include <gtest/gtest.h>
 
-using TestRbTree = zda::RbTree<int, zda::KEntry<int, zda_rb_node_t>>;
\ No newline at end of file
+using TestRbTree = zda::RbTree<int, zda::KEntry<int, zda_rb_node_t>>;
+
+TEST(rb_tree_test2, int_key)
+{
+  using Entry = zda::KEntry<int64_t, zda_rb_node_t>;
+  zda::RbTree<int64_t, Entry> tree;
+
+  /* x - y overflows for these keys */
+  const int64_t keys[] = {INT64_MIN, -1, 0, 1, INT64_MAX, INT64_MIN + 1, INT64_MAX - 1};
+  for (auto key : keys) {
+    auto entry = (Entry *)malloc(sizeof(Entry));
+    entry->key = key;
+    ASSERT_EQ(tree.insert_entry(entry), entry);
+  }
+
+  int64_t prev  = INT64_MIN;
+  size_t  count = 0;
+  for (auto &entry : tree) {
+    EXPECT_LE(prev, entry.key);
+    prev = entry.key;
+    ++count;
+  }
+  EXPECT_EQ(count, sizeof(keys) / sizeof(keys[0]));
+
+  for (auto key : keys) {
+    auto entry = tree.search(key);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->key, key);
+  }
+  EXPECT_FALSE(tree.search(2));
+
+  free(tree.remove(0));
+  EXPECT_FALSE(tree.search(0));
+  EXPECT_TRUE(tree.search(-1));
+}
+
+TEST(rb_tree_test2, comparator)
+{
+  zda::Comparator<int32_t> cmp32;
+  EXPECT_LT(cmp32(INT32_MIN, 1), 0);
+  EXPECT_GT(cmp32(INT32_MAX, -1), 0);
+  EXPECT_EQ(cmp32(3, 3), 0);
+
+  zda::Comparator<int64_t> cmp64;
+  EXPECT_LT(cmp64(0, INT64_C(1) << 32), 0);
+
+  zda::Comparator<uint64_t> ucmp64;
+  EXPECT_GT(ucmp64(UINT64_MAX, 0), 0);
+}
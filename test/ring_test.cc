@@ -0,0 +1,234 @@
+#include "zda/ring.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zda;
+
+template <typename Ring>
+static void test_basic()
+{
+    Ring ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    EXPECT_TRUE(ring.empty());
+
+    std::string out;
+    EXPECT_FALSE(ring.try_pop(out));
+
+    /* Wrap around several times */
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 8; ++i)
+            EXPECT_TRUE(ring.try_push(std::to_string(i)));
+        EXPECT_FALSE(ring.try_push("full"));
+        EXPECT_EQ(ring.size(), 8u);
+
+        for (int i = 0; i < 8; ++i) {
+            ASSERT_TRUE(ring.try_pop(out));
+            EXPECT_EQ(out, std::to_string(i));
+        }
+        EXPECT_FALSE(ring.try_pop(out));
+        EXPECT_TRUE(ring.empty());
+    }
+}
+
+template <typename Ring>
+static void test_batch()
+{
+    Ring ring(8);
+    std::vector<std::string> in;
+    for (int i = 0; i < 20; ++i)
+        in.push_back(std::to_string(i));
+
+    EXPECT_EQ(ring.try_push_batch(in.begin(), 0), 0u);
+    EXPECT_EQ(ring.try_push_batch(in.begin(), 5), 5u);
+    EXPECT_EQ(ring.try_push_batch(in.begin() + 5, 15), 3u);
+    EXPECT_EQ(in[8], "8");
+
+    std::string out[20];
+    EXPECT_EQ(ring.try_pop_batch(out, 6), 6u);
+    EXPECT_EQ(ring.try_push_batch(in.begin() + 8, 12), 6u);
+    EXPECT_EQ(ring.try_pop_batch(out + 6, 20), 8u);
+    EXPECT_EQ(ring.try_pop_batch(out + 14, 20), 0u);
+    for (int i = 0; i < 14; ++i)
+        EXPECT_EQ(out[i], std::to_string(i));
+}
+
+template <typename Ring>
+static void test_destroy()
+{
+    auto ptr = std::make_shared<int>(1);
+    {
+        Ring ring(4);
+        for (int i = 0; i < 3; ++i)
+            ring.try_push(ptr);
+        std::shared_ptr<int> out;
+        ring.try_pop(out);
+        EXPECT_EQ(ptr.use_count(), 4);
+    }
+    EXPECT_EQ(ptr.use_count(), 1);
+}
+
+/* The copy throws if the value is negative */
+struct ThrowOnCopy {
+    explicit ThrowOnCopy(int v = 0)
+      : value(v)
+    {
+    }
+    ThrowOnCopy(ThrowOnCopy const &other)
+      : value(other.value)
+    {
+        if (value < 0) throw std::runtime_error("copy");
+    }
+    ThrowOnCopy(ThrowOnCopy &&) noexcept = default;
+    ThrowOnCopy &operator=(ThrowOnCopy const &) = default;
+    ThrowOnCopy &operator=(ThrowOnCopy &&) noexcept = default;
+
+    int value;
+};
+
+TEST(ring_test, spsc)
+{
+    test_basic<SpscRing<std::string>>();
+    test_batch<SpscRing<std::string>>();
+    test_destroy<SpscRing<std::shared_ptr<int>>>();
+}
+
+TEST(ring_test, mpmc)
+{
+    test_basic<MpmcRing<std::string>>();
+    test_batch<MpmcRing<std::string>>();
+    test_destroy<MpmcRing<std::shared_ptr<int>>>();
+}
+
+TEST(ring_test, mpmc_throw)
+{
+    MpmcRing<ThrowOnCopy> ring(4);
+    ThrowOnCopy const bad(-1);
+    ThrowOnCopy out;
+
+    /* The failed copies don't claim any slot */
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(ring.try_push(ThrowOnCopy(i)));
+        EXPECT_THROW(ring.try_push(bad), std::runtime_error);
+        EXPECT_THROW(ring.try_emplace(bad), std::runtime_error);
+        ASSERT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out.value, i);
+    }
+    EXPECT_TRUE(ring.empty());
+
+    /* The full ring doesn't take the rvalue */
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(ring.try_push(ThrowOnCopy(i)));
+    ThrowOnCopy extra(100);
+    EXPECT_FALSE(ring.try_push(std::move(extra)));
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out.value, i);
+    }
+    EXPECT_FALSE(ring.try_pop(out));
+}
+
+TEST(ring_test, spsc_concurrent)
+{
+    const uint64_t n = 1000000;
+    SpscRing<uint64_t> ring(256);
+
+    std::thread producer([&ring, n]() {
+        uint64_t buf[16];
+        for (uint64_t i = 0; i < n;) {
+            size_t pushed;
+            if (i % 3 == 0) {
+                pushed = ring.try_push(i) ? 1 : 0;
+            } else {
+                size_t const k = (size_t)zda_min(n - i, (uint64_t)16);
+                for (size_t j = 0; j < k; ++j)
+                    buf[j] = i + j;
+                pushed = ring.try_push_batch(buf, k);
+            }
+            /* Let the consumer run if full */
+            if (!pushed) std::this_thread::yield();
+            i += pushed;
+        }
+    });
+
+    uint64_t expect = 0;
+    uint64_t buf[32];
+    while (expect < n) {
+        size_t const k = ring.try_pop_batch(buf, 32);
+        if (!k) std::this_thread::yield();
+        for (size_t j = 0; j < k; ++j)
+            ASSERT_EQ(buf[j], expect++);
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(ring_test, mpmc_concurrent)
+{
+    const int nproducer = 2;
+    const int nconsumer = 2;
+    const uint64_t n = 200000;
+    MpmcRing<uint64_t> ring(64);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nproducer; ++t) {
+        threads.emplace_back([&ring, t, n]() {
+            uint64_t buf[8];
+            for (uint64_t i = 0; i < n;) {
+                uint64_t const value = (uint64_t)t * n + i;
+                size_t pushed;
+                if (i % 2 == 0) {
+                    pushed = ring.try_push(value) ? 1 : 0;
+                } else {
+                    size_t const k = (size_t)zda_min(n - i, (uint64_t)8);
+                    for (size_t j = 0; j < k; ++j)
+                        buf[j] = value + j;
+                    pushed = ring.try_push_batch(buf, k);
+                }
+                if (!pushed) std::this_thread::yield();
+                i += pushed;
+            }
+        });
+    }
+
+    std::atomic<uint64_t> received(0);
+    std::vector<std::vector<uint64_t>> results(nconsumer);
+    for (int t = 0; t < nconsumer; ++t) {
+        threads.emplace_back([&, t]() {
+            uint64_t buf[8];
+            while (received.load() < nproducer * n) {
+                size_t k;
+                if (t == 0) {
+                    k = ring.try_pop(buf[0]) ? 1 : 0;
+                } else {
+                    k = ring.try_pop_batch(buf, 8);
+                }
+                if (!k) std::this_thread::yield();
+                results[t].insert(results[t].end(), buf, buf + k);
+                received += k;
+            }
+        });
+    }
+    for (auto &thr : threads)
+        thr.join();
+
+    /* Each value is received exactly once */
+    std::vector<int> seen(nproducer * n, 0);
+    for (auto const &result : results) {
+        /* The values of same producer are popped in order by one consumer */
+        std::vector<uint64_t> last(nproducer, 0);
+        for (auto value : result) {
+            ++seen[value];
+            EXPECT_GE(value, last[value / n]);
+            last[value / n] = value + 1;
+        }
+    }
+    for (auto cnt : seen)
+        ASSERT_EQ(cnt, 1);
+    EXPECT_TRUE(ring.empty());
+}
@@ -2,6 +2,8 @@
 
 #include <zda/slist.h>
 
+#include <vector>
+
 typedef struct int_entry {
     int              val;
     zda_slist_node_t node;
@@ -143,3 +145,83 @@ TEST(slist2_test, search)
 
     zda_slist_destroy2(&slist, int_entry_t);
 }
+
+typedef struct sort_entry {
+    uint64_t         key;
+    int              seq;
+    zda_slist_node_t node;
+} sort_entry_t;
+
+#define sort_entry_cmp(lhs, rhs) ((lhs)->key < (rhs)->key ? -1 : (lhs)->key > (rhs)->key)
+#define sort_entry_key(entry)    ((entry)->key)
+
+static int sort_node_cmp(zda_slist_node_t const *lhs, zda_slist_node_t const *rhs)
+{
+    return sort_entry_cmp(
+        zda_slist_entry(lhs, sort_entry_t const),
+        zda_slist_entry(rhs, sort_entry_t const)
+    );
+}
+
+static uint64_t sort_node_key(zda_slist_node_t const *node)
+{
+    return zda_slist_entry(node, sort_entry_t const)->key;
+}
+
+/* The keys are sorted and the equal keys keep the insertion order */
+static void check_sorted(zda_slist_header_t *list, int n)
+{
+    int           cnt  = 0;
+    sort_entry_t *prev = NULL;
+    zda_slist_iterate(list)
+    {
+        auto entry = zda_slist_entry(pos, sort_entry_t);
+        if (prev) {
+            ASSERT_LE(prev->key, entry->key);
+            if (prev->key == entry->key) {
+                ASSERT_LT(prev->seq, entry->seq);
+            }
+        }
+        prev = entry;
+        ++cnt;
+    }
+    EXPECT_EQ(cnt, n);
+}
+
+TEST(slist_test, sort)
+{
+    for (int n : {0, 1, 2, 3, 17, 1000, 4097}) {
+        for (int method = 0; method < 4; ++method) {
+            std::vector<sort_entry_t> entries(n);
+            zda_slist_header_t        list;
+            zda_slist_header_init(&list);
+
+            uint64_t seed = 88172645463325252ull;
+            for (int i = n - 1; i >= 0; --i) {
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+                /* Many duplicates for checking stability, and the large keys for all passes */
+                entries[i].key = (method & 1) ? seed : seed % 64;
+                entries[i].seq = i;
+                zda_slist_push_front(&list, &entries[i].node);
+            }
+
+            switch (method) {
+            case 0:
+                zda_slist_sort_inplace(&list, sort_entry_t, sort_entry_cmp);
+                break;
+            case 1:
+                zda_slist_sort(&list, sort_node_cmp);
+                break;
+            case 2:
+                zda_slist_radix_sort_inplace(&list, sort_entry_t, sort_entry_key);
+                break;
+            case 3:
+                zda_slist_radix_sort(&list, sort_node_key);
+                break;
+            }
+            check_sorted(&list, n);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include "zda/string_fmt.hpp"
+
+#include <gtest/gtest.h>
+
+#include <climits>
+#include <string_view>
+
+using namespace zda;
+using namespace zda::literal;
+
+TEST(StringFmtTest, literal)
+{
+    EXPECT_EQ(str_catf(ZDA_FMT("")), "");
+    EXPECT_EQ(str_catf(ZDA_FMT("abc")), "abc");
+    EXPECT_EQ(str_catf(ZDA_FMT("100%%")), "100%");
+    EXPECT_EQ(str_catf(ZDA_FMT("%%%%a%%")), "%%a%");
+}
+
+TEST(StringFmtTest, string)
+{
+    std::string s = "str";
+    EXPECT_EQ(str_catf(ZDA_FMT("%s|%v|%S|%s|%v"), "c_str", StringViewLiteral("view"),
+                       &s, s, std::string_view("std_view")),
+              "c_str|view|str|str|std_view");
+    EXPECT_EQ(str_catf(ZDA_FMT("<%c%c>"), 'a', 'b'), "<ab>");
+}
+
+TEST(StringFmtTest, number)
+{
+    EXPECT_EQ(str_catf(ZDA_FMT("%d %i %ld %lld %zu"), -1, INT_MIN, 2L, LLONG_MAX,
+                       (size_t)3),
+              "-1 -2147483648 2 9223372036854775807 3");
+    EXPECT_EQ(str_catf(ZDA_FMT("%d %u"), UINT64_MAX, -1), "18446744073709551615 4294967295");
+    EXPECT_EQ(str_catf(ZDA_FMT("%x %X %x"), 255, 0xABCu, (char)-1), "ff ABC ff");
+    EXPECT_EQ(str_catf(ZDA_FMT("%g %g %f"), 0.1, 1e100, 1.5f), "0.1 1e+100 1.5");
+
+    for (int i = -1000; i <= 1000; i += 7) {
+        double const d = i / 7.0;
+        EXPECT_EQ(str_catf(ZDA_FMT("%d:%g:%f"), i, d, d), str_catf("%d:%g:%f", i, d, d));
+    }
+}
+
+TEST(StringFmtTest, append)
+{
+    std::string s = "head ";
+    EXPECT_EQ(str_appendf(&s, ZDA_FMT("id=%d name=%v"), 42, StringViewLiteral("zda")), 0u);
+    EXPECT_EQ(s, "head id=42 name=zda");
+}
+
+TEST(StringFmtTest, buf)
+{
+    char buf[8];
+    EXPECT_EQ(buf_catf(buf, sizeof buf, ZDA_FMT("%d-%s"), 12, "ab"), 5u);
+    EXPECT_STREQ(buf, "12-ab");
+
+    EXPECT_EQ(buf_catf(buf, sizeof buf, ZDA_FMT("%s=%d"), "long", 123456), 11u);
+    EXPECT_STREQ(buf, "long=12");
+
+    EXPECT_EQ(buf_catf(nullptr, 0, ZDA_FMT("%g"), 2.5), 3u);
+}
@@ -0,0 +1,96 @@
+#include "zda/string_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace zda;
+
+TEST(StringPoolTest, intern)
+{
+    StringPool pool;
+    EXPECT_TRUE(pool.is_empty());
+
+    std::string host = "example.com";
+    auto const id    = pool.intern(StringView(host));
+    EXPECT_EQ(id, 0);
+    EXPECT_EQ(pool.intern(StringViewLiteral("example.com")), id);
+    EXPECT_EQ(pool.intern(StringViewLiteral("example.org")), 1);
+    EXPECT_EQ(pool.size(), 2);
+
+    /* The stored bytes are owned by the pool and null-terminated */
+    auto const view = pool.get(id);
+    EXPECT_NE(view.data(), host.data());
+    host[0] = 'X';
+    EXPECT_EQ(view, StringViewLiteral("example.com"));
+    EXPECT_EQ(view.data()[view.size()], '\0');
+    EXPECT_EQ(pool.intern_view(StringViewLiteral("example.com")).data(), view.data());
+
+    EXPECT_EQ(pool.find(StringViewLiteral("example.net")), StringPool::INVALID_ID);
+    EXPECT_TRUE(pool.contains(StringViewLiteral("example.org")));
+
+    /* Empty string and embedded NUL */
+    auto const empty = pool.intern(StringView(nullptr, 0));
+    EXPECT_EQ(pool.get(empty).size(), 0);
+    EXPECT_EQ(pool.intern(StringView("", 0)), empty);
+    EXPECT_NE(pool.intern(StringView("a\0b", 3)), pool.intern(StringView("a\0c", 3)));
+}
+
+TEST(StringPoolTest, many)
+{
+    StringPool pool;
+    std::unordered_map<std::string, StringPool::Id> expect;
+    std::vector<char const *> datas;
+
+    for (int i = 0; i < 100000; ++i) {
+        /* Include some large strings which take the dedicated blocks */
+        std::string str = "tag" + std::to_string(i % 30000);
+        if (i % 5000 == 0) str.append(detail::StringArena::BLOCK_SIZE / 2, 'x');
+
+        auto const id = pool.intern(StringView(str));
+        auto const it = expect.emplace(str, id);
+        EXPECT_EQ(it.first->second, id);
+        if (it.second) datas.push_back(pool.get(id).data());
+    }
+
+    EXPECT_EQ(pool.size(), expect.size());
+    for (auto const &kv : expect) {
+        EXPECT_EQ(pool.find(StringView(kv.first)), kv.second);
+        EXPECT_EQ(pool.get(kv.second), StringView(kv.first));
+        /* The views are stable */
+        EXPECT_EQ(pool.get(kv.second).data(), datas[kv.second]);
+    }
+    EXPECT_GT(pool.memory_usage(), 0);
+}
+
+TEST(StringPoolTest, freeze)
+{
+    StringPool pool;
+    for (int i = 0; i < 1000; ++i)
+        pool.intern(StringView(std::to_string(i)));
+
+    pool.freeze();
+    EXPECT_TRUE(pool.is_frozen());
+    EXPECT_EQ(pool.intern(StringViewLiteral("1000")), StringPool::INVALID_ID);
+    EXPECT_EQ(pool.intern(StringViewLiteral("999")), pool.find(StringViewLiteral("999")));
+    EXPECT_EQ(pool.size(), 1000);
+
+    std::vector<std::thread> threads;
+    std::vector<int> fails(4);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, &fails, t] {
+            for (int i = 0; i < 1000; ++i) {
+                auto const str = std::to_string(i);
+                auto const id  = pool.find(StringView(str));
+                if (id == StringPool::INVALID_ID || pool.get(id) != StringView(str)) ++fails[t];
+            }
+        });
+    }
+    for (auto &th : threads)
+        th.join();
+    for (int f : fails)
+        EXPECT_EQ(f, 0);
+}
@@ -6,6 +6,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <stdlib.h>
+
 using namespace zda;
 using namespace zda::literal;
 
@@ -32,4 +35,75 @@ TEST(StringUtilTest, fmt)
     buf_catf(buf, sizeof(buf), "1234%v%S%v%c", "1"_sv, &s,
              StringViewLiteral("3"), '4');
     EXPECT_EQ(strcmp(buf, "12341234"), 0);
-}
\ No newline at end of file
+}
+TEST(StringUtilTest, fmt_number)
+{
+    auto str = str_catf("%d %u %ld %lu %lld %llu %zu", -1, 2u, -3L, 4UL,
+                        (long long)INT64_MIN, (unsigned long long)UINT64_MAX,
+                        (size_t)5);
+    EXPECT_EQ(str,
+              "-1 2 -3 4 -9223372036854775808 18446744073709551615 5");
+
+    str = str_catf("%x %X %lx %i%%", 255u, 255u, 0xdeadbeefUL, 0);
+    EXPECT_EQ(str, "ff FF deadbeef 0%");
+
+    str = str_catf("%g %g %g %g %g", 0.1, 1e20, 1.5e-7, -0.0, 100.0);
+    EXPECT_EQ(str, "0.1 1e+20 1.5e-07 -0 100");
+
+    str = str_catf("%f %f %f", 1e20, 1.5e-7, 3.25);
+    EXPECT_EQ(str, "100000000000000000000 0.00000015 3.25");
+
+    /* Truncated but the full size is returned */
+    char buf[8];
+    EXPECT_EQ(buf_catf(buf, sizeof(buf), "%s=%d", "answer", 42), 9);
+    EXPECT_STREQ(buf, "answer=");
+
+    EXPECT_EQ(buf_catf(buf, sizeof(buf), "%q"), (size_t)-1);
+}
+
+TEST(StringUtilTest, number_to_chars)
+{
+    char buf[ZDA_DOUBLE_FIXED_CHARS_MAX];
+
+    for (uint64_t v = 1, i = 0; i < 20; ++i, v *= 10) {
+        EXPECT_EQ(std::string(buf, u64_to_chars(buf, v - 1)),
+                  std::to_string(v - 1));
+        EXPECT_EQ(std::string(buf, u64_to_chars(buf, v)), std::to_string(v));
+    }
+    EXPECT_EQ(std::string(buf, s64_to_chars(buf, INT64_MIN)),
+              std::to_string(INT64_MIN));
+    EXPECT_EQ(std::string(buf, u64_to_hex_chars(buf, 0)), "0");
+    EXPECT_EQ(std::string(buf, u64_to_hex_chars(buf, UINT64_MAX, true)),
+              "FFFFFFFFFFFFFFFF");
+
+    EXPECT_EQ(std::string(buf, double_to_chars(buf, 5e-324)), "5e-324");
+    EXPECT_EQ(std::string(buf, double_to_chars(buf, 1.7976931348623157e308)),
+              "1.7976931348623157e+308");
+    EXPECT_EQ(std::string(buf, double_to_chars(buf, 1.0 / 0.0)), "inf");
+    EXPECT_EQ(std::string(buf, double_to_chars(buf, -1.0 / 0.0)), "-inf");
+    EXPECT_EQ(std::string(buf, double_to_chars(buf, std::nan(""))), "nan");
+
+    /* Round-trip */
+    srand(0);
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t bits = ((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^
+                        (uint64_t)rand();
+        double v;
+        memcpy(&v, &bits, sizeof v);
+        if (std::isnan(v)) continue;
+
+        size_t n = double_to_chars(buf, v);
+        buf[n] = 0;
+        ASSERT_EQ(strtod(buf, nullptr), v) << buf;
+        n = double_to_fixed_chars(buf, v);
+        buf[n] = 0;
+        ASSERT_EQ(strtod(buf, nullptr), v) << buf;
+    }
+
+    std::string str = "n=";
+    str_append_int(&str, -7);
+    str_append_uint(&str, 8);
+    str += ' ';
+    str_append_double(&str, 0.3);
+    EXPECT_EQ(str, "n=-78 0.3");
+}
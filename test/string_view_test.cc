@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <zda/string_view.hpp>
 
+#include <stdlib.h>
+#include <vector>
+
 using namespace zda;
 
 TEST(string_view_test, to_upper)
@@ -9,3 +12,245 @@ TEST(string_view_test, to_upper)
     auto upper = view.to_upper_string();
     EXPECT_EQ(upper, "ABCDEF");
 }
+
+static std::string ascii_lower(std::string str)
+{
+    for (auto &c : str)
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+    return str;
+}
+
+TEST(string_view_test, case_convert)
+{
+    /* All bytes and the lengths around the vector width */
+    std::string all;
+    for (int i = 0; i < 256; ++i)
+        all.push_back((char)i);
+
+    for (size_t len = 0; len <= all.size(); len += 7) {
+        StringView view(all.data(), len);
+        std::string upper = view.to_upper_string();
+        std::string lower = view.to_lower_string();
+        for (size_t i = 0; i < len; ++i) {
+            char const c = all[i];
+            EXPECT_EQ(upper[i], (c >= 'a' && c <= 'z') ? c - 0x20 : c);
+            EXPECT_EQ(lower[i], (c >= 'A' && c <= 'Z') ? c + 0x20 : c);
+        }
+    }
+
+    /* In place */
+    std::string str = "Content-Type: TEXT/html";
+    StringView(str).to_lower_buffer(&str[0], str.size());
+    EXPECT_EQ(str, "content-type: text/html");
+}
+
+TEST(string_view_test, case_compare)
+{
+    DefStringViewLiteral(view, "Content-Length");
+    EXPECT_EQ(view.case_compare(StringViewLiteral("content-length")), 0);
+    EXPECT_TRUE(view.case_equal(StringViewLiteral("CONTENT-LENGTH")));
+    EXPECT_FALSE(view.case_equal(StringViewLiteral("content-lengt")));
+    EXPECT_LT(view.case_compare(StringViewLiteral("content-lengthx")), 0);
+    EXPECT_GT(view.case_compare(StringViewLiteral("CONTENT")), 0);
+    EXPECT_LT(view.case_compare(StringViewLiteral("content-type")), 0);
+    EXPECT_GT(StringView(nullptr, 0).case_compare(StringView(nullptr, 0)), -1);
+    /* Compared in lowercase like strncasecmp(): 'z' > '[' > 'Z' */
+    EXPECT_GT(StringViewLiteral("Z").case_compare(StringViewLiteral("[")), 0);
+    /* Non-ASCII bytes are not folded */
+    EXPECT_FALSE(StringViewLiteral("\xc4").case_equal(StringViewLiteral("\xe4")));
+
+    EXPECT_EQ(StringViewLiteral("a").case_compare('A'), 0);
+    EXPECT_EQ(StringViewLiteral("ab").case_compare('A'), 1);
+    EXPECT_EQ(StringViewLiteral("b").case_compare('A'), 1);
+    EXPECT_EQ(StringViewLiteral("a").case_compare('B'), -1);
+    EXPECT_EQ(StringView(nullptr, 0).case_compare('a'), -1);
+
+    std::string long1(100, 'x');
+    std::string long2(100, 'X');
+    EXPECT_TRUE(StringView(long1).case_equal(long2));
+    EXPECT_EQ(StringView(long1).case_hash(), StringView(long2).case_hash());
+    long2[77] = 'y';
+    EXPECT_LT(StringView(long1).case_compare(long2), 0);
+    EXPECT_NE(StringView(long1).case_hash(), StringView(long2).case_hash());
+
+    for (size_t len = 0; len < 20; ++len) {
+        std::string a(len, 'k');
+        std::string b(len, 'K');
+        EXPECT_EQ(StringView(a).case_hash(), StringView(b).case_hash());
+        EXPECT_NE(StringView(a).case_hash(), StringView(a + '\0').case_hash());
+    }
+}
+
+TEST(string_view_test, case_find)
+{
+    DefStringViewLiteral(view, "Accept: text/HTML, Accept-Encoding: gzip");
+    EXPECT_EQ(view.case_find(StringViewLiteral("html")), 13);
+    EXPECT_EQ(view.case_find(StringViewLiteral("ACCEPT"), 1), 19);
+    EXPECT_EQ(view.case_find(StringViewLiteral("G")), 33);
+    EXPECT_EQ(view.case_find(StringViewLiteral("")), 0);
+    EXPECT_EQ(view.case_find(StringViewLiteral("deflate")), ZDA_STRING_VIEW_NPOS);
+
+    srand(7);
+    for (int round = 0; round < 2000; ++round) {
+        std::string hs(rand() % 200, 0);
+        for (auto &c : hs)
+            c = "aAbB["[rand() % 5];
+        std::string ne(1 + rand() % 6, 0);
+        for (auto &c : ne)
+            c = "aAbB["[rand() % 5];
+        size_t const pos = rand() % (hs.size() + 2);
+
+        EXPECT_EQ(StringView(hs).case_find(ne, pos), ascii_lower(hs).find(ascii_lower(ne), pos))
+            << hs << " " << ne << " " << pos;
+    }
+}
+
+TEST(string_view_test, find)
+{
+    DefStringViewLiteral(view, "hello world, hello zda");
+    EXPECT_EQ(view.find(StringViewLiteral("hello")), 0);
+    EXPECT_EQ(view.find(StringViewLiteral("hello"), 1), 13);
+    EXPECT_EQ(view.find(StringViewLiteral("zda")), 19);
+    EXPECT_EQ(view.find(StringViewLiteral("zdb")), ZDA_STRING_VIEW_NPOS);
+    EXPECT_EQ(view.find(StringViewLiteral("")), 0);
+    EXPECT_EQ(view.find(StringViewLiteral(""), 5), 5);
+    EXPECT_EQ(view.find(StringViewLiteral("o"), 5), 7);
+    EXPECT_EQ(view.find(StringViewLiteral("hello zda world")), ZDA_STRING_VIEW_NPOS);
+
+    /* Embedded NUL is a normal character */
+    StringView nul("a\0b\0c", 5);
+    EXPECT_EQ(nul.find(StringView("\0c", 2)), 3);
+}
+
+TEST(string_view_test, rfind)
+{
+    DefStringViewLiteral(view, "hello world, hello zda");
+    EXPECT_EQ(view.rfind(StringViewLiteral("hello")), 13);
+    EXPECT_EQ(view.rfind(StringViewLiteral("hello"), 12), 0);
+    EXPECT_EQ(view.rfind(StringViewLiteral("zda")), 19);
+    EXPECT_EQ(view.rfind(StringViewLiteral("zdb")), ZDA_STRING_VIEW_NPOS);
+    EXPECT_EQ(view.rfind(StringViewLiteral("o")), 17);
+    EXPECT_EQ(view.rfind('o'), 17);
+
+    StringView empty(nullptr, 0);
+    EXPECT_EQ(empty.rfind(StringViewLiteral("a")), ZDA_STRING_VIEW_NPOS);
+    EXPECT_EQ(empty.rfind('a'), ZDA_STRING_VIEW_NPOS);
+    EXPECT_EQ(empty.rfind(StringViewLiteral("")), 0);
+}
+
+/* Compare with std::string on the small alphabet to hit many partial matches */
+TEST(string_view_test, find_random)
+{
+    srand(0);
+    for (int round = 0; round < 2000; ++round) {
+        std::string hs(rand() % 300, 'a');
+        std::string ne(1 + rand() % (round % 2 ? 8 : 100), 'a');
+        for (auto &c : hs)
+            c = 'a' + rand() % 2;
+        for (auto &c : ne)
+            c = 'a' + rand() % 2;
+        /* Embed the needle to make sure there is an occurrence sometimes */
+        if (hs.size() > ne.size() && rand() % 2) {
+            hs.replace(rand() % (hs.size() - ne.size()), ne.size(), ne);
+        }
+
+        StringView view(hs.data(), hs.size());
+        StringView needle(ne.data(), ne.size());
+        size_t     pos = hs.empty() ? 0 : rand() % hs.size();
+        ASSERT_EQ(view.find(needle, pos), hs.find(ne, pos));
+        ASSERT_EQ(view.rfind(needle, pos), hs.rfind(ne, pos));
+        ASSERT_EQ(view.rfind(needle), hs.rfind(ne));
+    }
+}
+
+TEST(string_view_test, find_of)
+{
+    DefStringViewLiteral(view, "Host: example.com\r\n");
+    EXPECT_EQ(view.find_first_of(StringViewLiteral(":\r")), 4);
+    EXPECT_EQ(view.find_first_of(StringViewLiteral("\n")), 18);
+    EXPECT_EQ(view.find_first_of(StringViewLiteral("xyz")), 7);
+    EXPECT_EQ(view.find_first_of(StringViewLiteral("!")), ZDA_STRING_VIEW_NPOS);
+    EXPECT_EQ(view.find_first_not_of(StringViewLiteral("Hos")), 3);
+    EXPECT_EQ(view.find_last_of(StringViewLiteral(".:")), 13);
+    EXPECT_EQ(view.find_last_of(StringViewLiteral(".:"), 12), 4);
+    EXPECT_EQ(view.find_last_of('H'), 0);
+    EXPECT_EQ(view.find_last_not_of(StringViewLiteral("\r\n")), 16);
+
+    CharSet space(" \t");
+    DefStringViewLiteral(line, "  \t value");
+    EXPECT_EQ(line.span(space), 4);
+    EXPECT_EQ(line.cspan(space), 0);
+    EXPECT_EQ(line.substr(4, 5).cspan(space), 5);
+}
+
+TEST(string_view_test, find_of_random)
+{
+    srand(0);
+    for (int round = 0; round < 2000; ++round) {
+        std::string hs(rand() % 200, 0);
+        std::string chars(rand() % 6, 0);
+        /* Cover both the ASCII and non-ASCII table */
+        for (auto &c : hs)
+            c = (char)(rand() % 8 * 37);
+        for (auto &c : chars)
+            c = (char)(rand() % 8 * 37);
+
+        StringView view(hs.data(), hs.size());
+        CharSet    set(chars.data(), chars.size());
+        size_t     pos = rand() % (hs.size() + 1);
+        ASSERT_EQ(view.find_first_of(set, pos), hs.find_first_of(chars, pos));
+        ASSERT_EQ(view.find_first_not_of(set, pos), hs.find_first_not_of(chars, pos));
+        ASSERT_EQ(view.find_last_of(set, pos), hs.find_last_of(chars, pos));
+        ASSERT_EQ(view.find_last_not_of(set, pos), hs.find_last_not_of(chars, pos));
+        ASSERT_EQ(view.find_last_of(set), hs.find_last_of(chars));
+    }
+}
+
+static std::vector<std::string> collect(StringSplit const &split)
+{
+    std::vector<std::string> ret;
+    for (StringView field : split)
+        ret.emplace_back(field.data(), field.size());
+    return ret;
+}
+
+TEST(string_view_test, split)
+{
+    using Fields = std::vector<std::string>;
+
+    DefStringViewLiteral(csv, "a,b,,c,");
+    EXPECT_EQ(collect(csv.split(',')), (Fields{"a", "b", "", "c", ""}));
+    EXPECT_EQ(collect(csv.split(',', ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY)),
+              (Fields{"a", "b", "c"}));
+    EXPECT_EQ(collect(csv.split(',', 0, 2)), (Fields{"a", "b", ",c,"}));
+    EXPECT_EQ(collect(csv.split(',', ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY, 2)),
+              (Fields{"a", "b", "c,"}));
+
+    DefStringViewLiteral(header, "Host: example.com\r\nAccept: */*\r\n");
+    EXPECT_EQ(collect(header.split(StringViewLiteral("\r\n"))),
+              (Fields{"Host: example.com", "Accept: */*", ""}));
+    EXPECT_EQ(collect(header.split(StringViewLiteral(": "), 0, 1)),
+              (Fields{"Host", "example.com\r\nAccept: */*\r\n"}));
+
+    DefStringViewLiteral(words, "  hello \t world\n");
+    EXPECT_EQ(collect(words.split(CharSet(" \t\n"), ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY)),
+              (Fields{"hello", "world"}));
+
+    StringView empty(nullptr, 0);
+    EXPECT_EQ(collect(empty.split(',')), (Fields{""}));
+    EXPECT_EQ(collect(empty.split(',', ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY)), (Fields{}));
+}
+
+TEST(string_view_test, split_c)
+{
+    zda_string_view_t       line;
+    zda_string_view_t       field;
+    zda_string_view_split_t split;
+    std::vector<std::string> fields;
+
+    zda_string_view_literal_init(&line, "1 22 333");
+    zda_string_view_split_init_char(&split, &line, ' ', 0, ZDA_STRING_VIEW_NPOS);
+    while (zda_string_view_split_next(&split, &field))
+        fields.emplace_back(field.data, field.len);
+    EXPECT_EQ(fields, (std::vector<std::string>{"1", "22", "333"}));
+}
@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <stdlib.h>
+
 using namespace zda;
 
 TEST(StringViewUtilTest, converter) {
@@ -14,4 +17,76 @@ TEST(StringViewUtilTest, converter) {
         auto res = string_view_to_s64(StringViewLiteral("s64"));
         ASSERT_FALSE(res);
     }
-}
\ No newline at end of file
+}
+
+TEST(StringViewUtilTest, integer_strict) {
+    EXPECT_EQ(*string_view_to_u64(StringViewLiteral("18446744073709551615")), UINT64_MAX);
+    EXPECT_FALSE(string_view_to_u64(StringViewLiteral("18446744073709551616")));
+    EXPECT_EQ(*string_view_to_u64(StringViewLiteral("000000000000000000000000012345678901")),
+              12345678901ULL);
+    EXPECT_EQ(*string_view_to_s64(StringViewLiteral("-9223372036854775808")), INT64_MIN);
+    EXPECT_FALSE(string_view_to_s64(StringViewLiteral("9223372036854775808")));
+    EXPECT_EQ(*string_view_to_s64(StringViewLiteral("-0")), 0);
+
+    EXPECT_EQ(*string_view_to_u32(StringViewLiteral("ff"), 16), 0xff);
+    EXPECT_EQ(*string_view_to_u32(StringViewLiteral("0xFF"), 16), 0xff);
+    EXPECT_EQ(*string_view_to_u32(StringViewLiteral("0x1f"), 0), 0x1f);
+    EXPECT_EQ(*string_view_to_u32(StringViewLiteral("017"), 0), 017);
+    EXPECT_EQ(*string_view_to_u32(StringViewLiteral("0b101"), 0), 5);
+    EXPECT_EQ(*string_view_to_u32(StringViewLiteral("zz"), 36), 36 * 36 - 1);
+    EXPECT_FALSE(string_view_to_u32(StringViewLiteral("4294967296")));
+    EXPECT_FALSE(string_view_to_u32(StringViewLiteral("8"), 8));
+
+    /* Trailing garbage, whitespace and the empty input are rejected */
+    EXPECT_FALSE(string_view_to_s32(StringViewLiteral("12a")));
+    EXPECT_FALSE(string_view_to_s32(StringViewLiteral(" 12")));
+    EXPECT_FALSE(string_view_to_s32(StringViewLiteral("")));
+    EXPECT_FALSE(string_view_to_s32(StringViewLiteral("-")));
+    EXPECT_FALSE(string_view_to_u32(StringViewLiteral("-1")));
+    EXPECT_FALSE(string_view_to_u32(StringViewLiteral("0x"), 16));
+
+    EXPECT_EQ(*string_view_to_u16(StringViewLiteral("65535")), 65535);
+    EXPECT_FALSE(string_view_to_u16(StringViewLiteral("65536")));
+    EXPECT_EQ(*string_view_to_s16(StringViewLiteral("-32768")), -32768);
+    EXPECT_FALSE(string_view_to_s16(StringViewLiteral("32768")));
+    EXPECT_EQ(*string_view_to_u8(StringViewLiteral("255")), 255);
+    EXPECT_FALSE(string_view_to_u8(StringViewLiteral("256")));
+    EXPECT_EQ(*string_view_to_s8(StringViewLiteral("-128")), -128);
+    EXPECT_FALSE(string_view_to_s8(StringViewLiteral("128")));
+}
+
+TEST(StringViewUtilTest, to_double) {
+    char const *inputs[] = {
+        "0",
+        "-0.0",
+        "1",
+        "0.1",
+        ".5",
+        "1.",
+        "3.141592653589793",
+        "1e308",
+        "1.7976931348623157e308",
+        "2.2250738585072014e-308",
+        "4.9e-324",
+        "1e-400",
+        "123456789012345678901234567890",
+        "0.000000000000000000000000000123456789",
+        "9007199254740993",
+        "-1.5E+10",
+    };
+    for (auto input : inputs) {
+        auto res = string_view_to_double(StringView(input));
+        ASSERT_TRUE(res) << input;
+        EXPECT_EQ(*res, strtod(input, nullptr)) << input;
+    }
+
+    EXPECT_TRUE(std::isinf(*string_view_to_double(StringViewLiteral("1e400"))));
+    EXPECT_TRUE(std::isinf(*string_view_to_double(StringViewLiteral("-Infinity"))));
+    EXPECT_TRUE(std::isnan(*string_view_to_double(StringViewLiteral("nan"))));
+
+    EXPECT_FALSE(string_view_to_double(StringViewLiteral("")));
+    EXPECT_FALSE(string_view_to_double(StringViewLiteral(".")));
+    EXPECT_FALSE(string_view_to_double(StringViewLiteral("1e")));
+    EXPECT_FALSE(string_view_to_double(StringViewLiteral("1.0f")));
+    EXPECT_FALSE(string_view_to_double(StringViewLiteral("e5")));
+}
@@ -0,0 +1,149 @@
+#include <zda/tavl_tree.h>
+#include <zda/tavl_tree.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+typedef struct int_entry {
+  ZDA_TAVL_NODE_HOOK;
+  int key;
+} int_entry_t;
+
+static zda_inline int int_entry_cmp(int x, int y) { return (x > y) - (x < y); }
+static zda_inline int int_entry_get_key(int_entry_t const *entry) noexcept { return entry->key; }
+
+zda_def_tavl_tree_insert_check(
+    tavl_tree_insert_check_int_entry,
+    int,
+    int_entry_t,
+    int_entry_get_key,
+    int_entry_cmp
+)
+zda_def_tavl_tree_insert_entry(
+    tavl_tree_insert_int_entry,
+    int_entry_t,
+    int_entry_get_key,
+    int_entry_cmp
+)
+zda_def_tavl_tree_search(
+    tavl_tree_search_int_entry,
+    int,
+    int_entry_t,
+    int_entry_get_key,
+    int_entry_cmp
+)
+zda_def_tavl_tree_remove(
+    tavl_tree_remove_int_entry,
+    int,
+    int_entry_t,
+    int_entry_get_key,
+    int_entry_cmp
+)
+zda_def_tavl_tree_destroy(tavl_tree_destroy_int_entry, int_entry_t, free)
+
+static void check_thread(zda_tavl_tree_t *tree, std::vector<int> const &keys)
+{
+  ASSERT_TRUE(zda_tavl_tree_verify_properties(tree));
+
+  size_t i = 0;
+  zda_tavl_tree_iterate(tree)
+  {
+    ASSERT_LT(i, keys.size());
+    EXPECT_EQ(zda_tavl_entry(pos, int_entry_t)->key, keys[i]);
+    ++i;
+  }
+  EXPECT_EQ(i, keys.size());
+
+  /* Reverse iteration */
+  for (zda_tavl_node_t *pos = zda_tavl_tree_get_last(tree); pos != NULL;
+       pos                  = zda_tavl_node_get_prev(pos))
+  {
+    ASSERT_GT(i, 0);
+    --i;
+    EXPECT_EQ(zda_tavl_entry(pos, int_entry_t)->key, keys[i]);
+  }
+}
+
+TEST(tavl_tree_test, insert)
+{
+  zda_tavl_tree_t tree;
+  zda_tavl_tree_init(&tree);
+
+  std::vector<int> keys(1000);
+  for (int i = 0; i < 1000; ++i)
+    keys[i] = i;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  for (int key : keys) {
+    auto entry = (int_entry_t *)malloc(sizeof(int_entry_t));
+    entry->key = key;
+    ASSERT_FALSE(tavl_tree_insert_int_entry(&tree, entry));
+    ASSERT_TRUE(tavl_tree_search_int_entry(&tree, key));
+  }
+
+  zda_avl_commit_ctx_t cmt_ctx;
+  ASSERT_TRUE(tavl_tree_insert_check_int_entry(&tree, 0, &cmt_ctx));
+
+  std::sort(keys.begin(), keys.end());
+  check_thread(&tree, keys);
+
+  tavl_tree_destroy_int_entry(&tree);
+}
+
+TEST(tavl_tree_test, remove)
+{
+  zda_tavl_tree_t tree;
+  zda_tavl_tree_init(&tree);
+
+  std::vector<int> keys;
+  for (int i = 0; i < 500; ++i) {
+    auto entry = (int_entry_t *)malloc(sizeof(int_entry_t));
+    entry->key = i;
+    tavl_tree_insert_int_entry(&tree, entry);
+    keys.push_back(i);
+  }
+
+  std::mt19937 rng(1);
+  while (!keys.empty()) {
+    auto idx   = rng() % keys.size();
+    auto entry = tavl_tree_remove_int_entry(&tree, keys[idx]);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->key, keys[idx]);
+    free(entry);
+    keys.erase(keys.begin() + idx);
+    if (keys.size() % 50 == 0) check_thread(&tree, keys);
+  }
+
+  EXPECT_TRUE(zda_tavl_tree_is_empty(&tree));
+  EXPECT_FALSE(zda_tavl_tree_get_first(&tree));
+  EXPECT_FALSE(zda_tavl_tree_get_last(&tree));
+}
+
+struct get_key_int_entry {
+  zda_inline int operator()(int_entry_t const *entry) const noexcept { return entry->key; }
+};
+
+TEST(tavl_tree_test, wrapper)
+{
+  zda::TavlTree<int, int_entry_t, get_key_int_entry, zda::Comparator<int32_t>> tree;
+
+  for (int i = 99; i >= 0; --i) {
+    auto entry = (int_entry_t *)malloc(sizeof(int_entry_t));
+    entry->key = i;
+    tree.insert_entry(entry);
+  }
+
+  int i = 0;
+  for (auto &entry : tree) {
+    EXPECT_EQ(entry.key, i);
+    ++i;
+  }
+  EXPECT_EQ(i, 100);
+
+  free(tree.remove(50));
+  EXPECT_FALSE(tree.search(50));
+  EXPECT_TRUE(tree.search(51));
+}
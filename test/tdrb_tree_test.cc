@@ -0,0 +1,128 @@
+#include <zda/tdrb_tree.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+typedef struct int_entry {
+  ZDA_TDRB_NODE_HOOK;
+  int key;
+} int_entry_t;
+
+static zda_inline int int_entry_cmp(int x, int y) { return (x > y) - (x < y); }
+static zda_inline int int_entry_get_key(int_entry_t const *entry) noexcept { return entry->key; }
+
+zda_def_tdrb_tree_insert_entry(
+    tdrb_tree_insert_int_entry,
+    int_entry_t,
+    int_entry_get_key,
+    int_entry_cmp
+)
+zda_def_tdrb_tree_search(
+    tdrb_tree_search_int_entry,
+    int,
+    int_entry_t,
+    int_entry_get_key,
+    int_entry_cmp
+)
+zda_def_tdrb_tree_remove(
+    tdrb_tree_remove_int_entry,
+    int,
+    int_entry_t,
+    int_entry_get_key,
+    int_entry_cmp
+)
+zda_def_tdrb_tree_destroy(tdrb_tree_destroy_int_entry, int_entry_t, free)
+
+static int_entry_t *new_int_entry(int key)
+{
+  auto ret = (int_entry_t *)malloc(sizeof(int_entry_t));
+  ret->key = key;
+  return ret;
+}
+
+static void check_tree(zda_tdrb_tree_t *tree, std::vector<int> const &keys)
+{
+  ASSERT_TRUE(zda_tdrb_tree_verify_properties(tree));
+
+  zda_tdrb_iter_t iter;
+  size_t          i = 0;
+  zda_tdrb_tree_iterate(tree, &iter)
+  {
+    ASSERT_LT(i, keys.size());
+    EXPECT_EQ(zda_tdrb_entry(pos, int_entry_t)->key, keys[i]);
+    ++i;
+  }
+  EXPECT_EQ(i, keys.size());
+}
+
+TEST(tdrb_tree_test, insert)
+{
+  static_assert(sizeof(zda_tdrb_node_t) == 3 * sizeof(void *), "The node has no parent link");
+
+  zda_tdrb_tree_t tree;
+  zda_tdrb_tree_init(&tree);
+
+  std::vector<int> keys(1000);
+  for (int i = 0; i < 1000; ++i)
+    keys[i] = i;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  for (int key : keys) {
+    ASSERT_FALSE(tdrb_tree_insert_int_entry(&tree, new_int_entry(key)));
+    ASSERT_TRUE(zda_tdrb_tree_verify_properties(&tree));
+  }
+
+  /* Duplicate key */
+  auto dup = new_int_entry(0);
+  auto old = tdrb_tree_insert_int_entry(&tree, dup);
+  ASSERT_TRUE(old);
+  EXPECT_EQ(old->key, 0);
+  free(dup);
+
+  for (int i = 0; i < 1000; ++i) {
+    auto entry = tdrb_tree_search_int_entry(&tree, i);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->key, i);
+  }
+  EXPECT_FALSE(tdrb_tree_search_int_entry(&tree, 1000));
+
+  std::sort(keys.begin(), keys.end());
+  check_tree(&tree, keys);
+  EXPECT_EQ(zda_tdrb_entry(zda_tdrb_tree_get_first(&tree), int_entry_t)->key, 0);
+  EXPECT_EQ(zda_tdrb_entry(zda_tdrb_tree_get_last(&tree), int_entry_t)->key, 999);
+  EXPECT_LE(zda_tdrb_tree_get_height(&tree), 20);
+
+  tdrb_tree_destroy_int_entry(&tree);
+}
+
+TEST(tdrb_tree_test, remove)
+{
+  zda_tdrb_tree_t tree;
+  zda_tdrb_tree_init(&tree);
+
+  std::vector<int> keys;
+  for (int i = 0; i < 500; ++i) {
+    tdrb_tree_insert_int_entry(&tree, new_int_entry(i));
+    keys.push_back(i);
+  }
+
+  EXPECT_FALSE(tdrb_tree_remove_int_entry(&tree, 500));
+
+  std::mt19937 rng(1);
+  while (!keys.empty()) {
+    auto idx   = rng() % keys.size();
+    auto entry = tdrb_tree_remove_int_entry(&tree, keys[idx]);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->key, keys[idx]);
+    free(entry);
+    keys.erase(keys.begin() + idx);
+    ASSERT_TRUE(zda_tdrb_tree_verify_properties(&tree));
+    if (keys.size() % 50 == 0) check_tree(&tree, keys);
+  }
+
+  EXPECT_TRUE(zda_tdrb_tree_is_empty(&tree));
+  EXPECT_FALSE(tdrb_tree_remove_int_entry(&tree, 0));
+}
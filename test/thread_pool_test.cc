@@ -0,0 +1,165 @@
+#include "zda/thread_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <stdexcept>
+
+using namespace zda;
+
+TEST(thread_pool_test, deque)
+{
+    WorkStealingDeque<int> deque(2);
+    int values[100];
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+
+    /* Grow several times */
+    for (int i = 0; i < 100; ++i) {
+        values[i] = i;
+        deque.push(&values[i]);
+    }
+    EXPECT_EQ(deque.size(), 100u);
+
+    /* LIFO for the owner, FIFO for the thieves */
+    EXPECT_EQ(*deque.pop(), 99);
+    EXPECT_EQ(*deque.steal(), 0);
+    EXPECT_EQ(*deque.steal(), 1);
+    for (int i = 98; i >= 2; --i)
+        EXPECT_EQ(*deque.pop(), i);
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(deque.pop(), nullptr);
+}
+
+TEST(thread_pool_test, deque_concurrent)
+{
+    const int nthief = 3;
+    const int n      = 200000;
+
+    WorkStealingDeque<int> deque;
+    std::vector<int> values(n);
+    std::vector<std::atomic<int>> taken(n);
+    for (auto &cnt : taken)
+        cnt = 0;
+
+    std::atomic<bool> finished(false);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < nthief; ++t) {
+        thieves.emplace_back([&]() {
+            while (!finished.load()) {
+                int *x = deque.steal();
+                if (x)
+                    ++taken[*x];
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for (int i = 0; i < n; ++i) {
+        values[i] = i;
+        deque.push(&values[i]);
+        if (i % 3 == 0) {
+            int *x = deque.pop();
+            if (x) ++taken[*x];
+        }
+    }
+    while (int *x = deque.pop())
+        ++taken[*x];
+    finished = true;
+    for (auto &thr : thieves)
+        thr.join();
+
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQ(taken[i].load(), 1) << i;
+}
+
+static uint64_t fib(ThreadPool &pool, int n)
+{
+    if (n < 2) return n;
+    if (n < 10) return fib(pool, n - 1) + fib(pool, n - 2);
+    uint64_t a, b;
+    pool.fork_join([&]() { a = fib(pool, n - 1); }, [&]() { b = fib(pool, n - 2); });
+    return a + b;
+}
+
+TEST(thread_pool_test, fork_join)
+{
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+    EXPECT_EQ(pool.current_worker(), -1);
+    EXPECT_EQ(fib(pool, 25), 75025u);
+
+    pool.run([&pool]() {
+        int const index = pool.current_worker();
+        EXPECT_GE(index, 0);
+        EXPECT_LT(index, 4);
+    });
+}
+
+TEST(thread_pool_test, parallel_for)
+{
+    ThreadPool pool(3);
+    const size_t n = 100000;
+    std::vector<uint64_t> data(n);
+
+    /* body(i) */
+    pool.parallel_for(0, n, [&data](size_t i) { data[i] = i; });
+    EXPECT_EQ(std::accumulate(data.begin(), data.end(), (uint64_t)0), n * (n - 1) / 2);
+
+    /* body(lo, hi) with the grain */
+    std::atomic<uint64_t> sum(0);
+    std::atomic<int> nrange(0);
+    pool.parallel_for(10, n, 1000, [&](size_t lo, size_t hi) {
+        EXPECT_LE(hi - lo, 1000u);
+        uint64_t local = 0;
+        for (size_t i = lo; i < hi; ++i)
+            local += data[i];
+        sum += local;
+        ++nrange;
+    });
+    EXPECT_EQ(sum.load(), n * (n - 1) / 2 - 45);
+    EXPECT_GE(nrange.load(), (int)((n - 10) / 1000));
+
+    /* Empty range */
+    pool.parallel_for(5, 5, [](size_t) { FAIL(); });
+}
+
+TEST(thread_pool_test, exception)
+{
+    ThreadPool pool(2);
+    EXPECT_THROW(pool.fork_join([]() {}, []() { throw std::runtime_error("f2"); }),
+                 std::runtime_error);
+    EXPECT_THROW(pool.parallel_for(0,
+                                   1000,
+                                   1,
+                                   [](size_t i) {
+                                       if (i == 777) throw std::out_of_range("777");
+                                   }),
+                 std::out_of_range);
+
+    /* The pool is still usable */
+    std::atomic<int> cnt(0);
+    pool.parallel_for(0, 100, [&cnt](size_t) { ++cnt; });
+    EXPECT_EQ(cnt.load(), 100);
+}
+
+TEST(thread_pool_test, external_threads)
+{
+    ThreadPool pool(2);
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> results(4);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, &results, t]() {
+            for (int k = 0; k < 20; ++k) {
+                std::atomic<uint64_t> sum(0);
+                pool.parallel_for(0, 1000, 10, [&sum](size_t i) { sum += i; });
+                results[t] += sum.load();
+            }
+        });
+    }
+    for (auto &thr : threads)
+        thr.join();
+    for (auto result : results)
+        EXPECT_EQ(result, 20u * 999 * 1000 / 2);
+}
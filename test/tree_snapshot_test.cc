@@ -0,0 +1,318 @@
+#include "zda/tree_snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+typedef struct rb_entry {
+  uint64_t      key;
+  std::string   value;
+  zda_rb_node_t node;
+} rb_entry_t;
+
+typedef struct avl_entry {
+  uint64_t       key;
+  std::string    value;
+  zda_avl_node_t node;
+} avl_entry_t;
+
+static zda_inline int u64_cmp(uint64_t x, uint64_t y) noexcept { return (x > y) - (x < y); }
+
+static zda_inline uint64_t rb_entry_get_key(rb_entry_t const *entry) noexcept { return entry->key; }
+
+static zda_inline uint64_t avl_entry_get_key(avl_entry_t const *entry) noexcept
+{
+  return entry->key;
+}
+
+zda_def_rb_tree_insert_entry(rb_insert_entry, rb_entry_t, rb_entry_get_key, u64_cmp)
+zda_def_avl_tree_insert_entry(avl_insert_entry, avl_entry_t, avl_entry_get_key, u64_cmp)
+
+static void rb_entry_free(zda_rb_node_t *node) { delete zda_rb_entry(node, rb_entry_t); }
+static void avl_entry_free(zda_avl_node_t *node) { delete zda_avl_entry(node, avl_entry_t); }
+
+static uint64_t rb_node_get_key(void const *node, void *)
+{
+  return zda_rb_entry((zda_rb_node_t const *)node, rb_entry_t const)->key;
+}
+
+static size_t rb_node_serialize(void const *node, void *buf, size_t n, void *)
+{
+  auto const *entry = zda_rb_entry((zda_rb_node_t const *)node, rb_entry_t const);
+  if (entry->value.size() <= n) memcpy(buf, entry->value.data(), entry->value.size());
+  return entry->value.size();
+}
+
+static uint64_t avl_node_get_key(void const *node, void *)
+{
+  return zda_avl_entry((zda_avl_node_t const *)node, avl_entry_t const)->key;
+}
+
+static size_t avl_node_serialize(void const *node, void *buf, size_t n, void *)
+{
+  auto const *entry = zda_avl_entry((zda_avl_node_t const *)node, avl_entry_t const);
+  if (entry->value.size() <= n) memcpy(buf, entry->value.data(), entry->value.size());
+  return entry->value.size();
+}
+
+static zda_rb_node_t *rb_node_load(uint64_t key, zda_tree_record_t const *rec, void *)
+{
+  auto *entry  = new rb_entry_t;
+  entry->key   = key;
+  entry->value = std::string((char const *)rec->data, rec->len);
+  return &entry->node;
+}
+
+static zda_avl_node_t *avl_node_load(uint64_t key, zda_tree_record_t const *rec, void *ctx)
+{
+  int *p_limit = (int *)ctx;
+  if (p_limit && (*p_limit)-- == 0) return NULL;
+  auto *entry  = new avl_entry_t;
+  entry->key   = key;
+  entry->value = std::string((char const *)rec->data, rec->len);
+  return &entry->node;
+}
+
+/* Sparse keys with the large gaps to exercise the multi-byte varints */
+static uint64_t make_key(int i) { return (uint64_t)i * 1000003 + ((uint64_t)(i % 7) << 40) * i; }
+
+static std::string make_value(int i) { return std::to_string(i) + std::string(i % 11, '*'); }
+
+static void write_read_rb(unsigned flags)
+{
+  zda_rb_tree_t tree;
+  zda_rb_tree_init(&tree);
+
+  int const             n = 5000;
+  std::vector<uint64_t> keys;
+  for (int i = 0; i < n; ++i) {
+    auto *entry  = new rb_entry_t;
+    entry->key   = make_key(i);
+    entry->value = make_value(i);
+    ASSERT_EQ(rb_insert_entry(&tree, entry), nullptr);
+    keys.push_back(entry->key);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  char path[] = "/tmp/zda_tree_snapshot_XXXXXX";
+  int  fd     = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  FILE *fp = fdopen(fd, "w+b");
+  ASSERT_EQ(
+      zda_rb_tree_snapshot_write(&tree, fp, flags, rb_node_get_key, rb_node_serialize, NULL),
+      0
+  );
+  fclose(fp);
+
+  zda_tree_snapshot_t snap;
+  ASSERT_EQ(zda_tree_snapshot_open(&snap, path), 0);
+  unlink(path);
+  ASSERT_EQ(zda_tree_snapshot_get_count(&snap), (size_t)n);
+
+  for (int i = 0; i < n; ++i) {
+    auto const rec = zda_tree_snapshot_search(&snap, make_key(i));
+    ASSERT_NE(rec.data, nullptr) << i;
+    EXPECT_EQ(std::string((char const *)rec.data, rec.len), make_value(i));
+    EXPECT_EQ(((uintptr_t)rec.data & 7), 0u);
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(zda_tree_snapshot_get_key(&snap, i), keys[i]);
+    EXPECT_EQ(zda_tree_snapshot_lower_bound(&snap, keys[i]), i);
+    EXPECT_EQ(zda_tree_snapshot_lower_bound(&snap, keys[i] + 1), i + 1);
+    if (i == 0 || keys[i - 1] + 1 != keys[i]) {
+      EXPECT_EQ(zda_tree_snapshot_search(&snap, keys[i] - 1).data, nullptr);
+    }
+  }
+  EXPECT_EQ(zda_tree_snapshot_lower_bound(&snap, 0), 0u);
+  EXPECT_EQ(zda_tree_snapshot_lower_bound(&snap, UINT64_MAX), (size_t)n);
+
+  zda_tree_snapshot_cursor_t cursor;
+  size_t                     cnt = 0;
+  zda_tree_snapshot_iterate(&snap, cursor)
+  {
+    ASSERT_EQ(cursor.key, keys[cnt]);
+    ++cnt;
+  }
+  EXPECT_EQ(cnt, (size_t)n);
+
+  zda_tree_snapshot_cursor_seek(&cursor, &snap, 100);
+  EXPECT_EQ(cursor.key, keys[100]);
+  zda_tree_snapshot_cursor_next(&cursor);
+  EXPECT_EQ(cursor.key, keys[101]);
+
+  /* Reload */
+  zda_rb_tree_t tree2;
+  zda_rb_tree_init(&tree2);
+  ASSERT_EQ(zda_rb_tree_snapshot_load(&tree2, &snap, rb_node_load, rb_entry_free, NULL), 0);
+  EXPECT_TRUE(zda_rb_tree_verify_properties(&tree2));
+
+  zda_rb_node_t *pos2 = zda_rb_tree_first(&tree2);
+  zda_rb_tree_iterate(&tree)
+  {
+    ASSERT_NE(pos2, zda_rb_tree_terminator(&tree2));
+    auto *x = zda_rb_entry(pos, rb_entry_t);
+    auto *y = zda_rb_entry(pos2, rb_entry_t);
+    EXPECT_EQ(x->key, y->key);
+    EXPECT_EQ(x->value, y->value);
+    pos2 = zda_rb_node_get_successor(&tree2, pos2);
+  }
+  EXPECT_EQ(pos2, zda_rb_tree_terminator(&tree2));
+
+  /* The reloaded tree supports the normal insertion */
+  auto *entry = new rb_entry_t;
+  entry->key  = UINT64_MAX;
+  EXPECT_EQ(rb_insert_entry(&tree2, entry), nullptr);
+  EXPECT_TRUE(zda_rb_tree_verify_properties(&tree2));
+
+  zda_tree_snapshot_close(&snap);
+  zda_rb_tree_destroy(&tree, rb_entry_free);
+  zda_rb_tree_destroy(&tree2, rb_entry_free);
+}
+
+TEST(tree_snapshot_test, rb_tree)
+{
+  write_read_rb(0);
+  write_read_rb(ZDA_TREE_SNAPSHOT_DELTA);
+}
+
+TEST(tree_snapshot_test, avl_tree)
+{
+  for (unsigned flags : {0u, (unsigned)ZDA_TREE_SNAPSHOT_DELTA}) {
+    zda_avl_tree_t tree;
+    zda_avl_tree_init(&tree);
+
+    int const n = 1000;
+    for (int i = 0; i < n; ++i) {
+      auto *entry  = new avl_entry_t;
+      entry->key   = make_key(i);
+      entry->value = make_value(i);
+      ASSERT_EQ(avl_insert_entry(&tree, entry), nullptr);
+    }
+
+    FILE *fp = tmpfile();
+    ASSERT_EQ(
+        zda_avl_tree_snapshot_write(&tree, fp, flags, avl_node_get_key, avl_node_serialize, NULL),
+        0
+    );
+    long const            size = ftell(fp);
+    std::vector<uint64_t> buf((size + 7) / 8);
+    rewind(fp);
+    ASSERT_EQ(fread(buf.data(), 1, size, fp), (size_t)size);
+    fclose(fp);
+
+    zda_tree_snapshot_t snap;
+    ASSERT_EQ(zda_tree_snapshot_init(&snap, buf.data(), size), 0);
+
+    /* The failed loading releases the created entries */
+    zda_avl_tree_t tree2;
+    zda_avl_tree_init(&tree2);
+    int limit = n / 2;
+    EXPECT_EQ(zda_avl_tree_snapshot_load(&tree2, &snap, avl_node_load, avl_entry_free, &limit), -1);
+    EXPECT_TRUE(zda_avl_tree_is_empty(&tree2));
+
+    ASSERT_EQ(zda_avl_tree_snapshot_load(&tree2, &snap, avl_node_load, avl_entry_free, NULL), 0);
+    EXPECT_TRUE(zda_avl_tree_verify_properties(&tree2));
+
+    zda_avl_node_t *pos2 = zda_avl_tree_get_first(&tree2);
+    for (zda_avl_node_t *pos = zda_avl_tree_get_first(&tree); pos; pos = zda_avl_node_get_next(pos)) {
+      ASSERT_NE(pos2, nullptr);
+      EXPECT_EQ(zda_avl_entry(pos, avl_entry_t)->key, zda_avl_entry(pos2, avl_entry_t)->key);
+      EXPECT_EQ(zda_avl_entry(pos, avl_entry_t)->value, zda_avl_entry(pos2, avl_entry_t)->value);
+      pos2 = zda_avl_node_get_next(pos2);
+    }
+    EXPECT_EQ(pos2, nullptr);
+
+    zda_tree_snapshot_close(&snap);
+    zda_avl_tree_destroy_inplace(&tree, avl_entry_t, delete);
+    zda_avl_tree_destroy_inplace(&tree2, avl_entry_t, delete);
+  }
+}
+
+TEST(tree_snapshot_test, build_sorted)
+{
+  for (size_t n = 0; n < 300; ++n) {
+    std::vector<rb_entry_t>      rb_entries(n);
+    std::vector<zda_rb_node_t *> rb_nodes(n);
+    std::vector<avl_entry_t>      avl_entries(n);
+    std::vector<zda_avl_node_t *> avl_nodes(n);
+    for (size_t i = 0; i < n; ++i) {
+      rb_entries[i].key  = i;
+      rb_nodes[i]        = &rb_entries[i].node;
+      avl_entries[i].key = i;
+      avl_nodes[i]       = &avl_entries[i].node;
+    }
+
+    zda_rb_tree_t rb_tree;
+    zda_rb_tree_init(&rb_tree);
+    zda_rb_tree_build_sorted(&rb_tree, rb_nodes.data(), n);
+    ASSERT_TRUE(zda_rb_tree_verify_properties(&rb_tree)) << n;
+
+    uint64_t expect = 0;
+    zda_rb_tree_iterate(&rb_tree) { ASSERT_EQ(zda_rb_entry(pos, rb_entry_t)->key, expect++); }
+    EXPECT_EQ(expect, n);
+
+    zda_avl_tree_t avl_tree;
+    zda_avl_tree_init(&avl_tree);
+    zda_avl_tree_build_sorted(&avl_tree, avl_nodes.data(), n);
+    ASSERT_TRUE(zda_avl_tree_verify_properties(&avl_tree)) << n;
+
+    expect = 0;
+    for (zda_avl_node_t *pos = zda_avl_tree_get_first(&avl_tree); pos;
+         pos                 = zda_avl_node_get_next(pos)) {
+      ASSERT_EQ(zda_avl_entry(pos, avl_entry_t)->key, expect++);
+    }
+    EXPECT_EQ(expect, n);
+  }
+}
+
+TEST(tree_snapshot_test, invalid)
+{
+  zda_rb_tree_t tree;
+  zda_rb_tree_init(&tree);
+
+  /* The empty tree is valid */
+  FILE *fp = tmpfile();
+  ASSERT_EQ(
+      zda_rb_tree_snapshot_write(
+          &tree,
+          fp,
+          ZDA_TREE_SNAPSHOT_DELTA,
+          rb_node_get_key,
+          rb_node_serialize,
+          NULL
+      ),
+      0
+  );
+  long const            size = ftell(fp);
+  std::vector<uint64_t> buf((size + 7) / 8);
+  rewind(fp);
+  ASSERT_EQ(fread(buf.data(), 1, size, fp), (size_t)size);
+  fclose(fp);
+
+  zda_tree_snapshot_t snap;
+  ASSERT_EQ(zda_tree_snapshot_init(&snap, buf.data(), size), 0);
+  EXPECT_TRUE(zda_tree_snapshot_is_empty(&snap));
+  EXPECT_EQ(zda_tree_snapshot_search(&snap, 1).data, nullptr);
+  EXPECT_EQ(zda_tree_snapshot_lower_bound(&snap, 1), 0u);
+
+  EXPECT_EQ(zda_tree_snapshot_init(&snap, buf.data(), size - 1), -1);
+  ((char *)buf.data())[0] = 'X';
+  EXPECT_EQ(zda_tree_snapshot_init(&snap, buf.data(), size), -1);
+  EXPECT_EQ(zda_tree_snapshot_open(&snap, "/nonexistent/zda_snapshot"), -1);
+
+  /* The keys are not in the order of tree */
+  rb_entry_t entries[2];
+  entries[0].key = 2;
+  entries[1].key = 1;
+  zda_rb_node_t *nodes[2] = {&entries[0].node, &entries[1].node};
+  zda_rb_tree_build_sorted(&tree, nodes, 2);
+  fp = tmpfile();
+  EXPECT_EQ(zda_rb_tree_snapshot_write(&tree, fp, 0, rb_node_get_key, rb_node_serialize, NULL), -1);
+  fclose(fp);
+}
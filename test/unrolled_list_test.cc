@@ -0,0 +1,213 @@
+#include "zda/unrolled_list.hpp"
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace zda;
+
+/* Count the live objects to check the destructions */
+struct Counted {
+    static int live;
+
+    explicit Counted(int v = 0)
+      : value(v)
+    {
+        ++live;
+    }
+    Counted(Counted const &other)
+      : value(other.value)
+    {
+        ++live;
+    }
+    Counted(Counted &&other) noexcept
+      : value(other.value)
+    {
+        ++live;
+    }
+    Counted &operator=(Counted const &) = default;
+    Counted &operator=(Counted &&) = default;
+    ~Counted() { --live; }
+
+    int value;
+};
+
+int Counted::live = 0;
+
+template <typename L>
+static void expect_equal(L const &list, std::list<int> const &expect)
+{
+    ASSERT_EQ(list.size(), expect.size());
+    auto it = expect.begin();
+    for (auto const &x : list)
+        ASSERT_EQ(x.value, *it++);
+
+    /* Backward */
+    auto rit = expect.rbegin();
+    for (auto iter = list.end(); iter != list.begin();)
+        ASSERT_EQ((--iter)->value, *rit++);
+}
+
+TEST(unrolled_list_test, basic)
+{
+    UnrolledList<std::string> list{"a", "b", "c"};
+    EXPECT_EQ(list.size(), 3u);
+    EXPECT_EQ(list.front(), "a");
+    EXPECT_EQ(list.back(), "c");
+
+    list.push_front("0");
+    list.push_back("d");
+    list.insert(++list.begin(), "x");
+    std::vector<std::string> out(list.begin(), list.end());
+    EXPECT_EQ(out, (std::vector<std::string>{"0", "x", "a", "b", "c", "d"}));
+
+    list.pop_front();
+    list.pop_back();
+    auto it = list.erase(list.begin());
+    EXPECT_EQ(*it, "a");
+
+    UnrolledList<std::string> copy(list);
+    UnrolledList<std::string> moved(std::move(list));
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.begin(), list.end());
+    EXPECT_EQ(std::vector<std::string>(moved.begin(), moved.end()),
+              std::vector<std::string>(copy.begin(), copy.end()));
+
+    list.swap(moved);
+    EXPECT_EQ(list.size(), 3u);
+    EXPECT_TRUE(moved.empty());
+    list.push_back("e");
+    EXPECT_EQ(list.back(), "e");
+}
+
+TEST(unrolled_list_test, block)
+{
+    using List = UnrolledList<int64_t, 128>;
+    EXPECT_EQ(List::block_capacity(), (128 - sizeof(zda_list_node_t) - sizeof(size_t)) / 8);
+
+    /* Appending fills the blocks fully */
+    List list;
+    size_t const cap = List::block_capacity();
+    for (size_t i = 0; i < cap * 10; ++i)
+        list.push_back((int64_t)i);
+    EXPECT_EQ(list.block_count(), 10u);
+    for (size_t i = 0; i < cap * 10; ++i)
+        list.push_front((int64_t)i);
+    EXPECT_EQ(list.block_count(), 20u);
+
+    /* Erasing keeps the blocks at least half full */
+    auto it = list.begin();
+    while (list.size() > cap) {
+        it = list.erase(it);
+        if (it == list.end()) it = list.begin();
+        ++it;
+        if (it == list.end()) it = list.begin();
+    }
+    EXPECT_LE(list.block_count(), 2u);
+}
+
+TEST(unrolled_list_test, random)
+{
+    std::mt19937 rng(12345);
+    {
+        UnrolledList<Counted, 64> list;
+        std::list<int> expect;
+
+        for (int op = 0; op < 20000; ++op) {
+            size_t const pos = expect.empty() ? 0 : rng() % (expect.size() + 1);
+            auto it = list.begin();
+            auto eit = expect.begin();
+            std::advance(it, pos);
+            std::advance(eit, pos);
+
+            if (rng() % 5 < 3 || expect.empty()) {
+                int const v = (int)rng();
+                auto ret = list.emplace(it, v);
+                expect.insert(eit, v);
+                ASSERT_EQ(ret->value, v);
+            } else if (pos < expect.size()) {
+                auto ret = list.erase(it);
+                eit = expect.erase(eit);
+                if (eit == expect.end())
+                    ASSERT_EQ(ret, list.end());
+                else
+                    ASSERT_EQ(ret->value, *eit);
+            }
+            ASSERT_EQ(list.size(), expect.size());
+            if (op % 1000 == 0) expect_equal(list, expect);
+        }
+        expect_equal(list, expect);
+        EXPECT_EQ((size_t)Counted::live, expect.size());
+
+        list.erase(list.begin(), list.end());
+        EXPECT_TRUE(list.empty());
+        EXPECT_EQ(list.block_count(), 0u);
+    }
+    EXPECT_EQ(Counted::live, 0);
+}
+
+TEST(unrolled_list_test, splice)
+{
+    for (size_t pos = 0; pos <= 40; pos += 5) {
+        UnrolledList<Counted, 64> list;
+        UnrolledList<Counted, 64> other;
+        std::list<int> expect;
+        for (int i = 0; i < 40; ++i) {
+            list.emplace_back(i);
+            expect.push_back(i);
+        }
+        std::vector<Counted *> addrs;
+        for (int i = 100; i < 130; ++i)
+            addrs.push_back(&other.emplace_back(i));
+
+        auto it = list.begin();
+        auto eit = expect.begin();
+        std::advance(it, pos);
+        std::advance(eit, pos);
+        list.splice(it, other);
+        for (int i = 100; i < 130; ++i)
+            expect.insert(eit, i);
+
+        EXPECT_TRUE(other.empty());
+        expect_equal(list, expect);
+
+        /* The spliced elements are not moved */
+        auto sit = list.begin();
+        std::advance(sit, pos);
+        for (auto *addr : addrs)
+            EXPECT_EQ(&*sit++, addr);
+    }
+    EXPECT_EQ(Counted::live, 0);
+}
+
+TEST(unrolled_list_test, insert_self)
+{
+    using List = UnrolledList<std::string, 128>;
+    size_t const cap = List::block_capacity();
+
+    /* Insert an element of the upper half of a full block into the same block */
+    for (size_t src_idx = 0; src_idx < cap; ++src_idx) {
+        List list;
+        std::vector<std::string> expect;
+        for (size_t i = 0; i < cap; ++i) {
+            list.push_back("element-" + std::to_string(i) + "-long-enough-to-allocate");
+            expect.push_back(list.back());
+        }
+        ASSERT_EQ(list.block_count(), 1u);
+
+        auto src = list.begin();
+        std::advance(src, src_idx);
+        list.insert(std::next(list.begin()), *src);
+        expect.insert(expect.begin() + 1, expect[src_idx]);
+        EXPECT_EQ(std::vector<std::string>(list.begin(), list.end()), expect);
+
+        /* Append and prepend an element of itself to the full blocks */
+        list.push_back(list.front());
+        list.push_front(list.back());
+        EXPECT_EQ(list.back(), expect.front());
+        EXPECT_EQ(list.front(), expect.front());
+    }
+}
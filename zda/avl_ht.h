@@ -46,7 +46,7 @@ static zda_inline void zda_avl_ht_init(zda_avl_ht_t *ht) zda_noexcept
 /*************************/
 /* Properties getter */
 /*************************/
-static zda_inline zda_bool zda_avl_ht_is_empty(zda_avl_ht_t const const *ht) zda_noexcept
+static zda_inline zda_bool zda_avl_ht_is_empty(zda_avl_ht_t const *ht) zda_noexcept
 {
     return ht->cnt == 0;
 }
@@ -103,7 +103,7 @@ static zda_inline size_t _zda_avl_ht_get_new_capa(zda_avl_ht_t *ht) zda_noexcept
                     } else if (root->right) {                                                      \
                         root = root->right;                                                        \
                     } else {                                                                       \
-                        zda_avl_node_t *parent = root->parent;                                     \
+                        zda_avl_node_t *parent = zda_avl_node_get_parent(root);                    \
                         if (parent) {                                                              \
                             if (parent->left == root) {                                            \
                                 parent->left = NULL;                                               \
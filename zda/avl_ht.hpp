@@ -2,6 +2,7 @@
 #define _ZDA_AVL_HT_HPP_
 
 #include "zda/avl_ht.h"
+#include "zda/hash.hpp"
 #include "zda/util/functor.hpp"
 #include "zda/util/map_functor.hpp"
 #include "zda/util/comparator.hpp"
@@ -17,7 +18,7 @@ template <
     typename Entry,
     typename Key,
     typename GetKey = GetKey<Entry, Key>,
-    typename Hash   = std::hash<Key>,
+    typename Hash   = zda::Hash<Key>,
     typename Cmp    = Comparator<Entry>,
     typename Free   = LibcFree<Entry>>
 class AvlHt
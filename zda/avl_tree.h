@@ -11,6 +11,7 @@
 #include "zda/util/container_of.h"
 #include "zda/util/assert.h"
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 EXTERN_C_BEGIN
@@ -18,16 +19,21 @@ EXTERN_C_BEGIN
 
 /**
  * @brief Represent a avl-tree node
- * The node stores the height instead compute height when
- * it is used.
+ * The node stores the balance factor(height(right) - height(left)) instead of
+ * the height. The balance factor is in [-1, 1], so it is packed into the low 2
+ * bits of the parent pointer(the node is aligned at least 4 bytes at any platform
+ * that has the pointer whose size is not less than 4).
+ * Thus, the node is three pointer size.
  */
 typedef struct zda_avl_node {
   struct zda_avl_node *left;
   struct zda_avl_node *right;
-  struct zda_avl_node *parent;
-  size_t               height;
+  /* Private data, use the accessors instead */
+  uintptr_t            parent_bf;
 } zda_avl_node_t;
 
+#define _ZDA_AVL_BF_MASK ((uintptr_t)3)
+
 #define ZDA_AVL_NODE_HOOK zda_avl_node_t node
 
 #define zda_avl_node_entry(p_node, type, node) container_of(p_node, type, node)
@@ -51,13 +57,25 @@ static zda_inline void zda_avl_tree_init(zda_avl_tree_t *tree) zda_noexcept { tr
 
 static zda_inline void zda_avl_node_init(zda_avl_node_t *node) zda_noexcept
 {
-  node->height = 0;
-  node->left = node->right = node->parent = NULL;
+  node->left = node->right = NULL;
+  /* parent = NULL, balance factor = 0 */
+  node->parent_bf = 1;
 }
 
 /******************************/
 /* Getter */
 /******************************/
+static zda_inline zda_avl_node_t *zda_avl_node_get_parent(zda_avl_node_t const *node) zda_noexcept
+{
+  return (zda_avl_node_t *)(node->parent_bf & ~_ZDA_AVL_BF_MASK);
+}
+
+/* Return height(right) - height(left) */
+static zda_inline int zda_avl_node_get_bf(zda_avl_node_t const *node) zda_noexcept
+{
+  return (int)(node->parent_bf & _ZDA_AVL_BF_MASK) - 1;
+}
+
 static zda_inline zda_bool zda_avl_node_is_single(zda_avl_node_t *node) zda_noexcept
 {
   return node && (!node->left && !node->right);
@@ -125,10 +143,10 @@ static zda_inline zda_avl_node_t *zda_avl_node_get_next(zda_avl_node_t *node)
   if (node->right) {
     return zda_avl_node_get_min(node->right);
   }
-  zda_avl_node_t *parent = node->parent;
+  zda_avl_node_t *parent = zda_avl_node_get_parent(node);
   while (parent && parent->right == node) {
     node   = parent;
-    parent = node->parent;
+    parent = zda_avl_node_get_parent(node);
   }
   return parent;
 }
@@ -139,10 +157,10 @@ static zda_inline zda_avl_node_t *zda_avl_node_get_prev(zda_avl_node_t *node)
   if (node->left) {
     return zda_avl_node_get_max(node->left);
   }
-  zda_avl_node_t *parent = node->parent;
+  zda_avl_node_t *parent = zda_avl_node_get_parent(node);
   while (parent && parent->left == node) {
     node   = parent;
-    parent = node->parent;
+    parent = zda_avl_node_get_parent(node);
   }
   return parent;
 }
@@ -169,14 +187,25 @@ typedef struct zda_avl_commit_ctx {
   zda_avl_node_t  *p_parent;
 } zda_avl_commit_ctx_t;
 
-#define zda_avl_tree_insert_check_inplace(tree, key, type, get_key, cmp_cb, commit_ctx, p_dup)     \
+/* The entry contains the node whose member name is not `node`(e.g. it is embedded in another hook),
+ * use the `*_member_inplace` version to specify it. */
+#define zda_avl_tree_insert_check_member_inplace(                                                  \
+    tree,                                                                                          \
+    key,                                                                                           \
+    type,                                                                                          \
+    member,                                                                                        \
+    get_key,                                                                                       \
+    cmp_cb,                                                                                        \
+    commit_ctx,                                                                                    \
+    p_dup                                                                                          \
+)                                                                                                  \
   do {                                                                                             \
     zda_avl_tree_t  *__tree       = tree;                                                          \
     zda_avl_node_t **p_slot       = &(__tree->node);                                               \
     zda_avl_node_t  *track_parent = NULL;                                                          \
     p_dup                         = NULL;                                                          \
     for (; *p_slot;) {                                                                             \
-      int res = cmp_cb(get_key(zda_avl_entry(*p_slot, type)), key);                                \
+      int res = cmp_cb(get_key(zda_avl_node_entry(*p_slot, type, member)), key);                   \
       if (res < 0) {                                                                               \
         track_parent = *p_slot;                                                                    \
         p_slot       = &(*p_slot)->right;                                                          \
@@ -184,7 +213,7 @@ typedef struct zda_avl_commit_ctx {
         track_parent = *p_slot;                                                                    \
         p_slot       = &(*p_slot)->left;                                                           \
       } else {                                                                                     \
-        p_dup = zda_avl_entry(*p_slot, type);                                                      \
+        p_dup = zda_avl_node_entry(*p_slot, type, member);                                         \
         break;                                                                                     \
       }                                                                                            \
     }                                                                                              \
@@ -193,6 +222,18 @@ typedef struct zda_avl_commit_ctx {
     (commit_ctx).p_parent = track_parent;                                                          \
   } while (0)
 
+#define zda_avl_tree_insert_check_inplace(tree, key, type, get_key, cmp_cb, commit_ctx, p_dup)     \
+  zda_avl_tree_insert_check_member_inplace(                                                        \
+      tree,                                                                                        \
+      key,                                                                                         \
+      type,                                                                                        \
+      node,                                                                                        \
+      get_key,                                                                                     \
+      cmp_cb,                                                                                      \
+      commit_ctx,                                                                                  \
+      p_dup                                                                                        \
+  )
+
 #define zda_decl_avl_tree_insert_check(func_name, key_type, type)                                  \
   type *func_name(zda_avl_tree_t *tree, key_type key, zda_avl_commit_ctx_t *p_ctx) zda_noexcept
 
@@ -209,10 +250,7 @@ typedef struct zda_avl_commit_ctx {
     zda_avl_node_t *__new_node = new_node;                                                         \
     zda_avl_node_init(__new_node);                                                                 \
     *((ctx).pp_slot) = __new_node;                                                                 \
-    if (!(ctx).p_parent) {                                                                         \
-      __new_node->height = 1;                                                                      \
-      break;                                                                                       \
-    }                                                                                              \
+    if (!(ctx).p_parent) break;                                                                    \
     zda_avl_tree_after_insert(tree, __new_node, (ctx).p_parent);                                   \
   } while (0)
 
@@ -246,7 +284,7 @@ ZDA_API void zda_avl_tree_insert_commit(
   type *func_name(zda_avl_tree_t *tree, type *entry) zda_noexcept
 
 #define zda_def_avl_tree_insert_entry(func_name, type, get_key, cmp_cb)                            \
-  zda_decl_avl_tree_insert_entry(func_name, type) zda_noexcept                                     \
+  zda_decl_avl_tree_insert_entry(func_name, type)                                                  \
   {                                                                                                \
     type *p_dup;                                                                                   \
     zda_avl_tree_insert_entry_inplace(tree, entry, type, get_key, cmp_cb, p_dup);                  \
@@ -256,24 +294,27 @@ ZDA_API void zda_avl_tree_insert_commit(
 /********************************/
 /* Search APIs */
 /********************************/
-#define zda_avl_tree_search_inplace(tree, key, type, get_key, cmp_cb, p_result)                    \
+#define zda_avl_tree_search_member_inplace(tree, key, type, member, get_key, cmp_cb, p_result)     \
   do {                                                                                             \
     zda_avl_tree_t *__tree = tree;                                                                 \
     p_result               = NULL;                                                                 \
     zda_avl_node_t *root   = __tree->node;                                                         \
     while (root) {                                                                                 \
-      int res = cmp_cb(get_key(zda_avl_entry(root, type)), key);                                   \
+      int res = cmp_cb(get_key(zda_avl_node_entry(root, type, member)), key);                      \
       if (res < 0) {                                                                               \
         root = root->right;                                                                        \
       } else if (res > 0) {                                                                        \
         root = root->left;                                                                         \
       } else {                                                                                     \
-        p_result = zda_avl_entry(root, type);                                                      \
+        p_result = zda_avl_node_entry(root, type, member);                                         \
         break;                                                                                     \
       }                                                                                            \
     }                                                                                              \
   } while (0)
 
+#define zda_avl_tree_search_inplace(tree, key, type, get_key, cmp_cb, p_result)                    \
+  zda_avl_tree_search_member_inplace(tree, key, type, node, get_key, cmp_cb, p_result)
+
 #define zda_decl_avl_tree_search(func_name, key_type, type)                                        \
   type *func_name(zda_avl_tree_t *tree, key_type key) zda_noexcept
 
@@ -298,7 +339,7 @@ ZDA_API void zda_avl_tree_insert_commit(
       } else if (root->right) {                                                                    \
         root = root->right;                                                                        \
       } else {                                                                                     \
-        zda_avl_node_t *parent = root->parent;                                                     \
+        zda_avl_node_t *parent = zda_avl_node_get_parent(root);                                    \
         if (parent) {                                                                              \
           if (parent->left == root) {                                                              \
             parent->left = NULL;                                                                   \
@@ -325,6 +366,20 @@ ZDA_API void zda_avl_tree_insert_commit(
     zda_avl_tree_destroy_inplace(tree, type, free_cb);                                             \
   }
 
+/************************************/
+/* Bulk build APIs */
+/************************************/
+/**
+ * @brief Build the tree from \p nodes[0, n) in O(n) without comparison
+ * The \p nodes must be sorted in the order of the tree, it is not checked.
+ * @param tree Must be empty
+ */
+ZDA_API void zda_avl_tree_build_sorted(
+    zda_avl_tree_t  *tree,
+    zda_avl_node_t **nodes,
+    size_t           n
+) zda_noexcept;
+
 /************************************/
 /* Remove APIs */
 /************************************/
@@ -353,9 +408,16 @@ void zda_avl_tree_remove_node(zda_avl_tree_t *tree, zda_avl_node_t *old_node) zd
 /************************************/
 /* Debug APIs */
 /************************************/
+/* The height is not stored, follow the higher child to compute it in O(logn) */
 static zda_inline size_t zda_avl_tree_get_height(zda_avl_tree_t *tree) zda_noexcept
 {
-  return tree->node->height;
+  size_t          height = 0;
+  zda_avl_node_t *node   = tree->node;
+  while (node) {
+    ++height;
+    node = zda_avl_node_get_bf(node) < 0 ? node->left : node->right;
+  }
+  return height;
 }
 
 ZDA_API zda_bool zda_avl_tree_verify_properties(zda_avl_tree_t *tree) zda_noexcept;
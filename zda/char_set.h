@@ -0,0 +1,92 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_CHAR_SET_H__
+#define _ZDA_CHAR_SET_H__
+
+/*
+ * Precompiled character set
+ *
+ * The set is represented as a 256-bit bitmap for the scalar path and
+ * two nibble lookup tables for the PSHUFB(SSSE3/AVX2) path:
+ * - lo_ascii[lo] has bit h set if the character (h << 4 | lo) is in the set,
+ *   where h is in [0, 8), i.e. the character is ASCII.
+ * - lo_high[lo] is the same but for the characters in [0x80, 0x100),
+ *   the bit h represents ((h + 8) << 4 | lo).
+ *
+ * Then a byte b is in the set if
+ *   (table[b & 0xf] & (1 << ((b >> 4) & 7))) != 0
+ * where table is selected by the highest bit of b. This can be evaluated
+ * for 16/32 bytes in a few instructions.
+ *
+ * Build the set once and reuse it in the searching since the build is O(n).
+ */
+#include "zda/util/macro.h"
+#include "zda/util/bool.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
+typedef struct zda_char_set {
+    uint64_t bits[4];
+    uint8_t lo_ascii[16];
+    uint8_t lo_high[16];
+} zda_char_set_t;
+
+/**************************/
+/* Initializer APIs */
+/**************************/
+static zda_inline void zda_char_set_init(zda_char_set_t *set) zda_noexcept
+{
+    memset(set, 0, sizeof *set);
+}
+
+static zda_inline void zda_char_set_add(zda_char_set_t *set,
+                                        char c) zda_noexcept
+{
+    unsigned char const uc = (unsigned char)c;
+
+    set->bits[uc >> 6] |= (uint64_t)1 << (uc & 63);
+    if (uc < 0x80)
+        set->lo_ascii[uc & 0xf] |= (uint8_t)(1u << (uc >> 4));
+    else
+        set->lo_high[uc & 0xf] |= (uint8_t)(1u << ((uc >> 4) & 7));
+}
+
+/**
+ * @brief Initialize the set with the characters in \p chars[0, len)
+ */
+static zda_inline void zda_char_set_init_chars(zda_char_set_t *set,
+                                               char const *chars,
+                                               size_t len) zda_noexcept
+{
+    zda_char_set_init(set);
+    for (size_t i = 0; i < len; ++i) {
+        zda_char_set_add(set, chars[i]);
+    }
+}
+
+static zda_inline void zda_char_set_init_str(zda_char_set_t *set,
+                                             char const *c_str) zda_noexcept
+{
+    zda_char_set_init_chars(set, c_str, strlen(c_str));
+}
+
+/**************************/
+/* Getter */
+/**************************/
+static zda_inline zda_bool zda_char_set_contains(zda_char_set_t const *set,
+                                                 char c) zda_noexcept
+{
+    unsigned char const uc = (unsigned char)c;
+    return (zda_bool)((set->bits[uc >> 6] >> (uc & 63)) & 1);
+}
+
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
+
+#endif /* guard */
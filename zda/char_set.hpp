@@ -0,0 +1,42 @@
+#ifndef __ZDA_CHAR_SET_HPP___
+#define __ZDA_CHAR_SET_HPP___
+
+#include "zda/char_set.h"
+
+namespace zda {
+
+/**
+ * Wrapper of zda_char_set_t
+ * Used by the StringView::find_*_of() and span()/cspan()
+ */
+class CharSet {
+   public:
+    CharSet() zda_noexcept { zda_char_set_init(&set_); }
+
+    CharSet(char const *chars, size_t len) zda_noexcept
+    {
+        zda_char_set_init_chars(&set_, chars, len);
+    }
+
+    explicit CharSet(char const *c_str) zda_noexcept
+    {
+        zda_char_set_init_str(&set_, c_str);
+    }
+
+    void add(char c) zda_noexcept { zda_char_set_add(&set_, c); }
+
+    bool contains(char c) const zda_noexcept
+    {
+        return zda_char_set_contains(&set_, c);
+    }
+
+    zda_char_set_t *rep() zda_noexcept { return &set_; }
+    zda_char_set_t const *rep() const zda_noexcept { return &set_; }
+
+   private:
+    zda_char_set_t set_;
+};
+
+} // namespace zda
+
+#endif /* guard */
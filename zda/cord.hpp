@@ -0,0 +1,225 @@
+#ifndef _ZDA_CORD_HPP__
+#define _ZDA_CORD_HPP__
+
+/*
+ * Cord -- string assembled from chunks without copying
+ *
+ * A cord is a sequence of chunks, each chunk is a view into:
+ * - a refcounted buffer, which is shared between the cords(and substrings)
+ *   instead of copying the bytes, or
+ * - a borrowed memory region whose lifetime is managed by the user.
+ *
+ * The small copied fragments are packed into the tail buffer of the cord if
+ * it is not shared, so appending many short pieces doesn't make many chunks.
+ *
+ * ```cpp
+ * zda::Cord resp;
+ * resp.append(header);                   // copy
+ * resp.append_borrowed(static_body);     // no copy
+ * resp.append(std::move(large_string));  // take ownership, no copy
+ *
+ * struct iovec iov[64];
+ * while (!resp.is_empty()) {
+ *     auto n = writev(fd, iov, resp.to_iovec(iov, 64));
+ *     if (n < 0) break;
+ *     resp.remove_prefix(n);
+ * }
+ * ```
+ *
+ * The appending and prepending are O(1) amortized(the appending of a copied
+ * fragment is O(len) of course). The position-based operations(substr(),
+ * remove_prefix(), ...) are O(chunks) in the worst case.
+ *
+ * The cord is not thread-safe, but the different cords sharing the same
+ * buffers can be used in the different threads.
+ */
+#include "zda/string_view.hpp"
+#include "zda/util/export.h"
+#include "zda/util/macro.h"
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <sys/uio.h>
+
+namespace zda {
+namespace detail {
+
+/* Refcounted buffer referenced by the chunks */
+struct CordBuffer {
+    std::atomic<size_t> refcnt;
+    /* The writable space, 0 if the buffer is not owned by the cord */
+    size_t capacity;
+    size_t used;
+    char *data;
+    void (*destroy)(CordBuffer *);
+};
+
+/* The returned buffer has a reference */
+ZDA_API CordBuffer *cord_buffer_new(size_t capacity);
+ZDA_API CordBuffer *cord_buffer_from_string(std::string &&str);
+
+zda_inline void cord_buffer_ref(CordBuffer *buf) zda_noexcept
+{
+    if (buf) buf->refcnt.fetch_add(1, std::memory_order_relaxed);
+}
+
+zda_inline void cord_buffer_unref(CordBuffer *buf) zda_noexcept
+{
+    if (buf && buf->refcnt.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        buf->destroy(buf);
+}
+
+struct CordChunk {
+    /* Null if the chunk is borrowed */
+    CordBuffer *buf;
+    char const *data;
+    size_t len;
+};
+
+} // namespace detail
+
+class ZDA_API Cord {
+   public:
+    using size_type = size_t;
+
+    /* The capacity of the buffer allocated for the copied fragments */
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    /* The moved std::string under this is copied instead of being owned */
+    static constexpr size_t MOVE_THRESHOLD = 512;
+
+    Cord() zda_noexcept
+      : size_(0)
+    {
+    }
+
+    explicit Cord(StringView str)
+      : size_(0)
+    {
+        append(str);
+    }
+
+    explicit Cord(std::string &&str)
+      : size_(0)
+    {
+        append(std::move(str));
+    }
+
+    Cord(Cord const &other);
+    Cord(Cord &&other) zda_noexcept;
+    Cord &operator=(Cord const &other);
+    Cord &operator=(Cord &&other) zda_noexcept;
+    ~Cord() zda_noexcept;
+
+    size_type size() const zda_noexcept { return size_; }
+    bool is_empty() const zda_noexcept { return size_ == 0; }
+
+    size_t chunk_count() const zda_noexcept { return chunks_.size(); }
+    StringView chunk(size_t i) const zda_noexcept
+    {
+        return StringView(chunks_[i].data, chunks_[i].len);
+    }
+
+    /**
+     * @brief Call \p f with the StringView of each chunk in order
+     */
+    template <typename F>
+    void for_each_chunk(F &&f) const
+    {
+        for (auto const &chunk : chunks_)
+            f(StringView(chunk.data, chunk.len));
+    }
+
+    /**************************/
+    /* Modifiers */
+    /**************************/
+
+    /**
+     * @brief Copy the \p str to the end
+     */
+    void append(StringView str);
+    void append(char const *data, size_t len) { append(StringView(data, len)); }
+
+    /**
+     * @brief Take the ownership of \p str without copying if it is large
+     */
+    void append(std::string &&str);
+
+    /**
+     * @brief Share the chunks of \p cord, no bytes are copied
+     */
+    void append(Cord const &cord);
+    void append(Cord &&cord);
+
+    /**
+     * @brief Reference the \p str without copying
+     * The \p str must be alive until it is removed from all cords
+     * sharing it.
+     */
+    void append_borrowed(StringView str);
+
+    void prepend(StringView str);
+    void prepend(std::string &&str);
+    void prepend(Cord const &cord);
+    void prepend_borrowed(StringView str);
+
+    void remove_prefix(size_t n) zda_noexcept;
+    void remove_suffix(size_t n) zda_noexcept;
+    void clear() zda_noexcept;
+
+    /**
+     * @brief Return the cord references the [pos, pos+n) without copying
+     * The range is clamped to the size.
+     */
+    Cord substr(size_t pos, size_t n) const;
+
+    /**************************/
+    /* Output */
+    /**************************/
+
+    /**
+     * @brief Fill the first \p iovcnt chunks to \p iov
+     * @return The number of filled iovec
+     */
+    size_t to_iovec(struct iovec *iov, size_t iovcnt) const zda_noexcept;
+
+    /**
+     * @brief Copy the first \p n bytes at most to \p buf
+     * @return The copied size
+     */
+    size_t copy_to(char *buf, size_t n) const zda_noexcept;
+
+    void append_to(std::string *p_str) const;
+    std::string to_string() const;
+
+    /**
+     * @brief Merge all the chunks into one buffer
+     * @return The view of the whole content, valid until the cord is modified
+     */
+    StringView flatten();
+
+    bool equals(StringView str) const zda_noexcept;
+
+   private:
+    void push_back_chunk(detail::CordChunk chunk);
+    void push_front_chunk(detail::CordChunk chunk);
+    void unref_all() zda_noexcept;
+
+    std::deque<detail::CordChunk> chunks_;
+    size_t size_;
+};
+
+zda_inline bool operator==(Cord const &lhs, StringView rhs) zda_noexcept
+{
+    return lhs.equals(rhs);
+}
+
+zda_inline bool operator!=(Cord const &lhs, StringView rhs) zda_noexcept
+{
+    return !lhs.equals(rhs);
+}
+
+} // namespace zda
+
+#endif /* guard */
@@ -66,15 +66,16 @@ static zda_inline zda_delist_node_t *zda_delist_front(zda_delist_t *dl) zda_noex
     return zda_slist_front(&dl->list);
 }
 
+/* The tail_before is the last node, or the header if the list is empty */
 static zda_inline zda_delist_node_t *zda_delist_back(zda_delist_t *dl) zda_noexcept
 {
-    return dl->tail_before->next;
+    return zda_delist_is_empty(dl) ? NULL : dl->tail_before;
 }
 
 static zda_inline zda_delist_node_t const *zda_delist_back_const(zda_delist_t const *dl
 ) zda_noexcept
 {
-    return dl->tail_before->next;
+    return zda_delist_is_empty(dl) ? NULL : dl->tail_before;
 }
 /****************************/
 /* Insert APIs */
@@ -184,6 +185,69 @@ zda_inline zda_bool zda_delist_is_terminator(zda_delist_node_t const *node) zda_
         }                                                                                          \
     } while (0)
 
+/*****************************/
+/* Sort APIs */
+/*****************************/
+/* See zda_slist_sort_inplace(), the tail is updated */
+#define zda_delist_sort_inplace(dl, type, cmp)                                                     \
+    do {                                                                                           \
+        zda_delist_t      *__sort_dl = (dl);                                                       \
+        zda_delist_node_t *__sort_tail;                                                            \
+        _zda_chain_merge_sort(                                                                     \
+            zda_delist_node_t,                                                                     \
+            __sort_dl->list.node.next,                                                             \
+            __sort_tail,                                                                           \
+            zda_delist_entry,                                                                      \
+            type,                                                                                  \
+            cmp                                                                                    \
+        );                                                                                         \
+        __sort_dl->tail_before = __sort_tail ? __sort_tail : &__sort_dl->list.node;                \
+    } while (0)
+
+/* See zda_slist_radix_sort_inplace(), the tail is updated */
+#define zda_delist_radix_sort_inplace(dl, type, key_of)                                            \
+    do {                                                                                           \
+        zda_delist_t      *__sort_dl = (dl);                                                       \
+        zda_delist_node_t *__sort_tail;                                                            \
+        _zda_chain_radix_sort(                                                                     \
+            zda_delist_node_t,                                                                     \
+            __sort_dl->list.node.next,                                                             \
+            __sort_tail,                                                                           \
+            zda_delist_entry,                                                                      \
+            type,                                                                                  \
+            key_of                                                                                 \
+        );                                                                                         \
+        __sort_dl->tail_before = __sort_tail ? __sort_tail : &__sort_dl->list.node;                \
+    } while (0)
+
+static zda_inline void zda_delist_sort(zda_delist_t *dl, zda_slist_sort_cmp_t cmp)
+{
+    zda_delist_node_t *tail;
+    _zda_chain_merge_sort(
+        zda_delist_node_t,
+        dl->list.node.next,
+        tail,
+        _zda_sort_node_self,
+        zda_delist_node_t,
+        cmp
+    );
+    dl->tail_before = tail ? tail : &dl->list.node;
+}
+
+static zda_inline void zda_delist_radix_sort(zda_delist_t *dl, zda_slist_sort_key_t key_of)
+{
+    zda_delist_node_t *tail;
+    _zda_chain_radix_sort(
+        zda_delist_node_t,
+        dl->list.node.next,
+        tail,
+        _zda_sort_node_self,
+        zda_delist_node_t,
+        key_of
+    );
+    dl->tail_before = tail ? tail : &dl->list.node;
+}
+
 /***************************/
 /* Destroy APIs            */
 /***************************/
@@ -2,7 +2,11 @@
 #ifndef _ZDA_DJ_SET_H__
 #define _ZDA_DJ_SET_H__
 
-#include "util/macro.h"
+#include "zda/util/macro.h"
+#include "zda/util/export.h"
+#include "zda/util/bool.h"
+#include <stddef.h>
+#include <stdint.h>
 
 // @FYI [CRLS 4th] ch19 Data Structures for Disjoint Sets
 
@@ -10,6 +14,11 @@
  * @brief The disjoint set representive
  * The node don't hold the children pointers.
  * The FIND_SET procedure only interest in the path of parent to root.
+ *
+ * The \p rank is the upper bound of the height if the set is unioned by
+ * rank(`zda_dj_set_union()`), or the number of nodes in the set if the set
+ * is unioned by size(`zda_dj_set_union_size()`).
+ * Only the value of root is meaningful, don't mix the two kinds of union.
  */
 typedef struct zda_dj_set_node {
     struct zda_dj_set_node *parent;
@@ -18,7 +27,9 @@ typedef struct zda_dj_set_node {
 
 #define ZDA_DJ_SET_HOOK zda_dj_set_node_t node;
 
+#ifdef __cplusplus
 EXTERN_C_BEGIN
+#endif
 
 static zda_inline void zda_dj_set_init(zda_dj_set_node_t *node) zda_noexcept
 {
@@ -26,8 +37,18 @@ static zda_inline void zda_dj_set_init(zda_dj_set_node_t *node) zda_noexcept
     node->rank = 0;
 }
 
+/**
+ * @brief Init the \p node as a singleton set that unioned by size
+ */
+static zda_inline void zda_dj_set_init_size(zda_dj_set_node_t *node) zda_noexcept
+{
+    node->parent = node;
+    node->rank = 1;
+}
+
 /**
  * @brief Find the root node of the \p node belonging set
+ * The path is not changed, it is useful if the nodes are read-only.
  */
 static zda_inline zda_dj_set_node_t *
 zda_dj_set_find(zda_dj_set_node_t *node) zda_noexcept
@@ -38,17 +59,164 @@ zda_dj_set_find(zda_dj_set_node_t *node) zda_noexcept
     return node;
 }
 
+/**
+ * @brief Like `zda_dj_set_find()` but make every other node on the path
+ * point to its grandparent(path halving).
+ *
+ * It is one-pass, and has the same amortized complexity as the two-pass
+ * full path compression when combined with union by rank or size.
+ */
+static zda_inline zda_dj_set_node_t *
+zda_dj_set_find_halving(zda_dj_set_node_t *node) zda_noexcept
+{
+    while (node->parent != node) {
+        node->parent = node->parent->parent;
+        node = node->parent;
+    }
+    return node;
+}
+
+/**
+ * @brief Like `zda_dj_set_find()` but make every node on the path
+ * point to its grandparent(path splitting).
+ */
+static zda_inline zda_dj_set_node_t *
+zda_dj_set_find_splitting(zda_dj_set_node_t *node) zda_noexcept
+{
+    zda_dj_set_node_t *next;
+    while (node->parent != node) {
+        next = node->parent;
+        node->parent = next->parent;
+        node = next;
+    }
+    return node;
+}
+
+/**
+ * @brief Check whether the \p lnode and \p rnode are belonging same set
+ */
+static zda_inline zda_bool
+zda_dj_set_same(zda_dj_set_node_t *lnode, zda_dj_set_node_t *rnode) zda_noexcept
+{
+    return zda_dj_set_find_halving(lnode) == zda_dj_set_find_halving(rnode);
+}
+
 /**
  * @brief Union the two set where the \p lnode and \p rnode belonging
+ * The lower rank set is linked to the higher one.
  * @return 
  * NULL - the two node are belonging same set
  * otherwise, the root of new set
  */
-zda_dj_set_node_t *
+ZDA_API zda_dj_set_node_t *
 zda_dj_set_union(zda_dj_set_node_t *lnode,
                  zda_dj_set_node_t *rnode) zda_noexcept;
 
+/**
+ * @brief Like `zda_dj_set_union()` but the smaller set is linked to the larger one
+ * The nodes must be initialized by `zda_dj_set_init_size()`.
+ */
+ZDA_API zda_dj_set_node_t *
+zda_dj_set_union_size(zda_dj_set_node_t *lnode,
+                      zda_dj_set_node_t *rnode) zda_noexcept;
+
+/**
+ * @brief Get the number of nodes in the set where \p node belonging
+ * The set must be unioned by size.
+ */
+static zda_inline size_t zda_dj_set_get_size(zda_dj_set_node_t *node) zda_noexcept
+{
+    return zda_dj_set_find_halving(node)->rank;
+}
+
+/**********************************************/
+/* Concurrent APIs */
+/**********************************************/
+/*
+ * The following APIs can be called by multiple threads on the same nodes simultaneously.
+ * They are lock-free: the links are only changed by CAS on the parent pointer.
+ *
+ * - The root is linked by `CAS(root->parent, root, new_root)`, so the link fails if
+ *   the root has been linked by another thread, then retry.
+ * - The find uses path halving that replace the parent with the grandparent by CAS,
+ *   the failed CAS is ignored since the grandparent is still an ancestor.
+ * - The rank can't be updated with the parent atomically, thus the roots are linked by
+ *   the randomized priority which is a bijective hash of the node address. The expected
+ *   height is O(logn) like union by rank.
+ *
+ * The nodes must be initialized by `zda_dj_set_init()` before they are shared and the
+ * \p rank is not used. Don't mix these APIs with the non-concurrent union at the same time.
+ *
+ * Reference: Siddhartha V. Jayanti, Robert E. Tarjan. A Randomized Concurrent Algorithm
+ * for Disjoint Set Union.
+ */
+static zda_inline zda_dj_set_node_t *
+_zda_dj_set_load_parent(zda_dj_set_node_t *node) zda_noexcept
+{
+    return __atomic_load_n(&node->parent, __ATOMIC_ACQUIRE);
+}
+
+static zda_inline zda_bool _zda_dj_set_cas_parent(zda_dj_set_node_t *node,
+                                                  zda_dj_set_node_t *expected,
+                                                  zda_dj_set_node_t *desired) zda_noexcept
+{
+    return __atomic_compare_exchange_n(&node->parent, &expected, desired, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+/* The finalizer of MurmurHash3, it is a bijection */
+static zda_inline uint64_t _zda_dj_set_priority(zda_dj_set_node_t const *node) zda_noexcept
+{
+    uint64_t x = (uint64_t)(uintptr_t)node;
+    x ^= x >> 33;
+    x *= UINT64_C(0xff51afd7ed558ccd);
+    x ^= x >> 33;
+    x *= UINT64_C(0xc4ceb9fe1a85ec53);
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * @brief Concurrent version of `zda_dj_set_find_halving()`
+ * @return The root at some moment during the call
+ */
+static zda_inline zda_dj_set_node_t *
+zda_dj_set_cfind(zda_dj_set_node_t *node) zda_noexcept
+{
+    zda_dj_set_node_t *parent;
+    zda_dj_set_node_t *grand;
+
+    for (;;) {
+        parent = _zda_dj_set_load_parent(node);
+        if (parent == node) return node;
+        grand = _zda_dj_set_load_parent(parent);
+        if (grand != parent) {
+            _zda_dj_set_cas_parent(node, parent, grand);
+        }
+        node = grand;
+    }
+}
+
+/**
+ * @brief Concurrent version of `zda_dj_set_union()`
+ * @return
+ * NULL - the two node are belonging same set
+ * otherwise, the root of new set when the link is done
+ */
+ZDA_API zda_dj_set_node_t *
+zda_dj_set_cunion(zda_dj_set_node_t *lnode,
+                  zda_dj_set_node_t *rnode) zda_noexcept;
+
+/**
+ * @brief Concurrent version of `zda_dj_set_same()`
+ * The result is linearizable: there is a moment during the call such that
+ * the two nodes are belonging same set or not.
+ */
+ZDA_API zda_bool zda_dj_set_csame(zda_dj_set_node_t *lnode,
+                                  zda_dj_set_node_t *rnode) zda_noexcept;
 
+#ifdef __cplusplus
 EXTERN_C_END
+#endif
 
 #endif // Header Guard
\ No newline at end of file
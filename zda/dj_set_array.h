@@ -0,0 +1,119 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_DJ_SET_ARRAY_H__
+#define _ZDA_DJ_SET_ARRAY_H__
+
+#include "zda/util/macro.h"
+#include "zda/util/export.h"
+#include "zda/util/bool.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The disjoint set of the dense integer domain [0, n)
+ * Unlike `zda_dj_set_node_t`(see dj_set.h), the element is an index instead of a node,
+ * the parent index and the rank are stored in two parallel arrays.
+ * Thus, an element costs 5 bytes instead of 16 bytes and the bulk operations
+ * access the arrays sequentially.
+ *
+ * The rank is the upper bound of the height, it never exceeds 32 and fits in a byte.
+ */
+typedef struct zda_dj_set_array {
+    uint32_t *parent;
+    uint8_t *rank;
+    uint32_t n;
+} zda_dj_set_array_t;
+
+/* Indicates the invalid element, so the max element count is UINT32_MAX */
+#define ZDA_DJ_SET_ARRAY_NONE UINT32_MAX
+
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
+/**
+ * @brief Init the \p n singleton sets
+ * @return
+ * zda_false - Failed to allocate the arrays
+ */
+ZDA_API zda_bool zda_dj_set_array_init(zda_dj_set_array_t *set, uint32_t n) zda_noexcept;
+
+ZDA_API void zda_dj_set_array_destroy(zda_dj_set_array_t *set) zda_noexcept;
+
+static zda_inline uint32_t zda_dj_set_array_get_count(zda_dj_set_array_t const *set) zda_noexcept
+{
+    return set->n;
+}
+
+/**
+ * @brief Find the root of the set where \p x belonging
+ * The path is compressed by path halving.
+ */
+static zda_inline uint32_t
+zda_dj_set_array_find(zda_dj_set_array_t *set, uint32_t x) zda_noexcept
+{
+    uint32_t *parent = set->parent;
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/**
+ * @brief Union the two set where the \p x and \p y belonging by rank
+ * @return
+ * ZDA_DJ_SET_ARRAY_NONE - the two element are belonging same set
+ * otherwise, the root of new set
+ */
+static zda_inline uint32_t
+zda_dj_set_array_union(zda_dj_set_array_t *set, uint32_t x, uint32_t y) zda_noexcept
+{
+    uint32_t tmp;
+
+    x = zda_dj_set_array_find(set, x);
+    y = zda_dj_set_array_find(set, y);
+    if (x == y) return ZDA_DJ_SET_ARRAY_NONE;
+
+    /* Make x is the higher one */
+    if (set->rank[x] < set->rank[y]) {
+        tmp = x;
+        x = y;
+        y = tmp;
+    }
+    set->parent[y] = x;
+    if (set->rank[x] == set->rank[y]) {
+        set->rank[x]++;
+    }
+    return x;
+}
+
+static zda_inline zda_bool
+zda_dj_set_array_same(zda_dj_set_array_t *set, uint32_t x, uint32_t y) zda_noexcept
+{
+    return zda_dj_set_array_find(set, x) == zda_dj_set_array_find(set, y);
+}
+
+/**
+ * @brief Union the endpoints of the \p n edges
+ * @param edges The edge list, edges[2i] and edges[2i+1] are the endpoints of edge i
+ * @return The number of the unions that merge two different sets
+ */
+ZDA_API size_t zda_dj_set_array_union_edges(zda_dj_set_array_t *set,
+                                            uint32_t const *edges,
+                                            size_t n) zda_noexcept;
+
+/**
+ * @brief Compress all paths and produce the canonical component IDs
+ * The components are numbered in [0, count) by the order of their first element,
+ * i.e. the result don't depend on the union order.
+ * After this, the parent of every element is the root.
+ * @param ids The output array has at least `zda_dj_set_array_get_count()` elements
+ * @return The number of components
+ */
+ZDA_API uint32_t zda_dj_set_array_flatten(zda_dj_set_array_t *set, uint32_t *ids) zda_noexcept;
+
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
+
+#endif // Header Guard
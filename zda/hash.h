@@ -0,0 +1,78 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_HASH_H__
+#define _ZDA_HASH_H__
+
+/*
+ * Non-cryptographic hash functions
+ *
+ * - zda_hash_bytes(): wyhash-style mixing by 64x64->128 multiply for the
+ *   short and medium inputs(the inputs under 16 bytes are read by two
+ *   overlapping loads, no byte loop), and XXH3-style stripe accumulation
+ *   vectorized by SSE2/AVX2 for the long inputs.
+ *   The result doesn't depend on the selected kernel.
+ * - zda_hash_u64()/zda_hash_u32(): full avalanche integer mixers, so that
+ *   the low bits are good enough for the power-of-two bucket mask.
+ *
+ * The hash values are not stable across the versions and platforms,
+ * don't persist them.
+ */
+#include "zda/string_view.h"
+#include "zda/util/export.h"
+#include "zda/util/macro.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
+/**
+ * @brief Hash the \p data[0, len) with \p seed
+ */
+ZDA_API uint64_t zda_hash_bytes(void const *data, size_t len,
+                                uint64_t seed) zda_noexcept;
+
+static zda_inline uint64_t zda_hash_str(char const *str) zda_noexcept
+{
+    return zda_hash_bytes(str, strlen(str), 0);
+}
+
+static zda_inline uint64_t
+zda_hash_string_view(zda_string_view_t const *view) zda_noexcept
+{
+    return zda_hash_bytes(view->data, view->len, 0);
+}
+
+/* The finalizer of MurmurHash3, every input bit affects every output bit */
+static zda_inline uint64_t zda_hash_u64(uint64_t x) zda_noexcept
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static zda_inline uint64_t zda_hash_u32(uint32_t x) zda_noexcept
+{
+    return zda_hash_u64(x);
+}
+
+/**
+ * @brief Combine the hash \p h to \p seed, used for the composite keys
+ */
+static zda_inline uint64_t zda_hash_combine(uint64_t seed,
+                                            uint64_t h) zda_noexcept
+{
+    return zda_hash_u64(seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) +
+                                (seed >> 2)));
+}
+
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
+
+#endif /* guard */
@@ -0,0 +1,98 @@
+#ifndef _ZDA_HASH_HPP__
+#define _ZDA_HASH_HPP__
+
+#include "zda/hash.h"
+#include "zda/string_view.hpp"
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#if __cplusplus >= 201703L
+#    include <string_view>
+#endif
+
+namespace zda {
+
+/**
+ * Hash functor usable as the Hash template parameter of the zda::Ht,
+ * zda::AvlHt and the std unordered containers.
+ *
+ * - Integers, enums and pointers are mixed by zda_hash_u64(), unlike the
+ *   identity std::hash of libstdc++, the low bits are well distributed.
+ * - StringView, zda_string_view_t, std::string and std::string_view are
+ *   hashed by zda_hash_bytes(). They hash equally for the same content.
+ * - The other types fall back to the std::hash<T>.
+ */
+template <typename T, typename = void>
+struct Hash : std::hash<T> {};
+
+template <typename T>
+struct Hash<
+    T,
+    typename std::enable_if<std::is_integral<T>::value ||
+                            std::is_enum<T>::value>::type> {
+    size_t operator()(T x) const zda_noexcept
+    {
+        return (size_t)zda_hash_u64((uint64_t)x);
+    }
+};
+
+template <typename T>
+struct Hash<T *> {
+    size_t operator()(T *p) const zda_noexcept
+    {
+        return (size_t)zda_hash_u64((uint64_t)(uintptr_t)p);
+    }
+};
+
+template <typename T>
+struct Hash<T,
+            typename std::enable_if<std::is_same<T, float>::value ||
+                                    std::is_same<T, double>::value>::type> {
+    size_t operator()(T x) const zda_noexcept
+    {
+        /* 0.0 and -0.0 are equal */
+        if (x == 0) return (size_t)zda_hash_u64(0);
+        return (size_t)zda_hash_bytes(&x, sizeof x, 0);
+    }
+};
+
+template <>
+struct Hash<StringView> {
+    size_t operator()(StringView str) const zda_noexcept
+    {
+        return (size_t)zda_hash_bytes(str.data(), str.size(), 0);
+    }
+};
+
+template <>
+struct Hash<zda_string_view_t> {
+    size_t operator()(zda_string_view_t const &str) const zda_noexcept
+    {
+        return (size_t)zda_hash_string_view(&str);
+    }
+};
+
+template <>
+struct Hash<std::string> {
+    size_t operator()(std::string const &str) const zda_noexcept
+    {
+        return (size_t)zda_hash_bytes(str.data(), str.size(), 0);
+    }
+};
+
+#if __cplusplus >= 201703L
+template <>
+struct Hash<std::string_view> {
+    size_t operator()(std::string_view str) const zda_noexcept
+    {
+        return (size_t)zda_hash_bytes(str.data(), str.size(), 0);
+    }
+};
+#endif
+
+} // namespace zda
+
+#endif /* guard */
@@ -156,7 +156,7 @@ ZDA_API void zda_ht_insert_commit(zda_ht_t *ht, zda_ht_commit_ctx_t *p_ctx, zda_
 #define zda_ht_insert_commit_inplace(ht, commit_ctx, _node)                                        \
   do {                                                                                             \
     zda_ht_t *__ht = ht;                                                                           \
-    assert(!zda_ht_is_empty(__ht));                                                                \
+    assert(__ht->tb != NULL);                                                                      \
     zda_ht_list_t *p_insert_list = &__ht->tb[(commit_ctx).bkt_idx];                                \
     (_node)->next                = p_insert_list->node.next;                                       \
     p_insert_list->node.next     = (_node);                                                        \
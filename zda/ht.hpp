@@ -1,6 +1,7 @@
 #ifndef _ZDA_HT_HPP__
 #define _ZDA_HT_HPP__
 
+#include "zda/hash.hpp"
 #include "zda/util/functor.hpp"
 #include "zda/util/map_functor.hpp"
 #include <zda/ht.h>
@@ -14,7 +15,7 @@ template <
     typename Entry,
     typename Key,
     typename GetKey = GetKey<Entry, Key>,
-    typename Hash   = std::hash<Key>,
+    typename Hash   = zda::Hash<Key>,
     typename Equal  = std::equal_to<Key>,
     typename Free   = LibcFree<Entry>>
 class Ht
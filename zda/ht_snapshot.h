@@ -0,0 +1,168 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_HT_SNAPSHOT_H__
+#define _ZDA_HT_SNAPSHOT_H__
+
+#include "zda/ht.h"
+#include "zda/util/export.h"
+#include "zda/util/macro.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
+/*
+ * Relocatable snapshot of the zda_ht_t
+ *
+ * The snapshot is written in one pass over the hash table and can be opened by mmap() for
+ * read-only lookups without deserialization, i.e. the cold start is warmed up by the page
+ * faults instead of re-inserting all entries.
+ *
+ * Layout(all integers are uint64_t in the native byte order, checked when opening):
+ * ```
+ * | header(64 bytes) | bucket offsets[bkt_capa + 1] | records |
+ * ```
+ * The records of bucket i are packed in [offsets[i], offsets[i+1]), every offset is relative
+ * to the start of the snapshot. A record is its length followed by the bytes serialized by the
+ * user, padded to 8 bytes, so the record bytes are 8-byte aligned.
+ *
+ * The bucket of an entry is same as the one in the source table, so the hash function used to
+ * search must be same as the one building the table and deterministic across the
+ * processes(e.g. zda_hash_bytes(), not seeded by a random value).
+ */
+
+typedef struct zda_ht_snapshot {
+  char const     *base;
+  size_t          size;
+  uint64_t const *bkts;
+  size_t          bkt_capa;
+  size_t          cnt;
+  size_t          mask;
+  zda_bool        mapped;
+} zda_ht_snapshot_t;
+
+/* The view of serialized entry in the snapshot */
+typedef struct zda_ht_record {
+  void const *data;
+  size_t      len;
+} zda_ht_record_t;
+
+/**
+ * @brief Serialize the entry of \p node to \p buf[0, n)
+ * @return The required size. If it is greater than \p n, the callback is called again with
+ * a buffer large enough. Return (size_t)-1 to abort the writing.
+ */
+typedef size_t (*zda_ht_serialize_cb_t)(zda_ht_node_t const *node, void *buf, size_t n, void *ctx);
+
+/**
+ * @brief Write the snapshot of \p ht to \p fp at its current position
+ * The \p fp must be seekable.
+ * @return 0 if success, otherwise -1
+ */
+ZDA_API int zda_ht_snapshot_write(
+    zda_ht_t const       *ht,
+    FILE                 *fp,
+    zda_ht_serialize_cb_t serialize,
+    void                 *ctx
+) zda_noexcept;
+
+/**
+ * @brief Open the snapshot file by mmap()
+ * The snapshot must be written at the beginning of the file.
+ * @return 0 if success, otherwise -1(the file is not accessible or the format is invalid)
+ */
+ZDA_API int zda_ht_snapshot_open(zda_ht_snapshot_t *snap, char const *path) zda_noexcept;
+
+/**
+ * @brief Initialize the snapshot from the memory \p base[0, size) which must be 8-byte aligned
+ * The memory is not owned by the snapshot.
+ * @return 0 if success, otherwise -1(the format is invalid)
+ */
+ZDA_API int
+zda_ht_snapshot_init(zda_ht_snapshot_t *snap, void const *base, size_t size) zda_noexcept;
+
+/**
+ * @brief Unmap the snapshot if it is opened by zda_ht_snapshot_open()
+ */
+ZDA_API void zda_ht_snapshot_close(zda_ht_snapshot_t *snap) zda_noexcept;
+
+static zda_inline size_t zda_ht_snapshot_get_count(zda_ht_snapshot_t const *snap) zda_noexcept
+{
+  return snap->cnt;
+}
+
+static zda_inline zda_bool zda_ht_snapshot_is_empty(zda_ht_snapshot_t const *snap) zda_noexcept
+{
+  return snap->cnt == 0;
+}
+
+static zda_inline zda_ht_record_t
+_zda_ht_snapshot_record_at(zda_ht_snapshot_t const *snap, uint64_t off) zda_noexcept
+{
+  zda_ht_record_t rec;
+  rec.len  = (size_t)(*(uint64_t const *)(snap->base + off));
+  rec.data = snap->base + off + sizeof(uint64_t);
+  return rec;
+}
+
+static zda_inline uint64_t _zda_ht_snapshot_record_stride(size_t len) zda_noexcept
+{
+  return sizeof(uint64_t) + ((len + 7) & ~(uint64_t)7);
+}
+
+/**
+ * @brief Same as the zda_ht_search_inplace() but search in the snapshot
+ * The \p hash and \p cmp are same as the ones of the source table, and the \p get_key gets the
+ * key from the record, signature: key_type get_key(zda_ht_record_t const *rec).
+ * @param[out] result_record (zda_ht_record_t) The data is NULL if not found
+ */
+#define zda_ht_snapshot_search_inplace(snap, key, get_key, hash, cmp, result_record)              \
+  do {                                                                                             \
+    zda_ht_snapshot_t const *__snap = snap;                                                        \
+    (result_record).data            = NULL;                                                        \
+    (result_record).len             = 0;                                                           \
+    if (zda_ht_snapshot_is_empty(__snap)) {                                                        \
+      break;                                                                                       \
+    }                                                                                              \
+    size_t   __bkt_idx = hash(key) & __snap->mask;                                                 \
+    uint64_t __end     = __snap->bkts[__bkt_idx + 1];                                              \
+    for (uint64_t __off = __snap->bkts[__bkt_idx]; __off < __end;) {                               \
+      zda_ht_record_t __rec = _zda_ht_snapshot_record_at(__snap, __off);                           \
+      if (cmp(get_key(&__rec), key)) {                                                             \
+        result_record = __rec;                                                                     \
+        break;                                                                                     \
+      }                                                                                            \
+      __off += _zda_ht_snapshot_record_stride(__rec.len);                                          \
+    }                                                                                              \
+  } while (0)
+
+/**
+ * @brief Iterate all records in the bucket order, \p rec is the zda_ht_record_t variable
+ */
+#define zda_ht_snapshot_iterate(snap, rec)                                                         \
+  for (uint64_t __off = (snap)->bkts[0];                                                           \
+       __off < (snap)->bkts[(snap)->bkt_capa] &&                                                   \
+       ((rec) = _zda_ht_snapshot_record_at((snap), __off), 1);                                     \
+       __off += _zda_ht_snapshot_record_stride((rec).len))
+
+/************************************/
+/* Wrapper macro */
+/************************************/
+#define zda_decl_ht_snapshot_search(func_name, key_type)                                           \
+  zda_ht_record_t func_name(zda_ht_snapshot_t const *snap, key_type key) zda_noexcept
+
+#define zda_def_ht_snapshot_search(func_name, key_type, get_key, hash, cmp)                        \
+  zda_decl_ht_snapshot_search(func_name, key_type)                                                 \
+  {                                                                                                \
+    zda_ht_record_t result;                                                                        \
+    zda_ht_snapshot_search_inplace(snap, key, get_key, hash, cmp, result);                         \
+    return result;                                                                                 \
+  }
+
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
+
+#endif /* Header guard */
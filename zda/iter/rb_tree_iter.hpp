@@ -76,9 +76,9 @@ struct RbTreeIterator {
     {
     }
 
-    operator RbTreeIterator<EntryType>() noexcept
+    operator RbTreeConstIterator<EntryType>() noexcept
     {
-        return RbTreeIterator<EntryType>(header_, node_);
+        return RbTreeConstIterator<EntryType>(header_, node_);
     }
 
     RbTreeIterator &operator++() noexcept
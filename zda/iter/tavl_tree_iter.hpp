@@ -0,0 +1,128 @@
+#ifndef _ZDA_TAVL_TREE_ITER_HPP__
+#define _ZDA_TAVL_TREE_ITER_HPP__
+
+#include "zda/tavl_tree.h"
+
+namespace zda {
+
+template <typename EntryType>
+struct TavlTreeConstIterator {
+ public:
+    TavlTreeConstIterator(zda_tavl_node_t const *node) noexcept
+      : node_((zda_tavl_node_t *)node)
+    {
+    }
+
+    TavlTreeConstIterator &operator++() noexcept
+    {
+        node_ = zda_tavl_node_get_next(node_);
+        return *this;
+    }
+
+    TavlTreeConstIterator &operator--() noexcept
+    {
+        node_ = zda_tavl_node_get_prev(node_);
+        return *this;
+    }
+
+    TavlTreeConstIterator operator++(int) noexcept
+    {
+        auto ret = *this;
+        node_    = zda_tavl_node_get_next(node_);
+        return ret;
+    }
+
+    TavlTreeConstIterator operator--(int) noexcept
+    {
+        auto ret = *this;
+        node_    = zda_tavl_node_get_prev(node_);
+        return ret;
+    }
+
+    EntryType const &operator*() noexcept { return *zda_tavl_entry(node_, EntryType); }
+    EntryType const &operator*() const noexcept
+    {
+        return *(static_cast<TavlTreeConstIterator *>(this));
+    }
+
+    EntryType const *operator->() noexcept { return zda_tavl_entry(node_, EntryType); }
+    EntryType const *operator->() const noexcept { return zda_tavl_entry(node_, EntryType); }
+
+    zda_tavl_node_t const *node() const noexcept { return node_; }
+    zda_tavl_node_t       *node() noexcept { return node_; }
+
+    friend zda_inline bool operator==(TavlTreeConstIterator lhs, TavlTreeConstIterator rhs) noexcept
+    {
+        return lhs.node_ == rhs.node_;
+    }
+
+    friend zda_inline bool operator!=(TavlTreeConstIterator lhs, TavlTreeConstIterator rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+ private:
+    zda_tavl_node_t *node_;
+};
+
+template <typename EntryType>
+struct TavlTreeIterator {
+ public:
+    TavlTreeIterator(zda_tavl_node_t *node) noexcept
+      : node_(node)
+    {
+    }
+
+    operator TavlTreeConstIterator<EntryType>() const noexcept { return node_; }
+
+    TavlTreeIterator &operator++() noexcept
+    {
+        node_ = zda_tavl_node_get_next(node_);
+        return *this;
+    }
+
+    TavlTreeIterator &operator--() noexcept
+    {
+        node_ = zda_tavl_node_get_prev(node_);
+        return *this;
+    }
+
+    TavlTreeIterator operator++(int) noexcept
+    {
+        auto ret = *this;
+        node_    = zda_tavl_node_get_next(node_);
+        return ret;
+    }
+
+    TavlTreeIterator operator--(int) noexcept
+    {
+        auto ret = *this;
+        node_    = zda_tavl_node_get_prev(node_);
+        return ret;
+    }
+
+    EntryType       &operator*() noexcept { return *zda_tavl_entry(node_, EntryType); }
+    EntryType const &operator*() const noexcept { return *(static_cast<TavlTreeIterator *>(this)); }
+
+    EntryType       *operator->() noexcept { return zda_tavl_entry(node_, EntryType); }
+    EntryType const *operator->() const noexcept { return zda_tavl_entry(node_, EntryType); }
+
+    zda_tavl_node_t const *node() const noexcept { return node_; }
+    zda_tavl_node_t       *node() noexcept { return node_; }
+
+    friend zda_inline bool operator==(TavlTreeIterator lhs, TavlTreeIterator rhs) noexcept
+    {
+        return lhs.node_ == rhs.node_;
+    }
+
+    friend zda_inline bool operator!=(TavlTreeIterator lhs, TavlTreeIterator rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+ private:
+    zda_tavl_node_t *node_;
+};
+} // namespace zda
+
+#endif
@@ -0,0 +1,164 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_LF_STACK_H__
+#define _ZDA_LF_STACK_H__
+
+#include "zda/slist.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
+/*
+ * Lock-free intrusive stack(Treiber stack) of the zda_slist_node_t
+ *
+ * All operations can be called by multiple threads simultaneously.
+ *
+ * The top is paired with a tag that is increased by every pop, and the pair is replaced by a
+ * double-width CAS. Thus the classic ABA problem(the top is popped and pushed again between the
+ * read and the CAS of another pop) is detected by the changed tag.
+ *
+ * The pop reads the next of the top that may be popped by another thread meanwhile, so the
+ * memory of nodes must be readable while the stack is shared, e.g. the nodes of an object pool
+ * are reused but never freed. The read value is discarded in the case since the CAS fails.
+ *
+ * On x86-64 the CAS is the cmpxchg16b, no -mcx16 or libatomic is required. On the other
+ * platforms the __atomic builtin is used, it may be implemented by libatomic.
+ */
+typedef struct zda_lf_stack {
+    zda_slist_node_t *top;
+    uintptr_t         tag;
+} __attribute__((aligned(2 * sizeof(void *)))) zda_lf_stack_t;
+
+static zda_inline void zda_lf_stack_init(zda_lf_stack_t *stk) zda_noexcept
+{
+    stk->top = NULL;
+    stk->tag = 0;
+}
+
+/* TSan can't see the inline asm, use the builtin so it tracks the CAS */
+#if defined(__SANITIZE_THREAD__)
+#  define _ZDA_LF_STACK_TSAN 1
+#elif defined(__has_feature)
+#  if __has_feature(thread_sanitizer)
+#    define _ZDA_LF_STACK_TSAN 1
+#  endif
+#endif
+#ifndef _ZDA_LF_STACK_TSAN
+#  define _ZDA_LF_STACK_TSAN 0
+#endif
+
+/* The two words may be torn, the CAS fixes it up */
+static zda_inline void _zda_lf_stack_load(zda_lf_stack_t *stk, zda_lf_stack_t *out) zda_noexcept
+{
+    out->tag = __atomic_load_n(&stk->tag, __ATOMIC_ACQUIRE);
+    out->top = __atomic_load_n(&stk->top, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Replace the \p stk with (\p top, \p tag) if it is equal to \p expected
+ * Otherwise, the \p expected is updated to the current value.
+ */
+static zda_inline zda_bool _zda_lf_stack_cas(
+    zda_lf_stack_t   *stk,
+    zda_lf_stack_t   *expected,
+    zda_slist_node_t *top,
+    uintptr_t         tag
+) zda_noexcept
+{
+#if defined(__x86_64__) && !_ZDA_LF_STACK_TSAN
+    zda_bool ok;
+    __asm__ __volatile__("lock cmpxchg16b %1\n\t"
+                         "sete %0"
+                         : "=q"(ok), "+m"(*stk), "+a"(expected->top), "+d"(expected->tag)
+                         : "b"(top), "c"(tag)
+                         : "memory", "cc");
+    return ok;
+#else
+    zda_lf_stack_t desired;
+    desired.top = top;
+    desired.tag = tag;
+    return __atomic_compare_exchange(
+        stk,
+        expected,
+        &desired,
+        0,
+        __ATOMIC_ACQ_REL,
+        __ATOMIC_ACQUIRE
+    );
+#endif
+}
+
+/**
+ * @brief Push the chain [\p first, \p last] linked by next to the top
+ */
+static zda_inline void zda_lf_stack_push_chain(
+    zda_lf_stack_t   *stk,
+    zda_slist_node_t *first,
+    zda_slist_node_t *last
+) zda_noexcept
+{
+    zda_lf_stack_t cur;
+
+    _zda_lf_stack_load(stk, &cur);
+    do {
+        __atomic_store_n(&last->next, cur.top, __ATOMIC_RELAXED);
+        /* The push doesn't make the ABA problem, keep the tag */
+    } while (!_zda_lf_stack_cas(stk, &cur, first, cur.tag));
+}
+
+static zda_inline void zda_lf_stack_push(zda_lf_stack_t *stk, zda_slist_node_t *node) zda_noexcept
+{
+    zda_lf_stack_push_chain(stk, node, node);
+}
+
+/**
+ * @brief Pop the top node
+ * @return NULL if the stack is empty
+ */
+static zda_inline zda_slist_node_t *zda_lf_stack_pop(zda_lf_stack_t *stk) zda_noexcept
+{
+    zda_lf_stack_t    cur;
+    zda_slist_node_t *next;
+
+    _zda_lf_stack_load(stk, &cur);
+    do {
+        if (!cur.top) return NULL;
+        next = __atomic_load_n(&cur.top->next, __ATOMIC_RELAXED);
+    } while (!_zda_lf_stack_cas(stk, &cur, next, cur.tag + 1));
+    return cur.top;
+}
+
+/**
+ * @brief Pop all nodes to \p out atomically
+ * The nodes are in the pop order, then the \p out can be used by the slist APIs.
+ * @param out The old nodes in it are discarded
+ * @return zda_false if the stack is empty
+ */
+static zda_inline zda_bool zda_lf_stack_pop_all(zda_lf_stack_t *stk, zda_slist_t *out) zda_noexcept
+{
+    zda_lf_stack_t cur;
+
+    _zda_lf_stack_load(stk, &cur);
+    do {
+        if (!cur.top) {
+            zda_slist_init(out);
+            return zda_false;
+        }
+    } while (!_zda_lf_stack_cas(stk, &cur, NULL, cur.tag + 1));
+    out->node.next = cur.top;
+    return zda_true;
+}
+
+/* The result may be stale once returned */
+static zda_inline zda_bool zda_lf_stack_is_empty(zda_lf_stack_t *stk) zda_noexcept
+{
+    return __atomic_load_n(&stk->top, __ATOMIC_ACQUIRE) == NULL;
+}
+
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
+
+#endif /* guard */
@@ -6,6 +6,7 @@
 #include "zda/util/macro.h"
 #include "zda/util/container_of.h"
 #include "zda/util/bool.h"
+#include "zda/util/list_sort.h"
 
 #ifdef __cplusplus
 EXTERN_C_BEGIN
@@ -21,6 +22,9 @@ typedef struct zda_list_node {
 
 #define ZDA_LIST_HOOK zda_list_node_t node
 
+typedef int (*zda_list_sort_cmp_t)(zda_list_node_t const *lhs, zda_list_node_t const *rhs);
+typedef uint64_t (*zda_list_sort_key_t)(zda_list_node_t const *node);
+
 /**
  * @brief Double-linked-list with a sentinel header that don't store data
  */
@@ -154,6 +158,98 @@ static zda_inline void zda_list_pop_back(zda_list_header_t *header)
     }                                                                                              \
   } while (0)
 
+/***********************************/
+/* Sort APIs                       */
+/***********************************/
+
+/* Link the sorted chain [first, last] into the sentinel and fix up the prev links */
+static zda_inline void _zda_list_relink_sorted(
+    zda_list_header_t *header,
+    zda_list_node_t   *first,
+    zda_list_node_t   *last
+)
+{
+  zda_list_node_t *prev = &header->node;
+  if (!first) {
+    zda_list_header_init(header);
+    return;
+  }
+  for (zda_list_node_t *pos = first; pos != NULL; pos = pos->next) {
+    pos->prev = prev;
+    prev      = pos;
+  }
+  header->node.next = first;
+  header->node.prev = last;
+  last->next        = &header->node;
+}
+
+/**
+ * @brief Sort the entries by \p cmp in place
+ * Bottom-up merge sort on the next links, the prev links are rebuilt by one pass after sorting.
+ * Stable and O(1) extra memory.
+ * @param cmp cmp(type *lhs, type *rhs) returns negative, zero, positive like the strcmp().
+ *            It is expanded in place, so a function-like macro is also OK.
+ */
+#define zda_list_sort_inplace(header, type, cmp)                                                   \
+  do {                                                                                             \
+    zda_list_header_t *__sort_header = (header);                                                   \
+    zda_list_node_t   *__sort_first  = __sort_header->node.next;                                   \
+    zda_list_node_t   *__sort_last;                                                                \
+    __sort_header->node.prev->next = NULL;                                                         \
+    if (__sort_first == &__sort_header->node) __sort_first = NULL;                                 \
+    _zda_chain_merge_sort(zda_list_node_t, __sort_first, __sort_last, zda_list_entry, type, cmp);  \
+    _zda_list_relink_sorted(__sort_header, __sort_first, __sort_last);                             \
+  } while (0)
+
+/**
+ * @brief Sort the entries by the unsigned integer key in place
+ * LSD radix sort, stable and the nodes are relinked by the bucket chains.
+ * @param key_of key_of(type *entry) returns the key(at most 64 bits)
+ */
+#define zda_list_radix_sort_inplace(header, type, key_of)                                          \
+  do {                                                                                             \
+    zda_list_header_t *__sort_header = (header);                                                   \
+    zda_list_node_t   *__sort_first  = __sort_header->node.next;                                   \
+    zda_list_node_t   *__sort_last;                                                                \
+    __sort_header->node.prev->next = NULL;                                                         \
+    if (__sort_first == &__sort_header->node) __sort_first = NULL;                                 \
+    _zda_chain_radix_sort(                                                                         \
+        zda_list_node_t,                                                                           \
+        __sort_first,                                                                              \
+        __sort_last,                                                                               \
+        zda_list_entry,                                                                            \
+        type,                                                                                      \
+        key_of                                                                                     \
+    );                                                                                             \
+    _zda_list_relink_sorted(__sort_header, __sort_first, __sort_last);                             \
+  } while (0)
+
+/* The \p cmp is called through the pointer, use zda_list_sort_inplace() if it matters */
+static zda_inline void zda_list_sort(zda_list_header_t *header, zda_list_sort_cmp_t cmp)
+{
+  zda_list_node_t *first = zda_list_is_empty(header) ? NULL : header->node.next;
+  zda_list_node_t *last;
+  header->node.prev->next = NULL;
+  _zda_chain_merge_sort(zda_list_node_t, first, last, _zda_sort_node_self, zda_list_node_t, cmp);
+  _zda_list_relink_sorted(header, first, last);
+}
+
+static zda_inline void zda_list_radix_sort(zda_list_header_t *header, zda_list_sort_key_t key_of)
+{
+  zda_list_node_t *first = zda_list_is_empty(header) ? NULL : header->node.next;
+  zda_list_node_t *last;
+  header->node.prev->next = NULL;
+  _zda_chain_radix_sort(
+      zda_list_node_t,
+      first,
+      last,
+      _zda_sort_node_self,
+      zda_list_node_t,
+      key_of
+  );
+  _zda_list_relink_sorted(header, first, last);
+}
+
 /**************************************/
 /* No sentinel version */
 /**************************************/
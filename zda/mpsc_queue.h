@@ -0,0 +1,150 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_MPSC_QUEUE_H__
+#define _ZDA_MPSC_QUEUE_H__
+
+#include "zda/delist.h"
+
+/*
+ * Intrusive multi-producer/single-consumer queue
+ *
+ * The entries embed the ZDA_DELIST_HOOK, so the entries popped by zda_mpsc_queue_pop_all() are
+ * linked as a zda_delist_t directly.
+ *
+ * Push is wait-free: one atomic exchange on the tail and one store to link the previous node.
+ * Pop is lock-free and only called by one consumer thread. The stub node keeps the queue
+ * non-empty, so the producers never touch the head owned by the consumer.
+ *
+ * Between the exchange and the link of a push, the pushed node is not reachable from the head,
+ * the pop returns NULL in the window even though the queue is not empty. The consumer should
+ * retry later(e.g. the producer wakes up the consumer after push).
+ *
+ * Reference: Dmitry Vyukov. Intrusive MPSC node-based queue.
+ */
+typedef struct zda_mpsc_queue {
+    /* Written by the producers */
+    zda_delist_node_t *tail __attribute__((aligned(ZDA_CACHELINE_SIZE)));
+    /* Owned by the consumer */
+    zda_delist_node_t *head __attribute__((aligned(ZDA_CACHELINE_SIZE)));
+    zda_delist_node_t  stub;
+} zda_mpsc_queue_t;
+
+static zda_inline void zda_mpsc_queue_init(zda_mpsc_queue_t *q) zda_noexcept
+{
+    q->stub.next = NULL;
+    q->head      = &q->stub;
+    q->tail      = &q->stub;
+}
+
+/**
+ * @brief Push the \p node to the back of queue
+ * Can be called by multiple threads simultaneously.
+ */
+static zda_inline void zda_mpsc_queue_push(zda_mpsc_queue_t *q, zda_delist_node_t *node) zda_noexcept
+{
+    zda_delist_node_t *prev;
+
+    __atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+    prev = __atomic_exchange_n(&q->tail, node, __ATOMIC_ACQ_REL);
+    /* The node is visible to the consumer after this */
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Pop the front node of queue
+ * Must be called by the consumer only.
+ * @return NULL if the queue is empty or the front node is being pushed
+ */
+static zda_inline zda_delist_node_t *zda_mpsc_queue_pop(zda_mpsc_queue_t *q) zda_noexcept
+{
+    zda_delist_node_t *head = q->head;
+    zda_delist_node_t *next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+    zda_delist_node_t *tail;
+
+    if (head == &q->stub) {
+        if (!next) return NULL;
+        q->head = next;
+        head    = next;
+        next    = __atomic_load_n(&next->next, __ATOMIC_ACQUIRE);
+    }
+
+    if (next) {
+        q->head = next;
+        return head;
+    }
+
+    /* The head is the last node, or the following node is being pushed */
+    tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    if (tail != head) return NULL;
+
+    /* Push the stub to make the head be not the last node to pop it */
+    zda_mpsc_queue_push(q, &q->stub);
+    next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+    if (next) {
+        q->head = next;
+        return head;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Pop all nodes of queue and append them to \p out
+ * Must be called by the consumer only.
+ * The nodes are already linked in order by the producers, so the chain from the head is handed
+ * off in one walk, the stub is unlinked if it is in the middle. The last node is kept if its
+ * next is being pushed, like the zda_mpsc_queue_pop().
+ * @return The number of popped nodes
+ */
+static zda_inline size_t zda_mpsc_queue_pop_all(zda_mpsc_queue_t *q, zda_delist_t *out) zda_noexcept
+{
+    zda_delist_node_t *first = NULL;
+    zda_delist_node_t *last  = NULL;
+    zda_delist_node_t *node;
+    zda_delist_node_t *next;
+    size_t             cnt = 0;
+
+    for (node = q->head;; node = next) {
+        next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+        if (node == &q->stub) {
+            if (!next) break;
+            continue;
+        }
+
+        if (!next) {
+            /* Same as the zda_mpsc_queue_pop() */
+            if (__atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) != node) break;
+            zda_mpsc_queue_push(q, &q->stub);
+            next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+            if (!next) break;
+        }
+
+        /* The next of node has been linked, no producer writes it */
+        if (last)
+            last->next = node;
+        else
+            first = node;
+        last = node;
+        ++cnt;
+    }
+    /* The first node not popped, or the stub */
+    q->head = node;
+
+    if (!cnt) return 0;
+    last->next = NULL;
+
+    /* Splice [first, last] to the back of out */
+    out->tail_before->next = first;
+    out->tail_before       = last;
+    return cnt;
+}
+
+/**
+ * @brief Check whether the queue is empty
+ * Must be called by the consumer only.
+ * The result is false if a node is being pushed.
+ */
+static zda_inline zda_bool zda_mpsc_queue_is_empty(zda_mpsc_queue_t *q) zda_noexcept
+{
+    return q->head == &q->stub && __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) == &q->stub;
+}
+
+#endif /* guard */
@@ -11,6 +11,8 @@
 #define _ZDA_RB_TREE_H__
 
 #include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "zda/util/export.h"
 #include "zda/util/macro.h"
@@ -393,6 +395,63 @@ ZDA_API zda_rb_node_t *zda_rb_tree_search(
     return result;                                                                                 \
   }
 
+/**
+ * @brief Search the entry whose key is integer without the compare callback
+ * The descent finds the lower bound by `<` only, the child is selected by the
+ * result of `<` that compiler can generate cmov instead of the unpredictable branch.
+ * The equality is checked once at the end.
+ */
+#define zda_rb_tree_search_int_inplace(header, key, type, get_key, p_result)                       \
+  do {                                                                                             \
+    zda_rb_header_t *__header = header;                                                            \
+    zda_rb_node_t   *root     = zda_rb_tree_get_root(__header);                                    \
+    zda_rb_node_t   *__lb     = ZDA_NULL;                                                          \
+    int              __less;                                                                       \
+    p_result = ZDA_NULL;                                                                           \
+    while (!zda_rb_node_is_nil(__header, root)) {                                                  \
+      __less = get_key(zda_rb_entry(root, type)) < (key);                                          \
+      __lb   = __less ? __lb : root;                                                               \
+      root   = __less ? root->right : root->left;                                                  \
+    }                                                                                              \
+    if (__lb && get_key(zda_rb_entry(__lb, type)) == (key)) {                                      \
+      p_result = zda_rb_entry(__lb, type);                                                         \
+    }                                                                                              \
+  } while (0)
+
+#define zda_def_rb_tree_search_int(func_name, key_type, type, get_key)                             \
+  zda_decl_rb_tree_search(func_name, key_type, type)                                               \
+  {                                                                                                \
+    type *result;                                                                                  \
+    zda_rb_tree_search_int_inplace(header, key, type, get_key, result);                            \
+    return result;                                                                                 \
+  }
+
+/**
+ * @brief The offset of the key member relative to the node member
+ * It is used by the APIs that access the key without the get_key callback.
+ */
+#define zda_rb_key_offset(type, key_member)                                                        \
+  ((ptrdiff_t)offsetof(type, key_member) - (ptrdiff_t)offsetof(type, node))
+
+/**
+ * @brief Search the entry whose key is uint32_t/uint64_t
+ * This is not a function-like macro and don't need the callback.
+ * @param key_offset see `zda_rb_key_offset()`
+ * @return
+ *  header - entry node is not found(Same as `zda_rb_tree_search()`).
+ */
+ZDA_API zda_rb_node_t *zda_rb_tree_search_u32(
+    zda_rb_header_t *header,
+    uint32_t         key,
+    ptrdiff_t        key_offset
+) zda_noexcept;
+
+ZDA_API zda_rb_node_t *zda_rb_tree_search_u64(
+    zda_rb_header_t *header,
+    uint64_t         key,
+    ptrdiff_t        key_offset
+) zda_noexcept;
+
 /************************************/
 /* Insert APIs */
 /************************************/
@@ -553,6 +612,61 @@ typedef struct zda_rb_commit_ctx {
     return p_dup;                                                                                  \
   }
 
+/**
+ * @brief Like `zda_rb_tree_insert_check_inplace()` but compare the integer key by `<` and `==`
+ * (see `zda_rb_tree_search_int_inplace()`)
+ */
+#define zda_rb_tree_insert_check_int_inplace(header, key, type, get_key, commit_ctx, p_dup)        \
+  do {                                                                                             \
+    zda_rb_header_t *__header     = header;                                                        \
+    zda_rb_node_t  **p_slot       = zda_rb_tree_get_p_root(__header);                              \
+    zda_rb_node_t   *track_parent = (*p_slot)->parent;                                             \
+    zda_rb_node_t   *__lb         = ZDA_NULL;                                                      \
+    int              __less;                                                                       \
+    p_dup = NULL;                                                                                  \
+    for (; !zda_rb_node_is_nil(__header, *p_slot);) {                                              \
+      track_parent = *p_slot;                                                                      \
+      __less       = get_key(zda_rb_entry(track_parent, type)) < (key);                            \
+      __lb         = __less ? __lb : track_parent;                                                 \
+      p_slot       = __less ? &track_parent->right : &track_parent->left;                          \
+    }                                                                                              \
+    if (__lb && get_key(zda_rb_entry(__lb, type)) == (key)) {                                      \
+      p_dup = zda_rb_entry(__lb, type);                                                            \
+      break;                                                                                       \
+    }                                                                                              \
+    (commit_ctx).pp_slot  = p_slot;                                                                \
+    (commit_ctx).p_parent = track_parent;                                                          \
+  } while (0)
+
+#define zda_def_rb_tree_insert_check_int(func_name, key_type, type, get_key)                       \
+  zda_decl_rb_tree_insert_check(func_name, key_type, type)                                         \
+  {                                                                                                \
+    type *p_dup;                                                                                   \
+    zda_rb_tree_insert_check_int_inplace(header, key, type, get_key, *p_ctx, p_dup);               \
+    return p_dup;                                                                                  \
+  }
+
+/**
+ * @brief Non-callback insert check for uint32_t/uint64_t key
+ * @param key_offset see `zda_rb_key_offset()`
+ * @return
+ *  NULL - The \p p_ctx is set and can be committed
+ *  Otherwise, the node has the same key
+ */
+ZDA_API zda_rb_node_t *zda_rb_tree_insert_check_u32(
+    zda_rb_header_t     *header,
+    uint32_t             key,
+    ptrdiff_t            key_offset,
+    zda_rb_commit_ctx_t *p_ctx
+) zda_noexcept;
+
+ZDA_API zda_rb_node_t *zda_rb_tree_insert_check_u64(
+    zda_rb_header_t     *header,
+    uint64_t             key,
+    ptrdiff_t            key_offset,
+    zda_rb_commit_ctx_t *p_ctx
+) zda_noexcept;
+
 static zda_inline void zda_rb_tree_insert_commit(
     zda_rb_header_t     *header,
     zda_rb_commit_ctx_t *p_ctx,
@@ -582,6 +696,23 @@ static zda_inline void zda_rb_tree_insert_commit(
     return p_dup;                                                                                  \
   }
 
+/**********************************/
+/* Bulk build APIs */
+/**********************************/
+/**
+ * @brief Build the tree from \p nodes[0, n) in O(n) without comparison
+ * The \p nodes must be sorted in the order of the tree(e.g. read from a sorted snapshot),
+ * it is not checked.
+ * The result tree is balanced as the perfect binary tree except the last level whose nodes are
+ * colored red, the others are black.
+ * @param header Must be empty
+ */
+ZDA_API void zda_rb_tree_build_sorted(
+    zda_rb_header_t *header,
+    zda_rb_node_t  **nodes,
+    size_t           n
+) zda_noexcept;
+
 /**********************************/
 /* Remove APIs */
 /**********************************/
@@ -618,6 +749,14 @@ ZDA_API zda_rb_node_t *zda_rb_tree_remove(
     }                                                                                              \
   } while (0)
 
+#define zda_rb_tree_remove_int_inplace(header, key, type, get_key, p_entry)                       \
+  do {                                                                                             \
+    zda_rb_tree_search_int_inplace(header, key, type, get_key, p_entry);                           \
+    if (p_entry) {                                                                                 \
+      zda_rb_tree_remove_node(header, &p_entry->node);                                             \
+    }                                                                                              \
+  } while (0)
+
 #define zda_decl_rb_tree_remove(func_name, key_type, type)                                         \
   type *func_name(zda_rb_header_t *header, key_type key)
 
@@ -6,6 +6,7 @@
 #include <zda/util/comparator.hpp>
 #include <zda/util/functor.hpp>
 #include <zda/util/map_functor.hpp>
+#include <zda/zstl/type_traits.h>
 
 namespace zda {
 
@@ -45,25 +46,35 @@ class RbTree
     void       remove_iter(const_iterator iter) noexcept { remove_node(iter.node()); }
     EntryType *remove(AKey key) noexcept;
 
-    iterator begin() noexcept { return iterator(tree_, zda_rb_tree_first((rep_type *)&tree_)); }
-    iterator last() noexcept { return iterator(tree_, zda_rb_tree_last((rep_type *)&tree_)); }
-    iterator end() noexcept { return iterator(tree_, zda_rb_tree_terminator((rep_type *)&tree_)); }
+    iterator begin() noexcept { return iterator(&tree_, zda_rb_tree_first((rep_type *)&tree_)); }
+    iterator last() noexcept { return iterator(&tree_, zda_rb_tree_last((rep_type *)&tree_)); }
+    iterator end() noexcept { return iterator(&tree_, zda_rb_tree_terminator((rep_type *)&tree_)); }
     const_iterator begin() const noexcept
     {
-        return const_iterator(tree_, zda_rb_tree_first((rep_type *)&tree_));
+        return const_iterator((rep_type *)&tree_, zda_rb_tree_first((rep_type *)&tree_));
     }
     const_iterator last() const noexcept
     {
-        return const_iterator(tree_, zda_rb_tree_last((rep_type *)&tree_));
+        return const_iterator((rep_type *)&tree_, zda_rb_tree_last((rep_type *)&tree_));
     }
     const_iterator end() const noexcept
     {
-        return const_iterator(tree_, zda_rb_tree_terminator((rep_type *)&tree_));
+        return const_iterator((rep_type *)&tree_, zda_rb_tree_terminator((rep_type *)&tree_));
     }
 
     rep_type &rep() noexcept { return tree_; }
 
  private:
+    /* The integral key compared by the default comparator uses the comparator-free path
+     * (see zda_rb_tree_search_int_inplace()) */
+    using IntKeyTag = zstl::bool_constant<
+        std::is_integral<Key>::value && std::is_same<Compare, Comparator<Key>>::value>;
+
+    EntryType *insert_check_impl(AKey key, zda_rb_commit_ctx_t *p_cmt_ctx, std::true_type) noexcept;
+    EntryType *insert_check_impl(AKey key, zda_rb_commit_ctx_t *p_cmt_ctx, std::false_type) noexcept;
+    EntryType *search_impl(AKey key, std::true_type) noexcept;
+    EntryType *search_impl(AKey key, std::false_type) noexcept;
+
     zda_rb_tree_t tree_;
 };
 
@@ -89,16 +100,7 @@ _ZDA_AVL_TREE_TEMPLATE_LIST_
 zda_inline EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::insert_entry(EntryType *entry) noexcept
 {
     zda_rb_commit_ctx_t cmt_ctx;
-    EntryType          *p_dup;
-    zda_rb_tree_insert_check_inplace(
-        &tree_,
-        _ZDA_AVL_TREE_TO_GET_KEY_(entry),
-        EntryType,
-        _ZDA_AVL_TREE_TO_GET_KEY_,
-        _ZDA_AVL_TREE_TO_COMPARE_,
-        cmt_ctx,
-        p_dup
-    );
+    EntryType          *p_dup = insert_check(_ZDA_AVL_TREE_TO_GET_KEY_(entry), &cmt_ctx);
     if (p_dup) return p_dup;
     zda_rb_tree_insert_commit(&tree_, &cmt_ctx, &entry->node);
 
@@ -106,10 +108,39 @@ zda_inline EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::insert_entry(EntryType *ent
 }
 
 _ZDA_AVL_TREE_TEMPLATE_LIST_
-EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::insert_check(
+zda_inline EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::insert_check(
     AKey                 key,
     zda_rb_commit_ctx_t *p_cmt_ctx
 ) noexcept
+{
+    return insert_check_impl(key, p_cmt_ctx, IntKeyTag{});
+}
+
+_ZDA_AVL_TREE_TEMPLATE_LIST_
+EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::insert_check_impl(
+    AKey                 key,
+    zda_rb_commit_ctx_t *p_cmt_ctx,
+    std::true_type
+) noexcept
+{
+    entry_type *p_dup;
+    zda_rb_tree_insert_check_int_inplace(
+        &tree_,
+        key,
+        EntryType,
+        _ZDA_AVL_TREE_TO_GET_KEY_,
+        *p_cmt_ctx,
+        p_dup
+    );
+    return p_dup;
+}
+
+_ZDA_AVL_TREE_TEMPLATE_LIST_
+EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::insert_check_impl(
+    AKey                 key,
+    zda_rb_commit_ctx_t *p_cmt_ctx,
+    std::false_type
+) noexcept
 {
     entry_type *p_dup;
     zda_rb_tree_insert_check_inplace(
@@ -134,7 +165,21 @@ void _ZDA_AVL_TREE_TEMPLATE_CLASS_::insert_commit(
 }
 
 _ZDA_AVL_TREE_TEMPLATE_LIST_
-EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::search(AKey key) noexcept
+zda_inline EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::search(AKey key) noexcept
+{
+    return search_impl(key, IntKeyTag{});
+}
+
+_ZDA_AVL_TREE_TEMPLATE_LIST_
+EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::search_impl(AKey key, std::true_type) noexcept
+{
+    EntryType *ret;
+    zda_rb_tree_search_int_inplace(&tree_, key, EntryType, _ZDA_AVL_TREE_TO_GET_KEY_, ret);
+    return ret;
+}
+
+_ZDA_AVL_TREE_TEMPLATE_LIST_
+EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::search_impl(AKey key, std::false_type) noexcept
 {
     EntryType *ret;
     zda_rb_tree_search_inplace(
@@ -157,15 +202,8 @@ void _ZDA_AVL_TREE_TEMPLATE_CLASS_::remove_node(zda_rb_node_t *node) noexcept
 _ZDA_AVL_TREE_TEMPLATE_LIST_
 EntryType *_ZDA_AVL_TREE_TEMPLATE_CLASS_::remove(AKey key) noexcept
 {
-    EntryType *ret;
-    zda_rb_tree_remove_inplace(
-        &tree_,
-        key,
-        entry_type,
-        _ZDA_AVL_TREE_TO_GET_KEY_,
-        _ZDA_AVL_TREE_TO_COMPARE_,
-        ret
-    );
+    EntryType *ret = search(key);
+    if (ret) zda_rb_tree_remove_node(&tree_, &ret->node);
     return ret;
 }
 
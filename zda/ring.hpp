@@ -0,0 +1,411 @@
+#ifndef _ZDA_RING_HPP__
+#define _ZDA_RING_HPP__
+
+/*
+ * Bounded lock-free ring buffers
+ *
+ * - SpscRing<T>: single producer and single consumer, each side only writes
+ *   its own index and caches the index of the other side, so the shared
+ *   cache line is read only when the cached index says full/empty.
+ * - MpmcRing<T>: multiple producers and consumers, every slot has a sequence
+ *   number telling whether it is writable or readable in the current lap.
+ *   Reference: Dmitry Vyukov. Bounded MPMC queue.
+ *
+ * The capacity is rounded up to the power of two, the indices increase
+ * monotonically and are masked to get the slot, so they never wrap in
+ * practice(2^64 operations).
+ *
+ * The operations never block, the try_*() return false if the ring is full
+ * or empty. The batch operations claim multiple slots by one atomic
+ * operation and return the number of the transferred elements.
+ *
+ * ```cpp
+ * zda::MpmcRing<Task> ring(1024);
+ * // Producers
+ * if (!ring.try_push(std::move(task))) { ... }
+ * // Consumers
+ * Task tasks[32];
+ * size_t n = ring.try_pop_batch(tasks, 32);
+ * ```
+ */
+#include "zda/reserved_array.hpp"
+#include "zda/util/macro.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+namespace zda {
+namespace detail {
+
+/* The raw storage of T, the element is constructed on demand */
+template <typename T>
+struct RingStorage {
+    alignas(T) unsigned char data[sizeof(T)];
+
+    T *get() zda_noexcept
+    {
+#if __cplusplus >= 201703L
+        return std::launder(reinterpret_cast<T *>(data));
+#else
+        return reinterpret_cast<T *>(data);
+#endif
+    }
+};
+
+inline size_t ring_round_capacity(size_t capacity)
+{
+    size_t ret = 2;
+    if (capacity > (SIZE_MAX >> 1) + 1)
+        throw std::length_error("Ring: capacity is too large");
+    while (ret < capacity)
+        ret <<= 1;
+    return ret;
+}
+
+} // namespace detail
+
+template <typename T>
+class SpscRing {
+    using Storage = detail::RingStorage<T>;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "The storage is allocated by malloc()");
+
+   public:
+    using value_type = T;
+    using size_type = size_t;
+
+    /**
+     * @brief Construct the ring with the capacity at least \p capacity
+     * @throw std::bad_alloc, std::length_error if the capacity is too large
+     */
+    explicit SpscRing(size_type capacity)
+      : head_(0)
+      , cached_tail_(0)
+      , tail_(0)
+      , cached_head_(0)
+      , slots_(detail::ring_round_capacity(capacity))
+      , mask_(slots_.size() - 1)
+    {
+    }
+
+    ~SpscRing() noexcept
+    {
+        size_t const tail = tail_.load(std::memory_order_relaxed);
+        for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+            slots_[i & mask_].get()->~T();
+    }
+
+    SpscRing(SpscRing const &) = delete;
+    SpscRing &operator=(SpscRing const &) = delete;
+
+    /*****************************/
+    /* Producer APIs */
+    /*****************************/
+    template <typename... Args>
+    bool try_emplace(Args &&...args)
+    {
+        size_t const tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) return false;
+        }
+        new (slots_[tail & mask_].data) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(T const &value) { return try_emplace(value); }
+    bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+    /**
+     * @brief Move the elements in [first, first + n) to the ring
+     * @return The number of pushed elements, the rest are not moved
+     */
+    template <typename InputIt>
+    size_type try_push_batch(InputIt first, size_type n)
+    {
+        size_t const tail = tail_.load(std::memory_order_relaxed);
+        if (mask_ + 1 - (tail - cached_head_) < n)
+            cached_head_ = head_.load(std::memory_order_acquire);
+        n = zda_min(n, mask_ + 1 - (tail - cached_head_));
+
+        for (size_t i = 0; i < n; ++i, ++first)
+            new (slots_[(tail + i) & mask_].data) T(std::move(*first));
+        /* Publish all at once */
+        if (n) tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /*****************************/
+    /* Consumer APIs */
+    /*****************************/
+    bool try_pop(T &out)
+    {
+        size_t const head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) return false;
+        }
+        T *elem = slots_[head & mask_].get();
+        out = std::move(*elem);
+        elem->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move at most \p n elements to [out, out + n)
+     * @return The number of popped elements
+     */
+    template <typename OutputIt>
+    size_type try_pop_batch(OutputIt out, size_type n)
+    {
+        size_t const head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ - head < n)
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        n = zda_min(n, cached_tail_ - head);
+
+        for (size_t i = 0; i < n; ++i, ++out) {
+            T *elem = slots_[(head + i) & mask_].get();
+            *out = std::move(*elem);
+            elem->~T();
+        }
+        if (n) head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /* The front element, or nullptr if empty. Only for the consumer. */
+    T *front()
+    {
+        size_t const head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) return nullptr;
+        }
+        return slots_[head & mask_].get();
+    }
+
+    /*****************************/
+    /* Observer APIs */
+    /*****************************/
+    /* The size is approximate if the other side is running */
+    size_type size() const noexcept
+    {
+        size_t const head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    size_type capacity() const noexcept { return mask_ + 1; }
+
+   private:
+    /* Written by the consumer */
+    alignas(ZDA_CACHELINE_SIZE) std::atomic<size_t> head_;
+    size_t cached_tail_;
+    /* Written by the producer */
+    alignas(ZDA_CACHELINE_SIZE) std::atomic<size_t> tail_;
+    size_t cached_head_;
+    /* Read-only after construction */
+    alignas(ZDA_CACHELINE_SIZE) ReservedArray<Storage> slots_;
+    size_t mask_;
+};
+
+template <typename T>
+class MpmcRing {
+    struct Slot {
+        /* pos: writable for the position pos
+         * pos + 1: readable for the position pos */
+        std::atomic<size_t> seq;
+        detail::RingStorage<T> storage;
+    };
+
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "The storage is allocated by malloc()");
+    /* A claimed slot must be published, or the others spin on it forever */
+    static_assert(std::is_nothrow_move_constructible<T>::value &&
+                      std::is_nothrow_move_assignable<T>::value,
+                  "MpmcRing requires the nothrow move of T");
+
+   public:
+    using value_type = T;
+    using size_type = size_t;
+
+    /**
+     * @brief Construct the ring with the capacity at least \p capacity
+     * @throw std::bad_alloc, std::length_error if the capacity is too large
+     */
+    explicit MpmcRing(size_type capacity)
+      : head_(0)
+      , tail_(0)
+      , slots_(detail::ring_round_capacity(capacity))
+      , mask_(slots_.size() - 1)
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+            new (&slots_[i].seq) std::atomic<size_t>(i);
+    }
+
+    ~MpmcRing() noexcept
+    {
+        size_t const tail = tail_.load(std::memory_order_relaxed);
+        for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+            slots_[i & mask_].storage.get()->~T();
+    }
+
+    MpmcRing(MpmcRing const &) = delete;
+    MpmcRing &operator=(MpmcRing const &) = delete;
+
+    /**
+     * @brief Construct the element before claiming the slot
+     * The element is built even if the ring is full, so the arguments may be
+     * consumed when it returns false.
+     */
+    template <typename... Args>
+    bool try_emplace(Args &&...args)
+    {
+        T value(std::forward<Args>(args)...);
+        return try_push(std::move(value));
+    }
+
+    bool try_push(T const &value)
+    {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+
+    /* The \p value is not moved if it returns false */
+    bool try_push(T &&value) noexcept
+    {
+        size_t pos;
+        if (!claim(tail_, 0, 1, pos)) return false;
+
+        Slot &slot = slots_[pos & mask_];
+        new (slot.storage.data) T(std::move(value));
+        slot.seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move the elements in [first, first + n) to the ring
+     * The pushed elements are contiguous in the ring.
+     * @return The number of pushed elements, the rest are not moved
+     */
+    template <typename InputIt>
+    size_type try_push_batch(InputIt first, size_type n)
+    {
+        static_assert(noexcept(T(std::move(*first))),
+                      "The construction from *first must be nothrow");
+        size_t pos;
+        n = claim(tail_, 0, n, pos);
+
+        for (size_t i = 0; i < n; ++i, ++first) {
+            Slot &slot = slots_[(pos + i) & mask_];
+            new (slot.storage.data) T(std::move(*first));
+            slot.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    bool try_pop(T &out)
+    {
+        size_t pos;
+        if (!claim(head_, 1, 1, pos)) return false;
+
+        Slot &slot = slots_[pos & mask_];
+        T *elem = slot.storage.get();
+        out = std::move(*elem);
+        elem->~T();
+        slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move at most \p n elements to [out, out + n)
+     * The assignment through \p out must not throw.
+     * @return The number of popped elements
+     */
+    template <typename OutputIt>
+    size_type try_pop_batch(OutputIt out, size_type n)
+    {
+        static_assert(noexcept(*out = std::declval<T &&>()),
+                      "The assignment through out must be nothrow");
+        size_t pos;
+        n = claim(head_, 1, n, pos);
+
+        for (size_t i = 0; i < n; ++i, ++out) {
+            Slot &slot = slots_[(pos + i) & mask_];
+            T *elem = slot.storage.get();
+            *out = std::move(*elem);
+            elem->~T();
+            slot.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /* The size is approximate if other threads are running */
+    size_type size() const noexcept
+    {
+        size_t const head = head_.load(std::memory_order_acquire);
+        size_t const tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    size_type capacity() const noexcept { return mask_ + 1; }
+
+   private:
+    /**
+     * @brief Claim at most \p n consecutive slots from \p index
+     * The slot of position pos is ready if its seq is pos + \p lag.
+     * @param[out] pos The first claimed position
+     * @return The number of claimed slots, 0 if no slot is ready
+     */
+    size_t claim(std::atomic<size_t> &index, size_t lag, size_t n, size_t &pos) noexcept
+    {
+        if (n == 0) return 0;
+        pos = index.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t const seq =
+                slots_[pos & mask_].seq.load(std::memory_order_acquire);
+            intptr_t const diff = (intptr_t)(seq - (pos + lag));
+
+            if (diff == 0) {
+                /* The ready slot can't become not ready before the index
+                 * passes it, so the prefix is still ready if CAS succeeds */
+                size_t k = 1;
+                size_t const max_k = zda_min(n, mask_ + 1);
+                while (k < max_k &&
+                       slots_[(pos + k) & mask_].seq.load(
+                           std::memory_order_acquire) == pos + k + lag)
+                    ++k;
+                if (index.compare_exchange_weak(pos,
+                                                pos + k,
+                                                std::memory_order_relaxed,
+                                                std::memory_order_relaxed))
+                    return k;
+            } else if (diff < 0) {
+                /* Full for the producer, or empty for the consumer */
+                return 0;
+            } else {
+                pos = index.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /* Written by the consumers */
+    alignas(ZDA_CACHELINE_SIZE) std::atomic<size_t> head_;
+    /* Written by the producers */
+    alignas(ZDA_CACHELINE_SIZE) std::atomic<size_t> tail_;
+    /* Read-only after construction */
+    alignas(ZDA_CACHELINE_SIZE) ReservedArray<Slot> slots_;
+    size_t mask_;
+};
+
+} // namespace zda
+
+#endif /* guard */
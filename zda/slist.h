@@ -8,6 +8,7 @@
 #include "zda/util/container_of.h"
 #include "zda/util/bool.h"
 #include "zda/util/swap.h"
+#include "zda/util/list_sort.h"
 
 #ifdef __cplusplus
 EXTERN_C_BEGIN
@@ -38,6 +39,8 @@ typedef zda_slist_header_t  zda_slist_t;
 typedef zda_slist_header2_t zda_slist2_t;
 
 typedef int (*zda_slist_cmp_t)(zda_slist_node_t const *node, void const *key);
+typedef int (*zda_slist_sort_cmp_t)(zda_slist_node_t const *lhs, zda_slist_node_t const *rhs);
+typedef uint64_t (*zda_slist_sort_key_t)(zda_slist_node_t const *node);
 
 #define zda_slist_node_entry(p_node, type, member) container_of(p_node, type, member)
 #define zda_slist_entry(p_node, type)              zda_slist_node_entry(p_node, type, node)
@@ -139,6 +142,82 @@ ZDA_API zda_slist_node_t *zda_slist_search(
         }                                                                                          \
     } while (0)
 
+/*******************************/
+/* Sort APIs */
+/*******************************/
+/**
+ * @brief Sort the entries by \p cmp in place
+ * Bottom-up merge sort, stable and O(1) extra memory.
+ * @param cmp cmp(type *lhs, type *rhs) returns negative, zero, positive like the strcmp().
+ *            It is expanded in place, so a function-like macro is also OK.
+ */
+#define zda_slist_sort_inplace(header, type, cmp)                                                  \
+    do {                                                                                           \
+        zda_slist_header_t *__sort_header = (header);                                              \
+        zda_slist_node_t   *__sort_tail;                                                           \
+        _zda_chain_merge_sort(                                                                     \
+            zda_slist_node_t,                                                                      \
+            __sort_header->node.next,                                                              \
+            __sort_tail,                                                                           \
+            zda_slist_entry,                                                                       \
+            type,                                                                                  \
+            cmp                                                                                    \
+        );                                                                                         \
+        (void)__sort_tail;                                                                         \
+    } while (0)
+
+/**
+ * @brief Sort the entries by the unsigned integer key in place
+ * LSD radix sort, stable and the nodes are relinked by the bucket chains.
+ * @param key_of key_of(type *entry) returns the key(at most 64 bits)
+ */
+#define zda_slist_radix_sort_inplace(header, type, key_of)                                         \
+    do {                                                                                           \
+        zda_slist_header_t *__sort_header = (header);                                              \
+        zda_slist_node_t   *__sort_tail;                                                           \
+        _zda_chain_radix_sort(                                                                     \
+            zda_slist_node_t,                                                                      \
+            __sort_header->node.next,                                                              \
+            __sort_tail,                                                                           \
+            zda_slist_entry,                                                                       \
+            type,                                                                                  \
+            key_of                                                                                 \
+        );                                                                                         \
+        (void)__sort_tail;                                                                         \
+    } while (0)
+
+/* The \p cmp is called through the pointer, use zda_slist_sort_inplace() if it matters */
+static zda_inline void zda_slist_sort(zda_slist_header_t *header, zda_slist_sort_cmp_t cmp)
+{
+    zda_slist_node_t *tail;
+    _zda_chain_merge_sort(
+        zda_slist_node_t,
+        header->node.next,
+        tail,
+        _zda_sort_node_self,
+        zda_slist_node_t,
+        cmp
+    );
+    (void)tail;
+}
+
+static zda_inline void zda_slist_radix_sort(
+    zda_slist_header_t  *header,
+    zda_slist_sort_key_t key_of
+)
+{
+    zda_slist_node_t *tail;
+    _zda_chain_radix_sort(
+        zda_slist_node_t,
+        header->node.next,
+        tail,
+        _zda_sort_node_self,
+        zda_slist_node_t,
+        key_of
+    );
+    (void)tail;
+}
+
 /*******************************/
 /* No sentinel version APIs */
 /*******************************/
@@ -0,0 +1,373 @@
+#ifndef _ZDA_STRING_FMT_HPP__
+#define _ZDA_STRING_FMT_HPP__
+
+/*
+ * Compile-time parsed format string
+ *
+ * ```cpp
+ * zda::str_appendf(&line, ZDA_FMT("id=%d name=%v cost=%g"), id, name, cost);
+ * ```
+ * Unlike the str_appendf(std::string *, char const *, ...):
+ * - The format string is parsed at compile time into a fixed sequence of
+ *   the literal pieces and the arguments, the invalid specifier and the
+ *   mismatched argument count are compile errors.
+ * - The arguments are type-checked against the specifiers.
+ * - The arguments are formatted once to compute the exact size,
+ *   then the string is resized once and the pieces are copied.
+ *
+ * The specifiers are same as the str_appendf():
+ *   %s/%v/%S: char const *, std::string, zda::StringView, std::string_view,
+ *             std::string const *
+ *   %c: char
+ *   %d/%i: integer(formatted by its signedness)
+ *   %u, %x/%X: integer(reinterpreted as unsigned)
+ *   %g, %f: floating-point(see double_to_chars()/double_to_fixed_chars())
+ *   %%: '%'
+ * The length modifiers(l, ll, z) are accepted and ignored since the type is
+ * known.
+ *
+ * \note Requires C++17
+ */
+#include "zda/string_util.hpp"
+
+#if __cplusplus >= 201703L
+
+#    include <array>
+#    include <cstring>
+#    include <string>
+#    include <string_view>
+#    include <tuple>
+#    include <type_traits>
+#    include <utility>
+
+namespace zda {
+namespace detail {
+
+struct FmtStringTag {};
+
+enum FmtSegmentKind : unsigned char {
+    FMT_LITERAL,
+    FMT_ARG,
+};
+
+struct FmtSegment {
+    FmtSegmentKind kind;
+    char spec;
+    size_t begin;
+    size_t len;
+    size_t arg_index;
+};
+
+constexpr bool fmt_is_spec(char c) noexcept
+{
+    switch (c) {
+        case 's':
+        case 'v':
+        case 'S':
+        case 'c':
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'g':
+        case 'f':
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Return the position of the specifier character after the '%' at i */
+constexpr size_t fmt_skip_modifier(char const *fmt, size_t n, size_t i) noexcept
+{
+    ++i;
+    if (i < n && fmt[i] == 'z') return i + 1;
+    if (i < n && fmt[i] == 'l') ++i;
+    if (i < n && fmt[i] == 'l') ++i;
+    return i;
+}
+
+/*
+ * Parse \p fmt[0, n) to \p out if it is not null.
+ * Return the number of segments, or -1 if the format is invalid.
+ */
+constexpr size_t fmt_parse(char const *fmt, size_t n, FmtSegment *out) noexcept
+{
+    size_t count = 0;
+    size_t arg_count = 0;
+    size_t i = 0;
+
+    while (i < n) {
+        if (fmt[i] != '%') {
+            size_t const begin = i;
+            while (i < n && fmt[i] != '%')
+                ++i;
+            if (out) out[count] = {FMT_LITERAL, 0, begin, i - begin, 0};
+            ++count;
+            continue;
+        }
+
+        if (i + 1 < n && fmt[i + 1] == '%') {
+            if (out) out[count] = {FMT_LITERAL, 0, i + 1, 1, 0};
+            ++count;
+            i += 2;
+            continue;
+        }
+
+        i = fmt_skip_modifier(fmt, n, i);
+        if (i >= n || !fmt_is_spec(fmt[i])) return (size_t)-1;
+        if (out) out[count] = {FMT_ARG, fmt[i], 0, 0, arg_count};
+        ++count;
+        ++arg_count;
+        ++i;
+    }
+
+    return count;
+}
+
+constexpr size_t fmt_count_args(char const *fmt, size_t n) noexcept
+{
+    size_t ret = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (fmt[i] != '%') continue;
+        if (i + 1 < n && fmt[i + 1] == '%') {
+            ++i;
+            continue;
+        }
+        ++ret;
+        i = fmt_skip_modifier(fmt, n, i);
+    }
+    return ret;
+}
+
+template <size_t N>
+constexpr std::array<FmtSegment, N> fmt_parse_array(char const *fmt,
+                                                    size_t n) noexcept
+{
+    std::array<FmtSegment, N> ret{};
+    fmt_parse(fmt, n, ret.data());
+    return ret;
+}
+
+template <typename Fmt>
+struct FmtParsed {
+    static constexpr size_t count = fmt_parse(Fmt::data(), Fmt::size(), nullptr);
+    static_assert(count != (size_t)-1,
+                  "ZDA_FMT: invalid specifier or trailing '%'");
+
+    static constexpr size_t arg_count =
+        fmt_count_args(Fmt::data(), Fmt::size());
+
+    static constexpr std::array<FmtSegment, count> segments =
+        fmt_parse_array<count>(Fmt::data(), Fmt::size());
+};
+
+/********************************/
+/* Pieces */
+/********************************/
+struct FmtStrPiece {
+    char const *data_;
+    size_t len_;
+
+    char const *data() const noexcept { return data_; }
+    size_t size() const noexcept { return len_; }
+};
+
+template <size_t N>
+struct FmtBufPiece {
+    char buf_[N];
+    size_t len_;
+
+    char const *data() const noexcept { return buf_; }
+    size_t size() const noexcept { return len_; }
+};
+
+zda_inline FmtStrPiece fmt_str_piece(char const *s) noexcept
+{
+    return {s, strlen(s)};
+}
+
+zda_inline FmtStrPiece fmt_str_piece(std::string const &s) noexcept
+{
+    return {s.data(), s.size()};
+}
+
+zda_inline FmtStrPiece fmt_str_piece(std::string const *s) noexcept
+{
+    return {s->data(), s->size()};
+}
+
+zda_inline FmtStrPiece fmt_str_piece(StringView s) noexcept
+{
+    return {s.data(), s.size()};
+}
+
+zda_inline FmtStrPiece fmt_str_piece(std::string_view s) noexcept
+{
+    return {s.data(), s.size()};
+}
+
+template <typename T>
+using fmt_is_int = std::integral_constant<
+    bool, std::is_integral<T>::value && !std::is_same<T, bool>::value>;
+
+template <char Spec, typename T>
+zda_inline auto fmt_make_piece(T const &arg) noexcept
+{
+    if constexpr (Spec == 's' || Spec == 'v' || Spec == 'S') {
+        return fmt_str_piece(arg);
+    } else if constexpr (Spec == 'c') {
+        static_assert(std::is_same<T, char>::value, "ZDA_FMT: %c requires char");
+        return FmtBufPiece<1>{{arg}, 1};
+    } else if constexpr (Spec == 'd' || Spec == 'i') {
+        static_assert(fmt_is_int<T>::value, "ZDA_FMT: %d requires integer");
+        FmtBufPiece<ZDA_INT_CHARS_MAX> ret;
+        if constexpr (std::is_signed<T>::value)
+            ret.len_ = s64_to_chars(ret.buf_, (int64_t)arg);
+        else
+            ret.len_ = u64_to_chars(ret.buf_, (uint64_t)arg);
+        return ret;
+    } else if constexpr (Spec == 'u' || Spec == 'x' || Spec == 'X') {
+        static_assert(fmt_is_int<T>::value,
+                      "ZDA_FMT: %u/%x requires integer");
+        FmtBufPiece<ZDA_INT_CHARS_MAX> ret;
+        auto const u = (uint64_t)(std::make_unsigned_t<T>)arg;
+        if constexpr (Spec == 'u')
+            ret.len_ = u64_to_chars(ret.buf_, u);
+        else
+            ret.len_ = u64_to_hex_chars(ret.buf_, u, Spec == 'X');
+        return ret;
+    } else if constexpr (Spec == 'g') {
+        static_assert(std::is_floating_point<T>::value,
+                      "ZDA_FMT: %g requires floating-point");
+        FmtBufPiece<ZDA_DOUBLE_CHARS_MAX> ret;
+        ret.len_ = double_to_chars(ret.buf_, (double)arg);
+        return ret;
+    } else {
+        static_assert(std::is_floating_point<T>::value,
+                      "ZDA_FMT: %f requires floating-point");
+        FmtBufPiece<ZDA_DOUBLE_FIXED_CHARS_MAX> ret;
+        ret.len_ = double_to_fixed_chars(ret.buf_, (double)arg);
+        return ret;
+    }
+}
+
+template <typename Fmt, size_t I, typename Tuple>
+zda_inline auto fmt_segment_piece(Tuple const &args) noexcept
+{
+    constexpr FmtSegment seg = FmtParsed<Fmt>::segments[I];
+    if constexpr (seg.kind == FMT_LITERAL) {
+        return FmtStrPiece{Fmt::data() + seg.begin, seg.len};
+    } else {
+        return fmt_make_piece<seg.spec>(std::get<seg.arg_index>(args));
+    }
+}
+
+template <typename Fmt, typename... Args, size_t... I>
+zda_inline auto fmt_make_pieces(std::index_sequence<I...>,
+                                Args const &...args) noexcept
+{
+    static_assert(FmtParsed<Fmt>::arg_count == sizeof...(Args),
+                  "ZDA_FMT: the argument count mismatches the specifiers");
+    [[maybe_unused]] auto const arg_refs = std::forward_as_tuple(args...);
+    return std::make_tuple(fmt_segment_piece<Fmt, I>(arg_refs)...);
+}
+
+template <typename Pieces, size_t... I>
+zda_inline size_t fmt_pieces_size(Pieces const &pieces,
+                                  std::index_sequence<I...>) noexcept
+{
+    return (std::get<I>(pieces).size() + ... + 0);
+}
+
+/* Copy the pieces to \p buf until \p n characters */
+template <typename Pieces, size_t... I>
+zda_inline void fmt_pieces_copy(char *buf, size_t n, Pieces const &pieces,
+                                std::index_sequence<I...>) noexcept
+{
+    size_t len;
+    (((len = std::get<I>(pieces).size() < n ? std::get<I>(pieces).size() : n),
+      memcpy(buf, std::get<I>(pieces).data(), len),
+      buf += len,
+      n -= len),
+     ...);
+}
+
+template <typename Fmt>
+using enable_if_fmt_t =
+    std::enable_if_t<std::is_base_of<FmtStringTag, Fmt>::value, int>;
+
+} // namespace detail
+
+/**
+ * Make a compile-time format string from the string literal
+ * The result is an empty object whose type carries the string.
+ */
+#    define ZDA_FMT(literal)                                                   \
+        ([] {                                                                  \
+            struct _ZdaFmtString : ::zda::detail::FmtStringTag {               \
+                static constexpr char const *data() noexcept                   \
+                {                                                              \
+                    return literal;                                            \
+                }                                                              \
+                static constexpr size_t size() noexcept                        \
+                {                                                              \
+                    return sizeof(literal) - 1;                                \
+                }                                                              \
+            };                                                                 \
+            return _ZdaFmtString{};                                            \
+        }())
+
+/**
+ * @brief Append the formatted arguments to \p p_str
+ * The string is resized once.
+ * @return 0, same as the str_appendf(std::string *, char const *, ...)
+ */
+template <typename Fmt, typename... Args, detail::enable_if_fmt_t<Fmt> = 0>
+zda_inline size_t str_appendf(std::string *p_str, Fmt, Args const &...args)
+{
+    using Seq = std::make_index_sequence<detail::FmtParsed<Fmt>::count>;
+    auto const pieces = detail::fmt_make_pieces<Fmt>(Seq{}, args...);
+    size_t const size = detail::fmt_pieces_size(pieces, Seq{});
+    size_t const old_size = p_str->size();
+
+    p_str->resize(old_size + size);
+    detail::fmt_pieces_copy(&(*p_str)[old_size], size, pieces, Seq{});
+    return 0;
+}
+
+template <typename Fmt, typename... Args, detail::enable_if_fmt_t<Fmt> = 0>
+zda_inline std::string str_catf(Fmt fmt, Args const &...args)
+{
+    std::string ret;
+    str_appendf(&ret, fmt, args...);
+    return ret;
+}
+
+/**
+ * @brief Same as the buf_catf(char *, size_t, char const *, ...)
+ * @return The full size, at most n-1 characters are written and
+ * null-terminated.
+ */
+template <typename Fmt, typename... Args, detail::enable_if_fmt_t<Fmt> = 0>
+zda_inline size_t buf_catf(char *buf, size_t n, Fmt, Args const &...args)
+    zda_noexcept
+{
+    using Seq = std::make_index_sequence<detail::FmtParsed<Fmt>::count>;
+    auto const pieces = detail::fmt_make_pieces<Fmt>(Seq{}, args...);
+    size_t const size = detail::fmt_pieces_size(pieces, Seq{});
+
+    if (buf && n > 0) {
+        size_t const len = size < n ? size : n - 1;
+        detail::fmt_pieces_copy(buf, len, pieces, Seq{});
+        buf[len] = 0;
+    }
+    return size;
+}
+
+} // namespace zda
+
+#endif /* __cplusplus >= 201703L */
+
+#endif /* guard */
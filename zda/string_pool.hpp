@@ -0,0 +1,174 @@
+#ifndef _ZDA_STRING_POOL_HPP__
+#define _ZDA_STRING_POOL_HPP__
+
+/*
+ * String interning pool
+ *
+ * Each unique string is stored once in an arena(with a terminating NUL), and
+ * identified by a dense 32-bit id. The views returned by the pool are stable
+ * until the pool is destroyed, so the interned strings can be compared by
+ * their id(or the data pointer) instead of the bytes.
+ *
+ * ```cpp
+ * zda::StringPool pool;
+ * auto id = pool.intern(host);      // The same id for the same bytes
+ * auto view = pool.get(id);
+ * ...
+ * pool.freeze();
+ * // Lookups from multiple threads without lock
+ * auto id2 = pool.find(name);
+ * ```
+ *
+ * The unique strings are indexed by the zda_ht keyed by the
+ * zda_string_view_t, and the hash is cached in the entry, so the rehash
+ * doesn't read the bytes again.
+ *
+ * The pool is not thread-safe while interning. After freeze(), the pool is
+ * read-only and the const member functions can be called concurrently
+ * without locks since nothing is modified. The freeze() must happen before
+ * the pool is shared to the other threads.
+ */
+#include "zda/ht.h"
+#include "zda/string_view.hpp"
+#include "zda/util/export.h"
+#include "zda/util/macro.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace zda {
+namespace detail {
+
+/* Bump allocator, the memory is released when it is destroyed only */
+class ZDA_API StringArena {
+   public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    StringArena() zda_noexcept
+      : block_(nullptr)
+      , cur_(nullptr)
+      , end_(nullptr)
+      , size_(0)
+    {
+    }
+
+    ~StringArena() zda_noexcept;
+
+    StringArena(StringArena const &)            = delete;
+    StringArena &operator=(StringArena const &) = delete;
+
+    char *allocate(size_t n, size_t align = 1)
+    {
+        size_t const pad = (size_t)(-(uintptr_t)cur_) & (align - 1);
+        if ((size_t)(end_ - cur_) < n + pad) return allocate_slow(n, align);
+        char *ret = cur_ + pad;
+        cur_      = ret + n;
+        return ret;
+    }
+
+    /* The total size of the allocated blocks */
+    size_t memory_usage() const zda_noexcept { return size_; }
+
+   private:
+    char *allocate_slow(size_t n, size_t align);
+
+    struct Block {
+        Block *next;
+    };
+
+    Block *block_;
+    char *cur_;
+    char *end_;
+    size_t size_;
+};
+
+struct StringPoolKey {
+    char const *data;
+    size_t len;
+    uint64_t hash;
+};
+
+struct StringPoolEntry {
+    StringPoolKey key;
+    uint32_t id;
+    ZDA_HT_HOOK;
+};
+
+} // namespace detail
+
+class ZDA_API StringPool {
+   public:
+    using Id = uint32_t;
+
+    static constexpr Id INVALID_ID = UINT32_MAX;
+
+    StringPool() zda_noexcept
+      : frozen_(false)
+    {
+        zda_ht_init(&ht_);
+    }
+
+    ~StringPool() zda_noexcept;
+
+    StringPool(StringPool const &)            = delete;
+    StringPool &operator=(StringPool const &) = delete;
+
+    /**
+     * @brief Return the id of \p str, store it if it is not in the pool
+     * @return INVALID_ID if \p str is not in the pool and the pool is frozen
+     * @throw std::bad_alloc, std::length_error if the ids are exhausted
+     */
+    Id intern(StringView str);
+
+    /**
+     * @brief Same as intern(), but return the stable view
+     */
+    StringView intern_view(StringView str)
+    {
+        Id const id = intern(str);
+        return id == INVALID_ID ? StringView(nullptr, 0) : get(id);
+    }
+
+    /**
+     * @brief Return the id of \p str, or INVALID_ID if it is not in the pool
+     */
+    Id find(StringView str) const zda_noexcept;
+
+    bool contains(StringView str) const zda_noexcept
+    {
+        return find(str) != INVALID_ID;
+    }
+
+    /**
+     * @brief Return the interned string of \p id
+     * The view is null-terminated.
+     */
+    StringView get(Id id) const zda_noexcept
+    {
+        auto const *entry = entries_[id];
+        return StringView(entry->key.data, entry->key.len);
+    }
+
+    size_t size() const zda_noexcept { return entries_.size(); }
+    bool is_empty() const zda_noexcept { return entries_.empty(); }
+
+    /**
+     * @brief Make the pool read-only
+     * The unused capacity is released.
+     */
+    void freeze();
+    bool is_frozen() const zda_noexcept { return frozen_; }
+
+    size_t memory_usage() const zda_noexcept;
+
+   private:
+    zda_ht_t ht_;
+    std::vector<detail::StringPoolEntry *> entries_;
+    detail::StringArena bytes_;
+    detail::StringArena nodes_;
+    bool frozen_;
+};
+
+} // namespace zda
+
+#endif /* guard */
@@ -1,6 +1,8 @@
 #ifndef _ZDA_STRING_UTIL_HPP__
 #define _ZDA_STRING_UTIL_HPP__
 
+#include <cstdarg>
+#include <cstdint>
 #include <string>
 
 #include "zda/string_view.hpp"
@@ -258,6 +260,49 @@ zda_inline std::string str_cat(Args &&...strs)
 
 #endif
 
+/*
+ * Number formatting
+ * The integers are written by the digit-pair lookup table, i.e. two digits
+ * per division. The doubles are written by the shortest decimal that
+ * round-trips(Schubfach algorithm), without the locale and the printf.
+ *
+ * The buffer is not null-terminated, the written size is returned.
+ */
+
+/* The max size of the formatted 64-bit integer, e.g. "-9223372036854775808" */
+#define ZDA_INT_CHARS_MAX 20
+
+/* The max size of double_to_chars(), e.g. "-2.2250738585072014e-308" */
+#define ZDA_DOUBLE_CHARS_MAX 32
+
+/* The max size of double_to_fixed_chars(), e.g. "-0.000...(323 zeros)5" */
+#define ZDA_DOUBLE_FIXED_CHARS_MAX 330
+
+ZDA_API size_t u64_to_chars(char *buf, uint64_t v) zda_noexcept;
+ZDA_API size_t s64_to_chars(char *buf, int64_t v) zda_noexcept;
+ZDA_API size_t u64_to_hex_chars(char *buf, uint64_t v,
+                                bool upper = false) zda_noexcept;
+
+/**
+ * @brief Write the shortest decimal that round-trips to \p v
+ * The notation is same as the printf("%.17g"), i.e. the scientific notation
+ * is used if the exponent is less than -4 or not less than 17, but the
+ * digits are shortest instead of 17 digits, e.g. 0.1 instead of
+ * 0.10000000000000001.
+ * nan, inf and -inf are written for the special values.
+ */
+ZDA_API size_t double_to_chars(char *buf, double v) zda_noexcept;
+
+/**
+ * @brief Like double_to_chars() but always in the fixed notation
+ * e.g. 1e20 is written as 100000000000000000000
+ */
+ZDA_API size_t double_to_fixed_chars(char *buf, double v) zda_noexcept;
+
+ZDA_API void str_append_int(std::string *p_str, int64_t v);
+ZDA_API void str_append_uint(std::string *p_str, uint64_t v);
+ZDA_API void str_append_double(std::string *p_str, double v);
+
 /*
  * Following version APIs don't cause the code generation by TMP.
  * Compared to the following codes:
@@ -282,6 +327,11 @@ zda_inline std::string str_cat(Args &&...strs)
  *  (2) %S: std::string const*
  *  (3) %c: char
  *  (4) %v: zda::StringView
+ *  (5) %d/%i, %u, %x/%X: int, unsigned, unsigned in hex
+ *      The length modifier l, ll, z is allowed, e.g. %ld, %llu, %zu
+ *  (6) %g: double in the shortest form(see double_to_chars())
+ *  (7) %f: double in the shortest fixed form(see double_to_fixed_chars())
+ *  The flags, width and precision are not supported.
  * @param ... Strings
  * @return
  *  If this is specified by null, just compute the space
@@ -2,13 +2,20 @@
 #define _ZDA_STRING_VIEW_H__
 
 #include "zda/util/macro.h"
+#include "zda/util/export.h"
+#include "zda/char_set.h"
 
 #include "zda/util/bool.h"
 #include <string.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <assert.h>
 #include <ctype.h>
 
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
 typedef struct zda_string_view {
     char const *data;
     size_t len;
@@ -20,13 +27,13 @@ typedef struct zda_string_view {
 #endif
 } zda_string_view_t;
 
-static char const *
+static zda_inline char const *
 zda_string_view_get_data(zda_string_view_t const *view) zda_noexcept
 {
     return view->data;
 }
 
-static size_t
+static zda_inline size_t
 zda_string_view_get_len(zda_string_view_t const *view) zda_noexcept
 {
     return view->len;
@@ -87,8 +94,8 @@ zda_string_view_end(zda_string_view_t const *view) zda_noexcept
 /*****************************/
 /* Accesstor */
 /*****************************/
-static zda_inline char const zda_string_view_at(zda_string_view_t const *view,
-                                                size_t i) zda_noexcept
+static zda_inline char zda_string_view_at(zda_string_view_t const *view,
+                                          size_t i) zda_noexcept
 {
     assert(i < view->len);
     return view->data[i];
@@ -135,6 +142,7 @@ static zda_inline void zda_string_view_remove_prefix(zda_string_view_t *view,
 {
     assert(n <= view->len);
     view->data += n;
+    view->len -= n;
 }
 
 static zda_inline void zda_string_view_remove_suffix(zda_string_view_t *view,
@@ -150,55 +158,37 @@ static zda_inline void zda_string_view_remove_suffix(zda_string_view_t *view,
 
 #define ZDA_STRING_VIEW_NPOS (size_t)(-1)
 
-static zda_inline size_t zda_string_view_find(zda_string_view_t const *view,
-                                              zda_string_view_t str,
-                                              size_t pos) zda_noexcept
-{
-    assert(pos <= view->len);
-
-    if (str.len <= view->len) {
-        size_t n = view->len - str.len + 1;
-        for (size_t i = pos; i < n; ++i) {
-            if (!strncmp(view->data + i, str.data, str.len)) {
-                return i;
-            }
-        }
-    }
-    return ZDA_STRING_VIEW_NPOS;
-}
+/**
+ * @brief Find the first occurrence of \p str starting at or after \p pos
+ * The candidates are filtered by the first and last characters of \p str
+ * in the SSE2/AVX2 vectors(selected at runtime), and the long needle
+ * is matched by the Two-Way algorithm to keep the linear time.
+ * @return The position of the occurrence, ZDA_STRING_VIEW_NPOS if not found
+ */
+ZDA_API size_t zda_string_view_find(zda_string_view_t const *view,
+                                    zda_string_view_t str,
+                                    size_t pos) zda_noexcept;
 
 static zda_inline size_t zda_string_view_find_char(
     zda_string_view_t const *view, char c, size_t pos) zda_noexcept
 {
-    for (size_t i = pos; i < view->len; ++i) {
-        if (c == view->data[i]) return i;
-    }
-    return ZDA_STRING_VIEW_NPOS;
+    if (pos >= view->len) return ZDA_STRING_VIEW_NPOS;
+    char const *p = (char const *)memchr(view->data + pos, c, view->len - pos);
+    return p ? (size_t)(p - view->data) : ZDA_STRING_VIEW_NPOS;
 }
 
-static zda_inline size_t zda_string_view_rfind(zda_string_view_t const *view,
-                                               zda_string_view_t str,
-                                               size_t pos) zda_noexcept
-{
-    if (str.len != 0) {
-        size_t len = zda_min(view->len - 1, pos);
-
-        // Avoid --len == size_type(-1)
-        for (;; --len) {
-            if (view->data[len] == str.data[0] && view->len - len >= str.len &&
-                memcmp(view->data + len, str.data, str.len) == 0)
-                return len;
-
-            if (len == 0) break;
-        }
-    }
-
-    return ZDA_STRING_VIEW_NPOS;
-}
+/**
+ * @brief Find the last occurrence of \p str starting at or before \p pos
+ * @return The position of the occurrence, ZDA_STRING_VIEW_NPOS if not found
+ */
+ZDA_API size_t zda_string_view_rfind(zda_string_view_t const *view,
+                                     zda_string_view_t str,
+                                     size_t pos) zda_noexcept;
 
 static zda_inline size_t zda_string_view_rfind_char(
     zda_string_view_t const *view, char c, size_t pos) zda_noexcept
 {
+    if (ZDA_UNLIKELY(view->len == 0)) return ZDA_STRING_VIEW_NPOS;
     size_t len = zda_min(view->len - 1, pos);
     for (;; --len) {
         if (view->data[len] == c) {
@@ -226,79 +216,281 @@ static zda_inline zda_bool zda_string_view_contains_char(
 static zda_inline zda_bool zda_string_view_starts_with(
     zda_string_view_t const *view, zda_string_view_t str) zda_noexcept
 {
-    return (view->len >= str.len && memcmp(view->data, str.data, str.len)) == 0;
+    return view->len >= str.len && memcmp(view->data, str.data, str.len) == 0;
 }
 
 static zda_inline zda_bool zda_string_view_ends_with(
     zda_string_view_t const *view, zda_string_view_t str) zda_noexcept
 {
-    return (view->len >= str.len && memcmp(view->data + view->len - str.len,
-                                           view->data, view->len) == 0)
-               ? zda_true
-               : zda_false;
-}
-
-static zda_inline zda_bool _zda_string_view_char_in_range(
-    zda_string_view_t const *c_range, char c) zda_noexcept
-{
-    for (size_t i = 0; i < c_range->len; ++i) {
-        if (c_range->data[i] != c) {
-            return zda_false;
-        }
-    }
-    return zda_true;
-}
-
+    return view->len >= str.len &&
+           memcmp(view->data + view->len - str.len, str.data, str.len) == 0;
+}
+
+/**
+ * @brief Find the first character in \p set starting at or after \p pos
+ * The characters are classified 16/32 bytes per step in the SSSE3/AVX2
+ * vectors(selected at runtime) by the nibble tables of the \p set.
+ */
+ZDA_API size_t zda_string_view_find_first_of_set(zda_string_view_t const *view,
+                                                 zda_char_set_t const *set,
+                                                 size_t pos) zda_noexcept;
+
+/**
+ * @brief Find the first character not in \p set starting at or after \p pos
+ */
+ZDA_API size_t
+zda_string_view_find_first_not_of_set(zda_string_view_t const *view,
+                                      zda_char_set_t const *set,
+                                      size_t pos) zda_noexcept;
+
+/**
+ * @brief Find the last character in \p set starting at or before \p pos
+ */
+ZDA_API size_t zda_string_view_find_last_of_set(zda_string_view_t const *view,
+                                                zda_char_set_t const *set,
+                                                size_t pos) zda_noexcept;
+
+/**
+ * @brief Find the last character not in \p set starting at or before \p pos
+ */
+ZDA_API size_t
+zda_string_view_find_last_not_of_set(zda_string_view_t const *view,
+                                     zda_char_set_t const *set,
+                                     size_t pos) zda_noexcept;
+
+/**
+ * @brief Length of the longest prefix consisting of the characters in \p set
+ */
+static zda_inline size_t zda_string_view_span(
+    zda_string_view_t const *view, zda_char_set_t const *set) zda_noexcept
+{
+    size_t ret = zda_string_view_find_first_not_of_set(view, set, 0);
+    return ret == ZDA_STRING_VIEW_NPOS ? view->len : ret;
+}
+
+/**
+ * @brief Length of the longest prefix consisting of the characters not in
+ * \p set
+ */
+static zda_inline size_t zda_string_view_cspan(
+    zda_string_view_t const *view, zda_char_set_t const *set) zda_noexcept
+{
+    size_t ret = zda_string_view_find_first_of_set(view, set, 0);
+    return ret == ZDA_STRING_VIEW_NPOS ? view->len : ret;
+}
+
+/*
+ * The following APIs build the char set from \p range for every call.
+ * Prefer the *_set() version if the range is reused.
+ */
 static zda_inline size_t
 zda_string_view_find_first_of(zda_string_view_t const *view,
                               zda_string_view_t range, size_t pos) zda_noexcept
 {
-    for (; pos < view->len; ++pos) {
-        if (_zda_string_view_char_in_range(&range, view->data[pos])) {
-            return pos;
-        }
-    }
-    return ZDA_STRING_VIEW_NPOS;
+    zda_char_set_t set;
+
+    if (range.len == 1)
+        return zda_string_view_find_char(view, range.data[0], pos);
+    zda_char_set_init_chars(&set, range.data, range.len);
+    return zda_string_view_find_first_of_set(view, &set, pos);
 }
 
 static zda_inline size_t zda_string_view_find_first_of_char(
     zda_string_view_t const *view, char c, size_t pos) zda_noexcept
 {
-    for (; pos < view->len; ++pos) {
-        if (view->data[pos] == c) {
-            return pos;
-        }
-    }
-    return ZDA_STRING_VIEW_NPOS;
+    return zda_string_view_find_char(view, c, pos);
+}
+
+static zda_inline size_t zda_string_view_find_first_not_of(
+    zda_string_view_t const *view, zda_string_view_t range,
+    size_t pos) zda_noexcept
+{
+    zda_char_set_t set;
+
+    zda_char_set_init_chars(&set, range.data, range.len);
+    return zda_string_view_find_first_not_of_set(view, &set, pos);
 }
 
 static zda_inline size_t
 zda_string_view_find_last_of(zda_string_view_t const *view,
                              zda_string_view_t range, size_t pos) zda_noexcept
 {
-    if (ZDA_UNLIKELY(view->len == 0)) return ZDA_STRING_VIEW_NPOS;
-    size_t i = zda_min(view->len - 1, pos);
+    zda_char_set_t set;
 
-    for (; i > 0;) {
-        if (_zda_string_view_char_in_range(&range, view->data[i])) return i;
-        if (i == 0) break;
-    }
-
-    return ZDA_STRING_VIEW_NPOS;
+    if (range.len == 1)
+        return zda_string_view_rfind_char(view, range.data[0], pos);
+    zda_char_set_init_chars(&set, range.data, range.len);
+    return zda_string_view_find_last_of_set(view, &set, pos);
 }
 
 static zda_inline size_t zda_string_view_find_last_of_char(
     zda_string_view_t const *view, char c, size_t pos) zda_noexcept
 {
-    if (ZDA_UNLIKELY(view->len == 0)) return ZDA_STRING_VIEW_NPOS;
-    size_t i = zda_min(view->len - 1, pos);
+    return zda_string_view_rfind_char(view, c, pos);
+}
+
+static zda_inline size_t zda_string_view_find_last_not_of(
+    zda_string_view_t const *view, zda_string_view_t range,
+    size_t pos) zda_noexcept
+{
+    zda_char_set_t set;
+
+    zda_char_set_init_chars(&set, range.data, range.len);
+    return zda_string_view_find_last_not_of_set(view, &set, pos);
+}
+
+/*******************************/
+/* Split iterator */
+/*******************************/
+/*
+ * Split the view to fields by the delimiter lazily, e.g.
+ *
+ *   zda_string_view_split_t split;
+ *   zda_string_view_t       field;
+ *   zda_string_view_split_init_char(&split, &line, ',', 0, ZDA_STRING_VIEW_NPOS);
+ *   while (zda_string_view_split_next(&split, &field)) {
+ *     ...
+ *   }
+ *
+ * The fields refer to the view, no allocation is performed.
+ * The delimiter can be a character, a string or a char set.
+ *
+ * - ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY: the consecutive delimiters are
+ *   treated as one and the empty fields are not produced.
+ * - max_splits: split at most max_splits times, the remaining is produced
+ *   as the last field. ZDA_STRING_VIEW_NPOS means no limit.
+ */
+#define ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY 0x1u
+
+#define _ZDA_STRING_VIEW_SPLIT_CHAR 0
+#define _ZDA_STRING_VIEW_SPLIT_STR 1
+#define _ZDA_STRING_VIEW_SPLIT_SET 2
+
+typedef struct zda_string_view_split {
+    zda_string_view_t rest;
+    zda_string_view_t delim;
+    zda_char_set_t const *set;
+    size_t max_splits;
+    unsigned flags;
+    char c;
+    unsigned char kind;
+    zda_bool done;
+} zda_string_view_split_t;
+
+static zda_inline void
+_zda_string_view_split_init(zda_string_view_split_t *split,
+                            zda_string_view_t const *view, unsigned flags,
+                            size_t max_splits) zda_noexcept
+{
+    split->rest = *view;
+    split->delim.data = NULL;
+    split->delim.len = 0;
+    split->set = NULL;
+    split->max_splits = max_splits;
+    split->flags = flags;
+    split->c = 0;
+    split->done = zda_false;
+}
+
+static zda_inline void zda_string_view_split_init_char(
+    zda_string_view_split_t *split, zda_string_view_t const *view, char c,
+    unsigned flags, size_t max_splits) zda_noexcept
+{
+    _zda_string_view_split_init(split, view, flags, max_splits);
+    split->kind = _ZDA_STRING_VIEW_SPLIT_CHAR;
+    split->c = c;
+}
 
-    for (; i > 0; --i) {
-        if (view->data[i] == c) return ZDA_STRING_VIEW_NPOS;
-        if (i == 0) break;
+/* \p delim must be not empty */
+static zda_inline void zda_string_view_split_init_str(
+    zda_string_view_split_t *split, zda_string_view_t const *view,
+    zda_string_view_t delim, unsigned flags, size_t max_splits) zda_noexcept
+{
+    assert(delim.len > 0);
+    _zda_string_view_split_init(split, view, flags, max_splits);
+    split->kind = _ZDA_STRING_VIEW_SPLIT_STR;
+    split->delim = delim;
+}
+
+/* \p set must be alive during the split */
+static zda_inline void zda_string_view_split_init_set(
+    zda_string_view_split_t *split, zda_string_view_t const *view,
+    zda_char_set_t const *set, unsigned flags, size_t max_splits) zda_noexcept
+{
+    _zda_string_view_split_init(split, view, flags, max_splits);
+    split->kind = _ZDA_STRING_VIEW_SPLIT_SET;
+    split->set = set;
+}
+
+/* Return the length of the leading delimiters of the rest */
+static zda_inline size_t
+_zda_string_view_split_skip(zda_string_view_split_t const *split) zda_noexcept
+{
+    zda_string_view_t const *rest = &split->rest;
+    size_t n = 0;
+
+    switch (split->kind) {
+    case _ZDA_STRING_VIEW_SPLIT_CHAR:
+        while (n < rest->len && rest->data[n] == split->c)
+            ++n;
+        return n;
+    case _ZDA_STRING_VIEW_SPLIT_STR:
+        while (rest->len - n >= split->delim.len &&
+               memcmp(rest->data + n, split->delim.data, split->delim.len) == 0)
+            n += split->delim.len;
+        return n;
+    default:
+        n = zda_string_view_find_first_not_of_set(rest, split->set, 0);
+        return n == ZDA_STRING_VIEW_NPOS ? rest->len : n;
     }
+}
 
-    return ZDA_STRING_VIEW_NPOS;
+/* Return the position of the first delimiter of the rest */
+static zda_inline size_t
+_zda_string_view_split_find(zda_string_view_split_t const *split) zda_noexcept
+{
+    switch (split->kind) {
+    case _ZDA_STRING_VIEW_SPLIT_CHAR:
+        return zda_string_view_find_char(&split->rest, split->c, 0);
+    case _ZDA_STRING_VIEW_SPLIT_STR:
+        return zda_string_view_find(&split->rest, split->delim, 0);
+    default:
+        return zda_string_view_find_first_of_set(&split->rest, split->set, 0);
+    }
+}
+
+/**
+ * @brief Get the next field
+ * @param field The next field if there is
+ * @return zda_false if no field remains
+ */
+static zda_inline zda_bool zda_string_view_split_next(
+    zda_string_view_split_t *split, zda_string_view_t *field) zda_noexcept
+{
+    size_t pos;
+    size_t dlen;
+
+    if (split->done) return zda_false;
+
+    if (split->flags & ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY) {
+        zda_string_view_remove_prefix(&split->rest,
+                                      _zda_string_view_split_skip(split));
+    }
+
+    pos = split->max_splits == 0 ? ZDA_STRING_VIEW_NPOS
+                                 : _zda_string_view_split_find(split);
+    if (pos == ZDA_STRING_VIEW_NPOS) {
+        split->done = zda_true;
+        *field = split->rest;
+        return !(split->flags & ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY) ||
+               field->len != 0;
+    }
+
+    dlen = split->kind == _ZDA_STRING_VIEW_SPLIT_STR ? split->delim.len : 1;
+    *field = zda_string_view_left(&split->rest, pos);
+    zda_string_view_remove_prefix(&split->rest, pos + dlen);
+    if (split->max_splits != ZDA_STRING_VIEW_NPOS) --split->max_splits;
+    return zda_true;
 }
 
 /**************************/
@@ -329,64 +521,82 @@ zda_string_view_compare_char(zda_string_view_t const *view, char c) zda_noexcept
     return (view->data[0] == c && view->len == 1) ? 0 : 1;
 }
 
-static zda_inline int
-zda_string_view_case_compare(zda_string_view_t const *view,
-                             zda_string_view_t str) zda_noexcept
-{
-    assert(!zda_string_view_is_empty(view) && !zda_string_view_is_empty(&str));
-    char const *s1 = view->data;
-    char const *s2 = str.data;
-    unsigned char c1 = 0;
-    unsigned char c2 = 0;
-    size_t n = zda_min(view->len, str.len);
-
-    for (; n > 0; --n) {
-        c1 = (unsigned char)tolower(*s1++);
-        c2 = (unsigned char)tolower(*s2++);
-        if (c1 != c2) break;
-    }
+/**************************/
+/* ASCII case-insensitive */
+/**************************/
+/*
+ * Only the ASCII letters are folded, so the results don't depend on the
+ * locale and the bytes >= 0x80 are compared as is(unlike the tolower()).
+ * The kernels are vectorized by SSE2/AVX2 if the CPU supports them.
+ */
+static zda_inline char zda_ascii_to_lower(char c) zda_noexcept
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c | 0x20) : c;
+}
 
-    if (c1 == c2) {
-        if (view->len < str.len) {
-            return -1;
-        } else if (view->len > str.len)
-            return 1;
-    }
-    return c1 - c2;
+static zda_inline char zda_ascii_to_upper(char c) zda_noexcept
+{
+    return (c >= 'a' && c <= 'z') ? (char)(c & ~0x20) : c;
 }
 
+/**
+ * @brief Compare the lowercase form of \p view and \p str
+ * @return <0, 0, >0 like strncasecmp() with the length as tiebreaker
+ */
+ZDA_API int zda_string_view_case_compare(zda_string_view_t const *view,
+                                         zda_string_view_t str) zda_noexcept;
+
+ZDA_API zda_bool zda_string_view_case_equal(zda_string_view_t const *view,
+                                            zda_string_view_t str) zda_noexcept;
+
 static zda_inline int
 zda_string_view_case_compare_char(zda_string_view_t const *view,
                                   char c) zda_noexcept
 {
-    char data_0 = toupper(view->data[0]);
-    char _c = toupper(c);
-    if (view->len < 1 || data_0 < _c) return -1;
+    unsigned char data_0;
+    unsigned char _c;
+
+    if (view->len < 1) return -1;
+    data_0 = (unsigned char)zda_ascii_to_lower(view->data[0]);
+    _c = (unsigned char)zda_ascii_to_lower(c);
+    if (data_0 < _c) return -1;
     if (data_0 > _c) return 1;
-    return (data_0 == c && view->len == 1) ? 0 : 1;
+    return view->len == 1 ? 0 : 1;
 }
 
+/**
+ * @brief Find \p str in \p view[pos, len) case-insensitively
+ * @return The position of the first match, or NPOS
+ */
+ZDA_API size_t zda_string_view_case_find(zda_string_view_t const *view,
+                                         zda_string_view_t str,
+                                         size_t pos) zda_noexcept;
+
+/**
+ * @brief Hash the lowercase form of \p view
+ * The views that are case-insensitive equal have the same hash.
+ */
+ZDA_API uint64_t
+zda_string_view_case_hash(zda_string_view_t const *view) zda_noexcept;
+
 /****************/
 /* Converter */
 /****************/
-static zda_inline void
-zda_string_view_to_upper_string(zda_string_view_t const *view, char *buf,
-                                size_t n) zda_noexcept
-{
-    assert(n >= view->len);
-    for (size_t i = 0; i < view->len; ++i) {
-        buf[i] = toupper(view->data[i]);
-    }
-}
+/**
+ * @brief Write the uppercase(lowercase) form of \p view to \p buf
+ * The \p buf can be same as the view->data to convert in place.
+ * @param n The size of \p buf, must be not less than view->len
+ */
+ZDA_API void zda_string_view_to_upper_string(zda_string_view_t const *view,
+                                             char *buf,
+                                             size_t n) zda_noexcept;
+
+ZDA_API void zda_string_view_to_lower_string(zda_string_view_t const *view,
+                                             char *buf,
+                                             size_t n) zda_noexcept;
 
-static zda_inline void
-zda_string_view_to_lower_string(zda_string_view_t const *view, char *buf,
-                                size_t n) zda_noexcept
-{
-    assert(n >= view->len);
-    for (size_t i = 0; i < view->len; ++i) {
-        buf[i] = tolower(view->data[i]);
-    }
-}
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
 
 #endif /* guard */
@@ -2,7 +2,9 @@
 #define __ZDA_STIRNG_VIEW_HPP___
 
 #include "zda/string_view.h"
+#include "zda/char_set.hpp"
 
+#include <iterator>
 #include <string>
 
 namespace zda {
@@ -11,6 +13,8 @@ namespace zda {
     StringView var_name(literal, sizeof(literal) - 1)
 #define StringViewLiteral(literal) StringView(literal, sizeof(literal) - 1)
 
+class StringSplit;
+
 class StringView {
    public:
     using size_type = size_t;
@@ -32,7 +36,10 @@ class StringView {
 
     size_type size() const zda_noexcept { return view_.len; }
     void empty() zda_noexcept { zda_string_view_empty(&view_); }
-    void is_empty() const zda_noexcept { zda_string_view_is_empty(&view_); }
+    bool is_empty() const zda_noexcept
+    {
+        return zda_string_view_is_empty(&view_);
+    }
 
     char const *data() const zda_noexcept { return view_.data; }
     char const *begin() const zda_noexcept
@@ -118,28 +125,75 @@ class StringView {
         return zda_string_view_ends_with(&view_, suffix.view_);
     }
 
-    bool find_first_of(StringView range, size_t pos = 0) const zda_noexcept
+    size_t find_first_of(StringView range, size_t pos = 0) const zda_noexcept
     {
         return zda_string_view_find_first_of(&view_, range.view_, pos);
     }
 
-    bool find_first_of(char c, size_t pos = 0) const zda_noexcept
+    size_t find_first_of(char c, size_t pos = 0) const zda_noexcept
     {
         return zda_string_view_find_first_of_char(&view_, c, pos);
     }
 
-    bool find_last_of(StringView range,
-                      size_t pos = ZDA_STRING_VIEW_NPOS) const zda_noexcept
+    size_t find_first_of(CharSet const &set, size_t pos = 0) const zda_noexcept
+    {
+        return zda_string_view_find_first_of_set(&view_, set.rep(), pos);
+    }
+
+    size_t find_first_not_of(StringView range,
+                             size_t pos = 0) const zda_noexcept
+    {
+        return zda_string_view_find_first_not_of(&view_, range.view_, pos);
+    }
+
+    size_t find_first_not_of(CharSet const &set,
+                             size_t pos = 0) const zda_noexcept
+    {
+        return zda_string_view_find_first_not_of_set(&view_, set.rep(), pos);
+    }
+
+    size_t find_last_of(StringView range,
+                        size_t pos = ZDA_STRING_VIEW_NPOS) const zda_noexcept
     {
         return zda_string_view_find_last_of(&view_, range.view_, pos);
     }
 
-    bool find_last_of(char c,
-                      size_t pos = ZDA_STRING_VIEW_NPOS) const zda_noexcept
+    size_t find_last_of(char c,
+                        size_t pos = ZDA_STRING_VIEW_NPOS) const zda_noexcept
     {
         return zda_string_view_find_last_of_char(&view_, c, pos);
     }
 
+    size_t find_last_of(CharSet const &set,
+                        size_t pos = ZDA_STRING_VIEW_NPOS) const zda_noexcept
+    {
+        return zda_string_view_find_last_of_set(&view_, set.rep(), pos);
+    }
+
+    size_t find_last_not_of(StringView range,
+                            size_t pos = ZDA_STRING_VIEW_NPOS) const
+        zda_noexcept
+    {
+        return zda_string_view_find_last_not_of(&view_, range.view_, pos);
+    }
+
+    size_t find_last_not_of(CharSet const &set,
+                            size_t pos = ZDA_STRING_VIEW_NPOS) const
+        zda_noexcept
+    {
+        return zda_string_view_find_last_not_of_set(&view_, set.rep(), pos);
+    }
+
+    size_t span(CharSet const &set) const zda_noexcept
+    {
+        return zda_string_view_span(&view_, set.rep());
+    }
+
+    size_t cspan(CharSet const &set) const zda_noexcept
+    {
+        return zda_string_view_cspan(&view_, set.rep());
+    }
+
     int compare(StringView str) const zda_noexcept
     {
         return zda_string_view_compare(&view_, str.view_);
@@ -160,6 +214,21 @@ class StringView {
         return zda_string_view_case_compare_char(&view_, c);
     }
 
+    bool case_equal(StringView str) const zda_noexcept
+    {
+        return zda_string_view_case_equal(&view_, str.view_);
+    }
+
+    size_t case_find(StringView str, size_t pos = 0) const zda_noexcept
+    {
+        return zda_string_view_case_find(&view_, str.view_, pos);
+    }
+
+    uint64_t case_hash() const zda_noexcept
+    {
+        return zda_string_view_case_hash(&view_);
+    }
+
     void to_upper_buffer(char *buf, size_t n) const zda_noexcept
     {
         zda_string_view_to_upper_string(&view_, buf, n);
@@ -188,15 +257,150 @@ class StringView {
         return ret;
     }
 
+    /**
+     * Split lazily, usable in the range-for:
+     *   for (StringView field : line.split(',')) { ... }
+     *
+     * \p flags: ZDA_STRING_VIEW_SPLIT_SKIP_EMPTY
+     * \p max_splits: The remaining is produced as the last field if reach it
+     */
+    StringSplit split(char c, unsigned flags = 0,
+                      size_t max_splits = ZDA_STRING_VIEW_NPOS) const
+        zda_noexcept;
+    StringSplit split(StringView delim, unsigned flags = 0,
+                      size_t max_splits = ZDA_STRING_VIEW_NPOS) const
+        zda_noexcept;
+    StringSplit split(CharSet const &set, unsigned flags = 0,
+                      size_t max_splits = ZDA_STRING_VIEW_NPOS) const
+        zda_noexcept;
+
     zda_string_view_t *rep() zda_noexcept { return &view_; }
     zda_string_view_t const *rep() const zda_noexcept { return &view_; }
 
    private:
+    friend class StringSplit;
+
     StringView(zda_string_view_t view) zda_noexcept : view_(view) {}
 
     zda_string_view_t view_;
 };
 
+/**
+ * The range of the fields split from a StringView.
+ * The char set is owned by the range, so it is safe to pass a temporary
+ * CharSet to StringView::split() in the range-for.
+ */
+class StringSplit {
+   public:
+    class Iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = StringView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = StringView const *;
+        using reference = StringView;
+
+        /* End iterator */
+        Iterator() zda_noexcept : field_(nullptr, 0), end_(true) {}
+
+        explicit Iterator(zda_string_view_split_t const &split) zda_noexcept
+          : split_(split)
+          , field_(nullptr, 0)
+          , end_(false)
+        {
+            ++*this;
+        }
+
+        StringView operator*() const zda_noexcept { return field_; }
+        StringView const *operator->() const zda_noexcept { return &field_; }
+
+        Iterator &operator++() zda_noexcept
+        {
+            end_ = !zda_string_view_split_next(&split_, &field_.view_);
+            return *this;
+        }
+
+        Iterator operator++(int) zda_noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        /* Only the comparison with the end iterator is meaningful */
+        friend bool operator==(Iterator const &lhs,
+                               Iterator const &rhs) zda_noexcept
+        {
+            return lhs.end_ == rhs.end_;
+        }
+
+        friend bool operator!=(Iterator const &lhs,
+                               Iterator const &rhs) zda_noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+       private:
+        zda_string_view_split_t split_;
+        StringView field_;
+        bool end_;
+    };
+
+    StringSplit(StringView view, char c, unsigned flags,
+                size_t max_splits) zda_noexcept
+    {
+        zda_string_view_split_init_char(&split_, view.rep(), c, flags,
+                                        max_splits);
+    }
+
+    StringSplit(StringView view, StringView delim, unsigned flags,
+                size_t max_splits) zda_noexcept
+    {
+        zda_string_view_split_init_str(&split_, view.rep(), *delim.rep(),
+                                       flags, max_splits);
+    }
+
+    StringSplit(StringView view, CharSet const &set, unsigned flags,
+                size_t max_splits) zda_noexcept
+      : set_(set)
+    {
+        zda_string_view_split_init_set(&split_, view.rep(), set_.rep(), flags,
+                                       max_splits);
+    }
+
+    Iterator begin() const zda_noexcept
+    {
+        /* The range may be copied, rebind the set to this */
+        auto split = split_;
+        if (split.kind == _ZDA_STRING_VIEW_SPLIT_SET) split.set = set_.rep();
+        return Iterator(split);
+    }
+
+    Iterator end() const zda_noexcept { return Iterator(); }
+
+   private:
+    zda_string_view_split_t split_;
+    CharSet set_;
+};
+
+zda_inline StringSplit StringView::split(char c, unsigned flags,
+                                         size_t max_splits) const zda_noexcept
+{
+    return StringSplit(*this, c, flags, max_splits);
+}
+
+zda_inline StringSplit StringView::split(StringView delim, unsigned flags,
+                                         size_t max_splits) const zda_noexcept
+{
+    return StringSplit(*this, delim, flags, max_splits);
+}
+
+zda_inline StringSplit StringView::split(CharSet const &set, unsigned flags,
+                                         size_t max_splits) const zda_noexcept
+{
+    return StringSplit(*this, set, flags, max_splits);
+}
+
 zda_inline bool operator<(StringView const &lhs,
                           StringView const &rhs) zda_noexcept
 {
@@ -233,6 +437,21 @@ zda_inline bool operator!=(StringView const &lhs,
     return !(lhs == rhs);
 }
 
+/* The functors for the case-insensitive hash table, e.g. header names */
+struct StringViewCaseHash {
+    size_t operator()(StringView str) const zda_noexcept
+    {
+        return (size_t)str.case_hash();
+    }
+};
+
+struct StringViewCaseEqual {
+    bool operator()(StringView lhs, StringView rhs) const zda_noexcept
+    {
+        return lhs.case_equal(rhs);
+    }
+};
+
 namespace literal {
 constexpr StringView operator""_sv(char const *str, size_t len) zda_noexcept
 {
@@ -10,16 +10,30 @@
 EXTERN_C_BEGIN
 #endif
 
+/*
+ * The integer parsers accept [+-][prefix]digits only:
+ * - The whole view must be consumed, no whitespace is skipped
+ * - The base is in [2, 36], or 0 to detect it by the prefix("0x", "0b", "0")
+ * - The out-of-range value is rejected instead of clamped
+ * They don't depend on the locale and are thread-safe.
+ */
 ZDA_API zda_bool zda_string_view_to_u64(zda_string_view_t sv, int base, uint64_t *o_u64) zda_noexcept;
 ZDA_API zda_bool zda_string_view_to_u32(zda_string_view_t sv, int base, uint32_t *o_u32) zda_noexcept;
 ZDA_API zda_bool zda_string_view_to_s64(zda_string_view_t sv, int base, int64_t *o_64) zda_noexcept;
 ZDA_API zda_bool zda_string_view_to_s32(zda_string_view_t sv, int base, int32_t *o_32) zda_noexcept;
 
+/*
+ * Parse the decimal floating-point number or inf/infinity/nan(case-insensitive).
+ * The result is correctly rounded(Eisel-Lemire algorithm).
+ * The decimal point is always '.' regardless of the locale.
+ */
+ZDA_API zda_bool zda_string_view_to_double(zda_string_view_t sv, double *o_d) zda_noexcept;
+
 static zda_inline zda_bool zda_string_view_to_u16(zda_string_view_t sv, int base, uint16_t *o_) zda_noexcept
 {
     uint32_t tmp;
     zda_bool res =  zda_string_view_to_u32(sv, base, &tmp);
-    if (res && tmp <= 0xffffffff) {
+    if (res && tmp <= UINT16_MAX) {
         *o_ = tmp;
         return zda_true;
     }
@@ -30,7 +44,7 @@ static zda_inline zda_bool zda_string_view_to_s16(zda_string_view_t sv, int base
 {
     int32_t tmp;
     zda_bool res =  zda_string_view_to_s32(sv, base, &tmp);
-    if (res && tmp <= 0x7fffffff && tmp >= 0x80000000) {
+    if (res && tmp <= INT16_MAX && tmp >= INT16_MIN) {
         *o_ = tmp;
         return zda_true;
     }
@@ -41,7 +55,7 @@ static zda_inline zda_bool zda_string_view_to_u8(zda_string_view_t sv, int base,
 { 
     uint32_t tmp;
     zda_bool res =  zda_string_view_to_u32(sv, base, &tmp);
-    if (res && tmp <= 0xffff) {
+    if (res && tmp <= UINT8_MAX) {
         *o_ = tmp;
         return zda_true;
     }
@@ -52,7 +66,7 @@ static zda_inline zda_bool zda_string_view_to_s8(zda_string_view_t sv, int base,
 {
     int32_t tmp;
     zda_bool res =  zda_string_view_to_s32(sv, base, &tmp);
-    if (res && tmp <= 0x7fff && tmp >= 0x8000) {
+    if (res && tmp <= INT8_MAX && tmp >= INT8_MIN) {
         *o_ = tmp;
         return zda_true;
     }
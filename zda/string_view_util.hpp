@@ -28,6 +28,15 @@ __DEF_STRING_VIEW_TO_INT__(int32_t, s32)
 __DEF_STRING_VIEW_TO_INT__(int16_t, s16)
 __DEF_STRING_VIEW_TO_INT__(int8_t, s8)
 
+static zda_inline Result<double> string_view_to_double(StringView sv) zda_noexcept
+{
+    double tmp;
+    if (zda_string_view_to_double(*sv.rep(), &tmp)) {
+        return tmp;
+    }
+    return RES_NULL;
+}
+
 }
 
 #endif
\ No newline at end of file
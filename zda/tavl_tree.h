@@ -0,0 +1,247 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_TAVL_TREE_H__
+#define _ZDA_TAVL_TREE_H__
+
+/*
+ * Threaded avl tree
+ *
+ * The tree is a plain avl tree(see avl_tree.h), but every node also links to its
+ * in-order predecessor and successor. The threads are maintained on insert and remove
+ * in O(1) time since the neighbors of a new leaf are its parent and the neighbor of
+ * the parent on the same side.
+ *
+ * Thus, the successor/predecessor lookup is a single pointer hop and a full in-order
+ * traversal is a linear walk of the thread instead of climbing parent pointers.
+ * The cost is two extra pointers per node.
+ */
+#include "zda/avl_tree.h"
+
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
+typedef struct zda_tavl_node {
+  zda_avl_node_t        avl;
+  struct zda_tavl_node *prev;
+  struct zda_tavl_node *next;
+} zda_tavl_node_t;
+
+#define ZDA_TAVL_NODE_HOOK zda_tavl_node_t node
+
+#define zda_tavl_node_entry(p_node, type, node) container_of(p_node, type, node)
+
+/* Like `zda_tavl_node_entry` but the member name is specified by `node` */
+#define zda_tavl_entry(p_node, type) container_of(p_node, type, node)
+
+#define zda_tavl_node_from_avl(p_avl) container_of(p_avl, zda_tavl_node_t, avl)
+
+/**
+ * @brief Represents a threaded avl tree
+ * \p first and \p last are the both ends of the thread.
+ */
+typedef struct zda_tavl_tree {
+  zda_avl_tree_t   tree;
+  zda_tavl_node_t *first;
+  zda_tavl_node_t *last;
+} zda_tavl_tree_t;
+
+/*******************************/
+/* Initializer */
+/*******************************/
+static zda_inline void zda_tavl_tree_init(zda_tavl_tree_t *tree) zda_noexcept
+{
+  zda_avl_tree_init(&tree->tree);
+  tree->first = tree->last = NULL;
+}
+
+/******************************/
+/* Getter */
+/******************************/
+static zda_inline zda_bool zda_tavl_tree_is_empty(zda_tavl_tree_t *tree) zda_noexcept
+{
+  return tree->first == NULL;
+}
+
+static zda_inline zda_tavl_node_t *zda_tavl_tree_get_root(zda_tavl_tree_t *tree) zda_noexcept
+{
+  return tree->tree.node ? zda_tavl_node_from_avl(tree->tree.node) : NULL;
+}
+
+/***************************/
+/* Iterator APIs */
+/***************************/
+static zda_inline zda_tavl_node_t *zda_tavl_tree_get_first(zda_tavl_tree_t *tree) zda_noexcept
+{
+  return tree->first;
+}
+
+static zda_inline zda_tavl_node_t *zda_tavl_tree_get_last(zda_tavl_tree_t *tree) zda_noexcept
+{
+  return tree->last;
+}
+
+static zda_inline zda_tavl_node_t *zda_tavl_tree_get_terminator(zda_tavl_tree_t *tree) zda_noexcept
+{
+  (void)tree;
+  return NULL;
+}
+
+static zda_inline zda_tavl_node_t *zda_tavl_node_get_next(zda_tavl_node_t *node) zda_noexcept
+{
+  return node->next;
+}
+#define zda_tavl_node_next zda_tavl_node_get_next
+
+static zda_inline zda_tavl_node_t *zda_tavl_node_get_prev(zda_tavl_node_t *node) zda_noexcept
+{
+  return node->prev;
+}
+#define zda_tavl_node_prev zda_tavl_node_get_prev
+
+#define zda_tavl_tree_iterate(tree)                                                                \
+  for (zda_tavl_node_t *pos = (tree)->first; pos != NULL; pos = pos->next)
+
+/**************************/
+/* Insert APIs */
+/**************************/
+
+/* The commit context is same as the avl tree */
+#define zda_tavl_tree_insert_check_inplace(tavl, key, type, get_key, cmp_cb, commit_ctx, p_dup)    \
+  zda_avl_tree_insert_check_member_inplace(                                                        \
+      &(tavl)->tree,                                                                               \
+      key,                                                                                         \
+      type,                                                                                        \
+      node.avl,                                                                                    \
+      get_key,                                                                                     \
+      cmp_cb,                                                                                      \
+      commit_ctx,                                                                                  \
+      p_dup                                                                                        \
+  )
+
+#define zda_decl_tavl_tree_insert_check(func_name, key_type, type)                                 \
+  type *func_name(zda_tavl_tree_t *tree, key_type key, zda_avl_commit_ctx_t *p_ctx) zda_noexcept
+
+#define zda_def_tavl_tree_insert_check(func_name, key_type, type, get_key, cmp)                    \
+  zda_decl_tavl_tree_insert_check(func_name, key_type, type)                                       \
+  {                                                                                                \
+    type *p_dup;                                                                                   \
+    zda_tavl_tree_insert_check_inplace(tree, key, type, get_key, cmp, *p_ctx, p_dup);              \
+    return p_dup;                                                                                  \
+  }
+
+/**
+ * @brief Link the \p new_node to the slot recorded in the \p p_ctx
+ * The thread is linked before the rebalance since the slot is only
+ * valid before the rotations.
+ */
+ZDA_API void zda_tavl_tree_insert_commit(
+    zda_tavl_tree_t      *tree,
+    zda_avl_commit_ctx_t *p_ctx,
+    zda_tavl_node_t      *new_node
+) zda_noexcept;
+
+#define zda_tavl_tree_insert_entry_inplace(tree, entry, type, get_key, cmp_cb, p_dup)              \
+  do {                                                                                             \
+    zda_avl_commit_ctx_t cmt_ctx;                                                                  \
+    zda_tavl_tree_insert_check_inplace(                                                            \
+        tree,                                                                                      \
+        get_key(entry),                                                                            \
+        type,                                                                                      \
+        get_key,                                                                                   \
+        cmp_cb,                                                                                    \
+        cmt_ctx,                                                                                   \
+        p_dup                                                                                      \
+    );                                                                                             \
+    if (p_dup) break;                                                                              \
+    zda_tavl_tree_insert_commit(tree, &cmt_ctx, &(entry)->node);                                   \
+  } while (0)
+
+#define zda_decl_tavl_tree_insert_entry(func_name, type)                                           \
+  type *func_name(zda_tavl_tree_t *tree, type *entry) zda_noexcept
+
+#define zda_def_tavl_tree_insert_entry(func_name, type, get_key, cmp_cb)                           \
+  zda_decl_tavl_tree_insert_entry(func_name, type)                                                 \
+  {                                                                                                \
+    type *p_dup;                                                                                   \
+    zda_tavl_tree_insert_entry_inplace(tree, entry, type, get_key, cmp_cb, p_dup);                 \
+    return p_dup;                                                                                  \
+  }
+
+/********************************/
+/* Search APIs */
+/********************************/
+#define zda_tavl_tree_search_inplace(tavl, key, type, get_key, cmp_cb, p_result)                   \
+  zda_avl_tree_search_member_inplace(&(tavl)->tree, key, type, node.avl, get_key, cmp_cb, p_result)
+
+#define zda_decl_tavl_tree_search(func_name, key_type, type)                                       \
+  type *func_name(zda_tavl_tree_t *tree, key_type key) zda_noexcept
+
+#define zda_def_tavl_tree_search(func_name, key_type, type, get_key, cmp)                          \
+  zda_decl_tavl_tree_search(func_name, key_type, type)                                             \
+  {                                                                                                \
+    type *result;                                                                                  \
+    zda_tavl_tree_search_inplace(tree, key, type, get_key, cmp, result);                           \
+    return result;                                                                                 \
+  }
+
+/*********************************/
+/* Destroy APIs */
+/*********************************/
+/* The thread visits all nodes, so the tree links are not needed to be reset */
+#define zda_tavl_tree_destroy_inplace(tree, type, free_cb)                                         \
+  do {                                                                                             \
+    zda_tavl_node_t *__pos = (tree)->first;                                                        \
+    zda_tavl_node_t *__next;                                                                       \
+    while (__pos) {                                                                                \
+      __next = __pos->next;                                                                        \
+      free_cb(zda_tavl_entry(__pos, type));                                                        \
+      __pos = __next;                                                                              \
+    }                                                                                              \
+  } while (0)
+
+#define zda_decl_tavl_tree_destroy(func_name) void func_name(zda_tavl_tree_t *tree)
+
+#define zda_def_tavl_tree_destroy(func_name, type, free_cb)                                        \
+  zda_decl_tavl_tree_destroy(func_name)                                                            \
+  {                                                                                                \
+    zda_tavl_tree_destroy_inplace(tree, type, free_cb);                                            \
+  }
+
+/************************************/
+/* Remove APIs */
+/************************************/
+ZDA_API void zda_tavl_tree_remove_node(zda_tavl_tree_t *tree, zda_tavl_node_t *old_node)
+    zda_noexcept;
+
+#define zda_tavl_tree_remove_inplace(tree, key, type, get_key, cmp_cb, p_entry)                    \
+  do {                                                                                             \
+    zda_tavl_tree_search_inplace(tree, key, type, get_key, cmp_cb, p_entry);                       \
+    if (p_entry) {                                                                                 \
+      zda_tavl_tree_remove_node(tree, &p_entry->node);                                             \
+    }                                                                                              \
+  } while (0)
+
+#define zda_decl_tavl_tree_remove(func_name, key_type, type)                                       \
+  type *func_name(zda_tavl_tree_t *tree, key_type key)
+
+#define zda_def_tavl_tree_remove(func_name, key_type, type, get_key, cmp_cb)                       \
+  zda_decl_tavl_tree_remove(func_name, key_type, type)                                             \
+  {                                                                                                \
+    type *ret;                                                                                     \
+    zda_tavl_tree_remove_inplace(tree, key, type, get_key, cmp_cb, ret);                           \
+    return ret;                                                                                    \
+  }
+
+/************************************/
+/* Debug APIs */
+/************************************/
+/**
+ * @brief Check the avl properties and the thread is consistent with the in-order traversal
+ */
+ZDA_API zda_bool zda_tavl_tree_verify_properties(zda_tavl_tree_t *tree) zda_noexcept;
+
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
+
+#endif /* header guard */
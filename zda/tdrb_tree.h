@@ -0,0 +1,453 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+
+/*
+ * This file implements an intrusive top-down red-black tree without parent pointers.
+ *
+ * The insert and remove fix the tree in a single descent from the root to the leaf,
+ * i.e. the color flips and rotations are done on the way down instead of
+ * walking back through the parent links(see rb_tree.h). Thus, the node only has
+ * two links and a color, it is 8 bytes smaller than `zda_rb_node_t` at 64bits platform.
+ *
+ * The cost is that there is no successor/predecessor of a single node, the in-order
+ * traversal uses an iterator that keeps an explicit stack of the path.
+ * It is suitable for the lookup table that is built once and read many times.
+ *
+ * References:
+ * [1] Robert Sedgewick, Kevin Wayne. Algorithms 4th Edition.
+ * [2] Julienne Walker. Red Black Trees(top-down insertion and deletion).
+ */
+#ifndef _ZDA_TDRB_TREE_H__
+#define _ZDA_TDRB_TREE_H__
+
+#include "zda/util/export.h"
+#include "zda/util/macro.h"
+#include "zda/util/container_of.h"
+#include "zda/util/bool.h"
+#include "zda/util/assert.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
+/**
+ * @brief Represent a parentless red-black tree node
+ * link[0] is the left child and link[1] is the right child,
+ * the index can be computed from the comparison result
+ * that avoid the branch of the symmetric cases.
+ */
+typedef struct zda_tdrb_node {
+  struct zda_tdrb_node *link[2];
+  zda_bool              red;
+} zda_tdrb_node_t;
+
+#define ZDA_TDRB_NODE_HOOK zda_tdrb_node_t node
+
+#define zda_tdrb_node_entry(p_node, type, node) container_of(p_node, type, node)
+
+/* Like `zda_tdrb_node_entry` but the member name is specified by `node` */
+#define zda_tdrb_entry(p_node, type) container_of(p_node, type, node)
+
+typedef struct zda_tdrb_tree {
+  zda_tdrb_node_t *root;
+} zda_tdrb_tree_t;
+
+/*******************************/
+/* Initializer */
+/*******************************/
+static zda_inline void zda_tdrb_tree_init(zda_tdrb_tree_t *tree) zda_noexcept { tree->root = NULL; }
+
+static zda_inline void zda_tdrb_node_init(zda_tdrb_node_t *node) zda_noexcept
+{
+  node->link[0] = node->link[1] = NULL;
+  node->red                     = zda_true;
+}
+
+/******************************/
+/* Getter */
+/******************************/
+static zda_inline zda_bool zda_tdrb_tree_is_empty(zda_tdrb_tree_t *tree) zda_noexcept
+{
+  return tree->root == NULL;
+}
+
+static zda_inline zda_tdrb_node_t *zda_tdrb_tree_get_root(zda_tdrb_tree_t *tree) zda_noexcept
+{
+  return tree->root;
+}
+
+static zda_inline zda_bool _zda_tdrb_node_is_red(zda_tdrb_node_t *node) zda_noexcept
+{
+  return node && node->red;
+}
+
+static zda_inline zda_tdrb_node_t *zda_tdrb_tree_get_first(zda_tdrb_tree_t *tree) zda_noexcept
+{
+  zda_tdrb_node_t *node = tree->root;
+  if (node) {
+    while (node->link[0])
+      node = node->link[0];
+  }
+  return node;
+}
+
+static zda_inline zda_tdrb_node_t *zda_tdrb_tree_get_last(zda_tdrb_tree_t *tree) zda_noexcept
+{
+  zda_tdrb_node_t *node = tree->root;
+  if (node) {
+    while (node->link[1])
+      node = node->link[1];
+  }
+  return node;
+}
+
+/***************************/
+/* Iterator APIs */
+/***************************/
+/* The height of red-black tree is not greater than 2log(n+1),
+ * the node count can't exceed 2^63 even though in 64bits platform. */
+#define ZDA_TDRB_MAX_HEIGHT 128
+
+/**
+ * @brief In-order iterator
+ * The stack stores the nodes whose left subtree has been visited but itself not,
+ * the top is the current node.
+ */
+typedef struct zda_tdrb_iter {
+  zda_tdrb_node_t *stack[ZDA_TDRB_MAX_HEIGHT];
+  int              top;
+} zda_tdrb_iter_t;
+
+static zda_inline void _zda_tdrb_iter_push_left(zda_tdrb_iter_t *iter, zda_tdrb_node_t *node)
+    zda_noexcept
+{
+  for (; node; node = node->link[0]) {
+    assert(iter->top < ZDA_TDRB_MAX_HEIGHT);
+    iter->stack[iter->top++] = node;
+  }
+}
+
+static zda_inline zda_tdrb_node_t *zda_tdrb_iter_get(zda_tdrb_iter_t *iter) zda_noexcept
+{
+  return iter->top > 0 ? iter->stack[iter->top - 1] : NULL;
+}
+
+/**
+ * @brief Let the \p iter point to the first node of \p tree
+ * @return The first node, NULL if tree is empty
+ */
+static zda_inline zda_tdrb_node_t *zda_tdrb_iter_first(zda_tdrb_iter_t *iter, zda_tdrb_tree_t *tree)
+    zda_noexcept
+{
+  iter->top = 0;
+  _zda_tdrb_iter_push_left(iter, tree->root);
+  return zda_tdrb_iter_get(iter);
+}
+
+/**
+ * @brief Advance the \p iter to the successor of the current node
+ * @return The successor, NULL if iter reach the end
+ */
+static zda_inline zda_tdrb_node_t *zda_tdrb_iter_next(zda_tdrb_iter_t *iter) zda_noexcept
+{
+  assert(iter->top > 0);
+  zda_tdrb_node_t *node = iter->stack[--iter->top];
+  _zda_tdrb_iter_push_left(iter, node->link[1]);
+  return zda_tdrb_iter_get(iter);
+}
+
+#define zda_tdrb_tree_iterate(tree, iter)                                                          \
+  for (zda_tdrb_node_t *pos = zda_tdrb_iter_first(iter, tree); pos != NULL;                        \
+       pos                  = zda_tdrb_iter_next(iter))
+
+/**************************/
+/* Rotation */
+/**************************/
+/*
+ * Rotate the \p root to \p dir and return the new root.
+ * The new root is black and the old root is red.
+ * e.g. dir = 1(right rotation)
+ *        B          A
+ *      /  \   =>   / \
+ *     A   C       SA  B
+ *   /  \             /  \
+ *  SA  SB           SB  C
+ */
+static zda_inline zda_tdrb_node_t *_zda_tdrb_node_rotate(zda_tdrb_node_t *root, int dir)
+    zda_noexcept
+{
+  zda_tdrb_node_t *new_root = root->link[!dir];
+
+  root->link[!dir]    = new_root->link[dir];
+  new_root->link[dir] = root;
+  root->red           = zda_true;
+  new_root->red       = zda_false;
+  return new_root;
+}
+
+/* Rotate the child of \p root to !dir first, then rotate the \p root to dir */
+static zda_inline zda_tdrb_node_t *_zda_tdrb_node_rotate2(zda_tdrb_node_t *root, int dir)
+    zda_noexcept
+{
+  root->link[!dir] = _zda_tdrb_node_rotate(root->link[!dir], !dir);
+  return _zda_tdrb_node_rotate(root, dir);
+}
+
+/**************************/
+/* Insert APIs */
+/**************************/
+/**
+ * Split the 4-node \p q by color flip and fix the two adjacent red nodes.
+ * \p t is the parent of \p g, \p g is the parent of \p p, \p p is the parent of \p q.
+ * \p last is the direction from \p g to \p p.
+ *
+ * The ancestors are black or 2-node or 3-node, the flip can't propagate upward,
+ * so one rotation is enough.
+ */
+static zda_inline void _zda_tdrb_tree_insert_fix(
+    zda_tdrb_node_t *t,
+    zda_tdrb_node_t *g,
+    zda_tdrb_node_t *p,
+    zda_tdrb_node_t *q,
+    int              last
+) zda_noexcept
+{
+  int dir;
+
+  if (_zda_tdrb_node_is_red(q->link[0]) && _zda_tdrb_node_is_red(q->link[1])) {
+    q->red          = zda_true;
+    q->link[0]->red = q->link[1]->red = zda_false;
+  }
+
+  if (q->red && _zda_tdrb_node_is_red(p)) {
+    /* p is red, then it is not root and g is not NULL */
+    assert(g);
+    dir = t->link[1] == g;
+    if (q == p->link[last]) {
+      t->link[dir] = _zda_tdrb_node_rotate(g, !last);
+    } else {
+      t->link[dir] = _zda_tdrb_node_rotate2(g, !last);
+    }
+  }
+}
+
+/**
+ * @brief Insert the \p entry if there is no entry has the same key
+ * @param p_dup The entry has the same key, NULL if insert successfully
+ * (The 4-nodes on the path are split even though the key is duplicate,
+ *  it is still a valid red-black tree.)
+ */
+#define zda_tdrb_tree_insert_entry_inplace(tree, entry, type, get_key, cmp_cb, p_dup)              \
+  do {                                                                                             \
+    zda_tdrb_tree_t *__tree     = (tree);                                                          \
+    zda_tdrb_node_t *__new_node = &(entry)->node;                                                  \
+    zda_tdrb_node_t  __head;                                                                       \
+    zda_tdrb_node_t *__t, *__g, *__p, *__q;                                                        \
+    int              __dir = 0, __last = 0, __res;                                                 \
+    p_dup                  = NULL;                                                                 \
+    zda_tdrb_node_init(__new_node);                                                                \
+    if (!__tree->root) {                                                                           \
+      __new_node->red = zda_false;                                                                 \
+      __tree->root    = __new_node;                                                                \
+      break;                                                                                       \
+    }                                                                                              \
+    /* The fake root make the root is not a special case */                                        \
+    __head.link[0] = NULL;                                                                         \
+    __head.link[1] = __tree->root;                                                                 \
+    __head.red     = zda_false;                                                                    \
+    __t            = &__head;                                                                      \
+    __g = __p = NULL;                                                                              \
+    __q       = __tree->root;                                                                      \
+    for (;;) {                                                                                     \
+      if (!__q) {                                                                                  \
+        __p->link[__dir] = __q = __new_node;                                                       \
+      }                                                                                            \
+      _zda_tdrb_tree_insert_fix(__t, __g, __p, __q, __last);                                       \
+      if (__q == __new_node) break;                                                                \
+      __res = cmp_cb(get_key(zda_tdrb_entry(__q, type)), get_key(entry));                          \
+      if (__res == 0) {                                                                            \
+        p_dup = zda_tdrb_entry(__q, type);                                                         \
+        break;                                                                                     \
+      }                                                                                            \
+      __last = __dir;                                                                              \
+      __dir  = __res < 0;                                                                          \
+      if (__g) __t = __g;                                                                          \
+      __g = __p;                                                                                   \
+      __p = __q;                                                                                   \
+      __q = __q->link[__dir];                                                                      \
+    }                                                                                              \
+    __tree->root      = __head.link[1];                                                            \
+    __tree->root->red = zda_false;                                                                 \
+  } while (0)
+
+#define zda_decl_tdrb_tree_insert_entry(func_name, type)                                           \
+  type *func_name(zda_tdrb_tree_t *tree, type *entry) zda_noexcept
+
+#define zda_def_tdrb_tree_insert_entry(func_name, type, get_key, cmp_cb)                           \
+  zda_decl_tdrb_tree_insert_entry(func_name, type)                                                 \
+  {                                                                                                \
+    type *p_dup;                                                                                   \
+    zda_tdrb_tree_insert_entry_inplace(tree, entry, type, get_key, cmp_cb, p_dup);                 \
+    return p_dup;                                                                                  \
+  }
+
+/********************************/
+/* Search APIs */
+/********************************/
+#define zda_tdrb_tree_search_inplace(tree, key, type, get_key, cmp_cb, p_result)                   \
+  do {                                                                                             \
+    zda_tdrb_node_t *__root = (tree)->root;                                                        \
+    int              __res;                                                                        \
+    p_result = NULL;                                                                               \
+    while (__root) {                                                                               \
+      __res = cmp_cb(get_key(zda_tdrb_entry(__root, type)), key);                                  \
+      if (__res == 0) {                                                                            \
+        p_result = zda_tdrb_entry(__root, type);                                                   \
+        break;                                                                                     \
+      }                                                                                            \
+      __root = __root->link[__res < 0];                                                            \
+    }                                                                                              \
+  } while (0)
+
+#define zda_decl_tdrb_tree_search(func_name, key_type, type)                                       \
+  type *func_name(zda_tdrb_tree_t *tree, key_type key) zda_noexcept
+
+#define zda_def_tdrb_tree_search(func_name, key_type, type, get_key, cmp)                          \
+  zda_decl_tdrb_tree_search(func_name, key_type, type)                                             \
+  {                                                                                                \
+    type *result;                                                                                  \
+    zda_tdrb_tree_search_inplace(tree, key, type, get_key, cmp, result);                           \
+    return result;                                                                                 \
+  }
+
+/*********************************/
+/* Destroy APIs */
+/*********************************/
+/* Rotate the left child up until the node has no left child, then free it and go right.
+ * This don't need the parent pointer or stack. */
+#define zda_tdrb_tree_destroy_inplace(tree, type, free_cb)                                         \
+  do {                                                                                             \
+    zda_tdrb_node_t *__root = (tree)->root;                                                        \
+    zda_tdrb_node_t *__save;                                                                       \
+    while (__root) {                                                                               \
+      if (__root->link[0]) {                                                                       \
+        __save          = __root->link[0];                                                         \
+        __root->link[0] = __save->link[1];                                                         \
+        __save->link[1] = __root;                                                                  \
+      } else {                                                                                     \
+        __save = __root->link[1];                                                                  \
+        free_cb(zda_tdrb_entry(__root, type));                                                     \
+      }                                                                                            \
+      __root = __save;                                                                             \
+    }                                                                                              \
+  } while (0)
+
+#define zda_decl_tdrb_tree_destroy(func_name) void func_name(zda_tdrb_tree_t *tree)
+
+#define zda_def_tdrb_tree_destroy(func_name, type, free_cb)                                        \
+  zda_decl_tdrb_tree_destroy(func_name)                                                            \
+  {                                                                                                \
+    zda_tdrb_tree_destroy_inplace(tree, type, free_cb);                                            \
+  }
+
+/************************************/
+/* Remove APIs */
+/************************************/
+/**
+ * @brief Store the state of the top-down removal
+ * The found node is not removed directly, the removed node is the
+ * in-order predecessor(or itself) \p q, then \p q replaces the found node \p f.
+ * \p fp and \p fdir track the link to \p f since it may be moved by the rotations.
+ */
+typedef struct zda_tdrb_remove_ctx {
+  zda_tdrb_node_t  head; /* The fake root */
+  zda_tdrb_node_t *g;
+  zda_tdrb_node_t *p;
+  zda_tdrb_node_t *q;
+  zda_tdrb_node_t *f;
+  zda_tdrb_node_t *fp;
+  int              dir;
+  int              last;
+  int              fdir;
+} zda_tdrb_remove_ctx_t;
+
+static zda_inline void _zda_tdrb_remove_ctx_init(zda_tdrb_remove_ctx_t *ctx, zda_tdrb_tree_t *tree)
+    zda_noexcept
+{
+  ctx->head.link[0] = NULL;
+  ctx->head.link[1] = tree->root;
+  ctx->head.red     = zda_false;
+  ctx->q            = &ctx->head;
+  ctx->g = ctx->p = ctx->f = ctx->fp = NULL;
+  ctx->dir                           = 1;
+  ctx->last = ctx->fdir = 0;
+}
+
+static zda_inline void _zda_tdrb_remove_ctx_down(zda_tdrb_remove_ctx_t *ctx) zda_noexcept
+{
+  ctx->last = ctx->dir;
+  ctx->g    = ctx->p;
+  ctx->p    = ctx->q;
+  ctx->q    = ctx->q->link[ctx->dir];
+}
+
+static zda_inline void _zda_tdrb_remove_ctx_found(zda_tdrb_remove_ctx_t *ctx) zda_noexcept
+{
+  ctx->f    = ctx->q;
+  ctx->fp   = ctx->p;
+  ctx->fdir = ctx->last;
+}
+
+/**
+ * Push the red link down to make sure the \p q is red or its child at \p dir is red.
+ * Then the removed node must be red, the removal don't break the balance.
+ */
+ZDA_API void _zda_tdrb_tree_push_red(zda_tdrb_remove_ctx_t *ctx) zda_noexcept;
+
+/* Remove the node, relink the found node and update the root */
+ZDA_API void _zda_tdrb_tree_remove_finish(zda_tdrb_tree_t *tree, zda_tdrb_remove_ctx_t *ctx)
+    zda_noexcept;
+
+#define zda_tdrb_tree_remove_inplace(tree, key, type, get_key, cmp_cb, p_entry)                    \
+  do {                                                                                             \
+    zda_tdrb_remove_ctx_t __ctx;                                                                   \
+    int                   __res;                                                                   \
+    _zda_tdrb_remove_ctx_init(&__ctx, tree);                                                       \
+    while (__ctx.q->link[__ctx.dir]) {                                                             \
+      _zda_tdrb_remove_ctx_down(&__ctx);                                                           \
+      __res     = cmp_cb(get_key(zda_tdrb_entry(__ctx.q, type)), key);                             \
+      __ctx.dir = __res < 0;                                                                       \
+      if (__res == 0) _zda_tdrb_remove_ctx_found(&__ctx);                                          \
+      _zda_tdrb_tree_push_red(&__ctx);                                                             \
+    }                                                                                              \
+    p_entry = __ctx.f ? zda_tdrb_entry(__ctx.f, type) : NULL;                                      \
+    _zda_tdrb_tree_remove_finish(tree, &__ctx);                                                    \
+  } while (0)
+
+#define zda_decl_tdrb_tree_remove(func_name, key_type, type)                                       \
+  type *func_name(zda_tdrb_tree_t *tree, key_type key) zda_noexcept
+
+#define zda_def_tdrb_tree_remove(func_name, key_type, type, get_key, cmp_cb)                       \
+  zda_decl_tdrb_tree_remove(func_name, key_type, type)                                             \
+  {                                                                                                \
+    type *ret;                                                                                     \
+    zda_tdrb_tree_remove_inplace(tree, key, type, get_key, cmp_cb, ret);                           \
+    return ret;                                                                                    \
+  }
+
+/************************************/
+/* Debug APIs */
+/************************************/
+ZDA_API size_t zda_tdrb_tree_get_height(zda_tdrb_tree_t *tree) zda_noexcept;
+
+/**
+ * @brief Check the root is black, no adjacent red nodes and
+ * all paths have the same black height
+ */
+ZDA_API zda_bool zda_tdrb_tree_verify_properties(zda_tdrb_tree_t *tree) zda_noexcept;
+
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
+
+#endif /* header guard */
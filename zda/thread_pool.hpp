@@ -0,0 +1,385 @@
+#ifndef _ZDA_THREAD_POOL_HPP__
+#define _ZDA_THREAD_POOL_HPP__
+
+/*
+ * Work-stealing thread pool
+ *
+ * Every worker owns a Chase-Lev deque. The forked task is pushed to the
+ * bottom of the deque of the current worker and popped back by the same
+ * worker in LIFO order, the idle workers steal from the top of the deques
+ * of the others(i.e. the oldest and usually the largest task).
+ *
+ * - fork_join(f1, f2): run f1() and f2() in parallel and wait both
+ * - parallel_for(first, last, grain, body): split [first, last) into the
+ *   ranges whose size is at most grain recursively by fork_join(),
+ *   requires C++17
+ * - run(f): run f() in the pool and wait it
+ *
+ * The APIs can be called by the threads out of the pool, the call is
+ * submitted to the pool as a whole and the calling thread is blocked until
+ * it is done. The nested calls in the workers are forked directly.
+ *
+ * ```cpp
+ * zda::ThreadPool &pool = zda::ThreadPool::instance();
+ * pool.parallel_for(0, n, [&](size_t first, size_t last) {
+ *     for (size_t i = first; i < last; ++i)
+ *         process(data[i]);
+ * });
+ * ```
+ *
+ * The exception thrown by a task is rethrown by the joining fork_join().
+ * If both throw, the one of f1 is rethrown.
+ *
+ * Reference: David Chase, Yossi Lev. Dynamic Circular Work-Stealing Deque.
+ *            Nhat Minh Le, et al. Correct and Efficient Work-Stealing for
+ *            Weak Memory Models.
+ */
+#include "zda/reserved_array.hpp"
+#include "zda/util/export.h"
+#include "zda/util/macro.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace zda {
+
+/**
+ * Chase-Lev deque of T *
+ *
+ * The push() and pop() can only be called by the owner thread, the steal()
+ * can be called by any thread. The buffer grows if it is full, the old
+ * buffers are kept until the deque is destroyed since the thieves may be
+ * still reading them.
+ */
+template <typename T>
+class WorkStealingDeque {
+    struct Buffer {
+        explicit Buffer(size_t capacity)
+          : slots(capacity)
+          , mask(capacity - 1)
+        {
+            for (size_t i = 0; i < capacity; ++i)
+                new (&slots[i]) std::atomic<T *>(nullptr);
+        }
+
+        T *get(int64_t i) const noexcept
+        {
+            return slots[(size_t)i & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, T *x) noexcept
+        {
+            slots[(size_t)i & mask].store(x, std::memory_order_relaxed);
+        }
+
+        ReservedArray<std::atomic<T *>> slots;
+        size_t mask;
+    };
+
+   public:
+    /**
+     * @param capacity The initial capacity, rounded up to the power of two
+     * @throw std::bad_alloc
+     */
+    explicit WorkStealingDeque(size_t capacity = 64)
+      : top_(0)
+      , bottom_(0)
+    {
+        size_t cap = 2;
+        while (cap < capacity)
+            cap <<= 1;
+        buffers_.emplace_back(new Buffer(cap));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(WorkStealingDeque const &) = delete;
+    WorkStealingDeque &operator=(WorkStealingDeque const &) = delete;
+
+    /**
+     * @brief Push \p x to the bottom (Owner only)
+     * @throw std::bad_alloc if the buffer can't grow
+     */
+    void push(T *x)
+    {
+        int64_t const b = bottom_.load(std::memory_order_relaxed);
+        int64_t const t = top_.load(std::memory_order_acquire);
+        Buffer *buf = buffer_.load(std::memory_order_relaxed);
+
+        if (b - t > (int64_t)buf->mask) buf = grow(buf, t, b);
+        buf->put(b, x);
+        /* The release makes the slot visible to the thieves */
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pop from the bottom (Owner only)
+     * @return nullptr if empty or the last one is stolen
+     */
+    T *pop() noexcept
+    {
+        int64_t const b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer *buf = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        /* Order the store of bottom and the load of top, the thieves do the reverse */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *x = buf->get(b);
+        if (t == b) {
+            /* The last one, race with the thieves */
+            if (!top_.compare_exchange_strong(t,
+                                              t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+                x = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    /**
+     * @brief Steal from the top (Any thread)
+     * @return nullptr if empty or lose the race
+     */
+    T *steal() noexcept
+    {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t const b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) return nullptr;
+
+        Buffer *buf = buffer_.load(std::memory_order_acquire);
+        T *x = buf->get(t);
+        if (!top_.compare_exchange_strong(t,
+                                          t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+            return nullptr;
+        return x;
+    }
+
+    /* The result is approximate if other threads are running */
+    size_t size() const noexcept
+    {
+        int64_t const b = bottom_.load(std::memory_order_relaxed);
+        int64_t const t = top_.load(std::memory_order_relaxed);
+        return b > t ? (size_t)(b - t) : 0;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+   private:
+    Buffer *grow(Buffer *old, int64_t t, int64_t b)
+    {
+        buffers_.emplace_back(new Buffer((old->mask + 1) << 1));
+        Buffer *buf = buffers_.back().get();
+        for (int64_t i = t; i < b; ++i)
+            buf->put(i, old->get(i));
+        buffer_.store(buf, std::memory_order_release);
+        return buf;
+    }
+
+    /* Written by the thieves */
+    alignas(ZDA_CACHELINE_SIZE) std::atomic<int64_t> top_;
+    /* Written by the owner */
+    alignas(ZDA_CACHELINE_SIZE) std::atomic<int64_t> bottom_;
+    std::atomic<Buffer *> buffer_;
+    /* All buffers, only accessed by the owner */
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+namespace detail {
+
+/* The type-erased task of the pool, it lives in the stack of the forker */
+struct PoolTask {
+    explicit PoolTask(void (*f)(PoolTask *)) noexcept
+      : fn(f)
+      , done(false)
+      , external(false)
+    {
+    }
+
+    void rethrow()
+    {
+        if (error) std::rethrow_exception(error);
+    }
+
+    void (*fn)(PoolTask *);
+    std::atomic<bool> done;
+    /* Submitted by the thread out of the pool */
+    bool external;
+    std::exception_ptr error;
+};
+
+template <typename F>
+struct PoolFnTask : PoolTask {
+    explicit PoolFnTask(F &f) noexcept
+      : PoolTask(&PoolFnTask::invoke)
+      , func(f)
+    {
+    }
+
+    static void invoke(PoolTask *task) { static_cast<PoolFnTask *>(task)->func(); }
+
+    F &func;
+};
+
+} // namespace detail
+
+class ZDA_API ThreadPool {
+    struct Worker;
+
+   public:
+    /**
+     * @param nthread The number of workers,
+     *                0 means std::thread::hardware_concurrency()
+     * @throw std::bad_alloc, std::system_error
+     */
+    explicit ThreadPool(size_t nthread = 0);
+
+    /* All submitted calls must be done */
+    ~ThreadPool() noexcept;
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator=(ThreadPool const &) = delete;
+
+    /* The pool shared by the library, created by the first call */
+    static ThreadPool &instance();
+
+    size_t size() const noexcept { return workers_.size(); }
+
+    /* The index of the calling worker, or -1 if it isn't a worker of this pool */
+    int current_worker() const noexcept;
+
+    /**
+     * @brief Run \p f in the pool and wait it
+     * If called by a worker, \p f is called directly.
+     */
+    template <typename F>
+    void run(F &&f)
+    {
+        if (current()) {
+            f();
+            return;
+        }
+        detail::PoolFnTask<F> task(f);
+        submit_and_wait(&task);
+        task.rethrow();
+    }
+
+    /**
+     * @brief Run \p f1 and \p f2 in parallel and wait both
+     * The \p f2 is forked to be stolen and \p f1 is called by the current thread.
+     */
+    template <typename F1, typename F2>
+    void fork_join(F1 &&f1, F2 &&f2)
+    {
+        Worker *worker = current();
+        if (!worker) {
+            run([&]() { fork_join(f1, f2); });
+            return;
+        }
+
+        detail::PoolFnTask<F2> task(f2);
+        fork(worker, &task);
+        try {
+            f1();
+        }
+        catch (...) {
+            /* The task refers to the frame, must be done before unwinding */
+            join(worker, &task);
+            throw;
+        }
+        join(worker, &task);
+        task.rethrow();
+    }
+
+#if __cplusplus >= 201703L
+    /**
+     * @brief Call \p body for the subranges of [first, last)
+     * @param grain The maximum size of the subrange,
+     *              0 means about 8 subranges per worker
+     * @param body body(lo, hi) or body(i)
+     * \note Requires C++17
+     */
+    template <typename F>
+    void parallel_for(size_t first, size_t last, size_t grain, F &&body)
+    {
+        if (first >= last) return;
+        if (grain == 0) grain = zda_max((last - first) / (size() * 8), (size_t)1);
+        run([&]() { for_range(first, last, grain, body); });
+    }
+
+    template <typename F>
+    void parallel_for(size_t first, size_t last, F &&body)
+    {
+        parallel_for(first, last, 0, std::forward<F>(body));
+    }
+#endif /* __cplusplus >= 201703L */
+
+   private:
+#if __cplusplus >= 201703L
+    template <typename F>
+    void for_range(size_t first, size_t last, size_t grain, F &body)
+    {
+        if (last - first <= grain) {
+            if constexpr (std::is_invocable<F &, size_t, size_t>::value) {
+                body(first, last);
+            } else {
+                for (size_t i = first; i < last; ++i)
+                    body(i);
+            }
+            return;
+        }
+
+        size_t const mid = first + (last - first) / 2;
+        fork_join([&]() { for_range(first, mid, grain, body); },
+                  [&]() { for_range(mid, last, grain, body); });
+    }
+#endif /* __cplusplus >= 201703L */
+
+    Worker *current() const noexcept;
+    void fork(Worker *worker, detail::PoolTask *task);
+    void join(Worker *worker, detail::PoolTask *task);
+    void submit_and_wait(detail::PoolTask *task);
+
+    void shutdown() noexcept;
+    void worker_loop(Worker *worker);
+    detail::PoolTask *find_task(Worker *worker);
+    void execute(detail::PoolTask *task);
+    void notify_one();
+
+    static thread_local Worker *tls_worker_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    /* The tasks submitted by the threads out of the pool */
+    std::mutex mutex_;
+    std::deque<detail::PoolTask *> injected_;
+    std::atomic<size_t> injected_count_;
+
+    /* Increased by every new task, the idle workers sleep until it changes */
+    std::atomic<uint64_t> epoch_;
+    std::atomic<size_t> sleepers_;
+    std::condition_variable cond_;
+    std::condition_variable done_cond_;
+    bool stop_;
+};
+
+} // namespace zda
+
+#endif /* guard */
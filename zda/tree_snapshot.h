@@ -0,0 +1,266 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_TREE_SNAPSHOT_H__
+#define _ZDA_TREE_SNAPSHOT_H__
+
+#include "zda/avl_tree.h"
+#include "zda/rb_tree.h"
+#include "zda/util/export.h"
+#include "zda/util/macro.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+EXTERN_C_BEGIN
+#endif
+
+/*
+ * Sorted flat snapshot of the zda_rb_tree_t and zda_avl_tree_t
+ *
+ * The entries are written in-order with the uint64_t keys, so the snapshot mapped by mmap() can
+ * be searched by binary search without deserialization, and reloaded into a live tree by
+ * zda_rb_tree_build_sorted()/zda_avl_tree_build_sorted() in O(n) instead of n insertions.
+ *
+ * Layout(all integers are uint64_t in the native byte order, checked when opening):
+ * ```
+ * | header(64 bytes) | records | key index | record offsets[cnt + 1] |
+ * ```
+ * A record is its length followed by the bytes serialized by the user, padded to 8 bytes, and
+ * the record offsets[i] is the offset of the i-th record relative to the start of the snapshot.
+ *
+ * The key index is the keys[cnt] by default. If ZDA_TREE_SNAPSHOT_DELTA is specified, the keys
+ * are split into blocks of ZDA_TREE_SNAPSHOT_BLOCK keys:
+ * ```
+ * | first keys[nblk] | delta offsets[nblk + 1] | varint deltas(padded to 8 bytes) |
+ * ```
+ * The first key of each block is stored as is, the others are stored as the LEB128 varint of
+ * the difference from the previous key. The binary search is done on the first keys, then at
+ * most one block is decoded.
+ *
+ * The keys must be ordered as the unsigned integers in the order of tree(e.g. map the signed
+ * key x to (uint64_t)x ^ (1ULL << 63)).
+ */
+
+#define ZDA_TREE_SNAPSHOT_DELTA 0x1
+#define ZDA_TREE_SNAPSHOT_BLOCK 64
+
+typedef struct zda_tree_snapshot {
+  char const          *base;
+  size_t               size;
+  size_t               cnt;
+  uint64_t const      *keys;
+  uint64_t const      *offs;
+  /* Delta-compressed index */
+  uint64_t const      *blk_keys;
+  uint64_t const      *blk_offs;
+  size_t               nblk;
+  unsigned             flags;
+  zda_bool             mapped;
+} zda_tree_snapshot_t;
+
+/* The view of serialized entry in the snapshot */
+typedef struct zda_tree_record {
+  void const *data;
+  size_t      len;
+} zda_tree_record_t;
+
+/* Get the key of node, the node is the zda_rb_node_t or zda_avl_node_t */
+typedef uint64_t (*zda_tree_snapshot_key_cb_t)(void const *node, void *ctx);
+
+/**
+ * @brief Serialize the entry of \p node to \p buf[0, n)
+ * @return The required size. If it is greater than \p n, the callback is called again with
+ * a buffer large enough. Return (size_t)-1 to abort the writing.
+ */
+typedef size_t (*zda_tree_serialize_cb_t)(void const *node, void *buf, size_t n, void *ctx);
+
+/**
+ * @brief Write the snapshot of \p tree to \p fp at its current position
+ * The \p fp must be seekable.
+ * @param flags 0 or ZDA_TREE_SNAPSHOT_DELTA
+ * @return 0 if success, otherwise -1(including the keys are not in ascending order)
+ */
+ZDA_API int zda_rb_tree_snapshot_write(
+    zda_rb_tree_t             *tree,
+    FILE                      *fp,
+    unsigned                   flags,
+    zda_tree_snapshot_key_cb_t get_key,
+    zda_tree_serialize_cb_t    serialize,
+    void                      *ctx
+) zda_noexcept;
+
+ZDA_API int zda_avl_tree_snapshot_write(
+    zda_avl_tree_t            *tree,
+    FILE                      *fp,
+    unsigned                   flags,
+    zda_tree_snapshot_key_cb_t get_key,
+    zda_tree_serialize_cb_t    serialize,
+    void                      *ctx
+) zda_noexcept;
+
+/**
+ * @brief Open the snapshot file by mmap()
+ * The snapshot must be written at the beginning of the file.
+ * @return 0 if success, otherwise -1(the file is not accessible or the format is invalid)
+ */
+ZDA_API int zda_tree_snapshot_open(zda_tree_snapshot_t *snap, char const *path) zda_noexcept;
+
+/**
+ * @brief Initialize the snapshot from the memory \p base[0, size) which must be 8-byte aligned
+ * The memory is not owned by the snapshot.
+ * @return 0 if success, otherwise -1(the format is invalid)
+ */
+ZDA_API int
+zda_tree_snapshot_init(zda_tree_snapshot_t *snap, void const *base, size_t size) zda_noexcept;
+
+/**
+ * @brief Unmap the snapshot if it is opened by zda_tree_snapshot_open()
+ */
+ZDA_API void zda_tree_snapshot_close(zda_tree_snapshot_t *snap) zda_noexcept;
+
+static zda_inline size_t zda_tree_snapshot_get_count(zda_tree_snapshot_t const *snap) zda_noexcept
+{
+  return snap->cnt;
+}
+
+static zda_inline zda_bool zda_tree_snapshot_is_empty(zda_tree_snapshot_t const *snap) zda_noexcept
+{
+  return snap->cnt == 0;
+}
+
+/**
+ * @brief Get the record of the \p idx-th entry
+ */
+static zda_inline zda_tree_record_t
+zda_tree_snapshot_get_record(zda_tree_snapshot_t const *snap, size_t idx) zda_noexcept
+{
+  zda_tree_record_t rec;
+  char const       *p = snap->base + snap->offs[idx];
+  rec.len             = (size_t)(*(uint64_t const *)p);
+  rec.data            = p + sizeof(uint64_t);
+  return rec;
+}
+
+ZDA_API uint64_t _zda_tree_snapshot_get_delta_key(zda_tree_snapshot_t const *snap, size_t idx)
+    zda_noexcept;
+
+/**
+ * @brief Get the key of the \p idx-th entry
+ * If the keys are delta-compressed, this decodes at most ZDA_TREE_SNAPSHOT_BLOCK varints, use the
+ * cursor to visit the keys sequentially.
+ */
+static zda_inline uint64_t
+zda_tree_snapshot_get_key(zda_tree_snapshot_t const *snap, size_t idx) zda_noexcept
+{
+  if (snap->flags & ZDA_TREE_SNAPSHOT_DELTA) return _zda_tree_snapshot_get_delta_key(snap, idx);
+  return snap->keys[idx];
+}
+
+/**
+ * @brief Return the index of the first entry whose key is not less than \p key
+ * @return The count of the snapshot if no such entry
+ */
+ZDA_API size_t
+zda_tree_snapshot_lower_bound(zda_tree_snapshot_t const *snap, uint64_t key) zda_noexcept;
+
+/**
+ * @brief Search the entry whose key is \p key
+ * @return The record whose data is NULL if not found
+ */
+ZDA_API zda_tree_record_t
+zda_tree_snapshot_search(zda_tree_snapshot_t const *snap, uint64_t key) zda_noexcept;
+
+/*********************************/
+/* Cursor APIs */
+/*********************************/
+/* Visit the entries sequentially, the delta-compressed keys are decoded incrementally */
+typedef struct zda_tree_snapshot_cursor {
+  zda_tree_snapshot_t const *snap;
+  size_t                     idx;
+  uint64_t                   key;
+  /* The next varint to decode */
+  unsigned char const       *pos;
+} zda_tree_snapshot_cursor_t;
+
+/**
+ * @brief Move the cursor to the \p idx-th entry
+ * The cursor is end if \p idx is not less than the count.
+ */
+ZDA_API void zda_tree_snapshot_cursor_seek(
+    zda_tree_snapshot_cursor_t *cursor,
+    zda_tree_snapshot_t const  *snap,
+    size_t                      idx
+) zda_noexcept;
+
+ZDA_API void zda_tree_snapshot_cursor_next(zda_tree_snapshot_cursor_t *cursor) zda_noexcept;
+
+static zda_inline zda_bool zda_tree_snapshot_cursor_is_end(zda_tree_snapshot_cursor_t const *cursor
+) zda_noexcept
+{
+  return cursor->idx >= cursor->snap->cnt;
+}
+
+static zda_inline zda_tree_record_t
+zda_tree_snapshot_cursor_get_record(zda_tree_snapshot_cursor_t const *cursor) zda_noexcept
+{
+  return zda_tree_snapshot_get_record(cursor->snap, cursor->idx);
+}
+
+/**
+ * @brief Iterate all entries in the key order, \p cursor is the zda_tree_snapshot_cursor_t variable
+ * The key is cursor.key.
+ */
+#define zda_tree_snapshot_iterate(snap, cursor)                                                    \
+  for (zda_tree_snapshot_cursor_seek(&(cursor), (snap), 0);                                        \
+       !zda_tree_snapshot_cursor_is_end(&(cursor));                                                \
+       zda_tree_snapshot_cursor_next(&(cursor)))
+
+/*********************************/
+/* Reload APIs */
+/*********************************/
+/**
+ * @brief Create the entry from the record
+ * @return The node of the new entry, or NULL to abort the loading
+ */
+typedef zda_rb_node_t *(*zda_rb_tree_snapshot_load_cb_t)(
+    uint64_t                 key,
+    zda_tree_record_t const *rec,
+    void                    *ctx
+);
+
+typedef zda_avl_node_t *(*zda_avl_tree_snapshot_load_cb_t)(
+    uint64_t                 key,
+    zda_tree_record_t const *rec,
+    void                    *ctx
+);
+
+typedef void (*zda_avl_free_t)(zda_avl_node_t *node);
+
+/**
+ * @brief Load all entries of \p snap into \p tree by zda_rb_tree_build_sorted()
+ * If the \p load_cb fails, the created entries are released by \p free_cb and the tree is
+ * unchanged.
+ * @param tree Must be empty
+ * @return 0 if success, otherwise -1
+ */
+ZDA_API int zda_rb_tree_snapshot_load(
+    zda_rb_tree_t                 *tree,
+    zda_tree_snapshot_t const     *snap,
+    zda_rb_tree_snapshot_load_cb_t load_cb,
+    zda_rb_free_t                  free_cb,
+    void                          *ctx
+) zda_noexcept;
+
+ZDA_API int zda_avl_tree_snapshot_load(
+    zda_avl_tree_t                 *tree,
+    zda_tree_snapshot_t const      *snap,
+    zda_avl_tree_snapshot_load_cb_t load_cb,
+    zda_avl_free_t                  free_cb,
+    void                           *ctx
+) zda_noexcept;
+
+#ifdef __cplusplus
+EXTERN_C_END
+#endif
+
+#endif /* Header guard */
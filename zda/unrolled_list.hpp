@@ -0,0 +1,546 @@
+#ifndef _ZDA_UNROLLED_LIST_HPP__
+#define _ZDA_UNROLLED_LIST_HPP__
+
+/*
+ * Unrolled linked list
+ *
+ * The elements are stored in the blocks of about BlockBytes bytes, and the
+ * blocks are linked by the intrusive zda_list. The elements in a block are
+ * contiguous, so the iteration touches one block per block_capacity()
+ * elements instead of one node per element.
+ *
+ * - Insert: O(block_capacity()). If the block is full, the element goes to
+ *   the neighbor block if it is inserted at the boundary and the neighbor
+ *   has space, otherwise a new block is linked(the block is split in half if
+ *   the position is in the middle).
+ * - Erase: O(block_capacity()). If the block becomes less than half full,
+ *   it borrows from or merges with the neighbor block.
+ * - Splice: O(block_capacity()), the blocks of the other list are linked
+ *   without moving the elements, so the pointers to them are still valid.
+ *
+ * Invalidation: insert() and erase() invalidate the iterators and pointers to
+ * the elements of the blocks they modify(the target block and its
+ * neighbors). The elements in the other blocks are never moved.
+ *
+ * T must be nothrow movable since the elements are moved between the blocks.
+ *
+ * ```cpp
+ * zda::UnrolledList<Record> records;
+ * auto it = records.begin();
+ * ...
+ * it = records.insert(it, record);
+ * it = records.erase(it);
+ * ```
+ */
+#include "zda/list.h"
+#include "zda/util/macro.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+
+namespace zda {
+
+template <typename T, size_t BlockBytes = 512>
+class UnrolledList {
+    static constexpr size_t HEADER_BYTES = sizeof(zda_list_node_t) + sizeof(size_t);
+    static constexpr size_t CAPACITY =
+        (BlockBytes > HEADER_BYTES && (BlockBytes - HEADER_BYTES) / sizeof(T) > 2)
+            ? (BlockBytes - HEADER_BYTES) / sizeof(T)
+            : 2;
+
+    /* The elements are moved between the blocks after the blocks are
+     * relinked, a throwing move would leave the list inconsistent */
+    static_assert(std::is_nothrow_move_constructible<T>::value &&
+                      std::is_nothrow_move_assignable<T>::value,
+                  "UnrolledList requires the nothrow move of T");
+
+    struct Block {
+        zda_list_node_t node;
+        size_t count;
+        alignas(T) unsigned char data[sizeof(T) * CAPACITY];
+
+        T *at(size_t i) noexcept { return reinterpret_cast<T *>(data) + i; }
+    };
+
+    static Block *to_block(zda_list_node_t *node) noexcept
+    {
+        return zda_list_entry(node, Block);
+    }
+
+    template <bool IsConst>
+    class Iterator {
+        friend class UnrolledList;
+
+       public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = typename std::conditional<IsConst, T const *, T *>::type;
+        using reference = typename std::conditional<IsConst, T const &, T &>::type;
+
+        Iterator() noexcept
+          : node_(nullptr)
+          , idx_(0)
+        {
+        }
+
+        /* iterator -> const_iterator */
+        template <bool C = IsConst, typename = typename std::enable_if<C>::type>
+        Iterator(Iterator<false> const &other) noexcept
+          : node_(other.node_)
+          , idx_(other.idx_)
+        {
+        }
+
+        reference operator*() const noexcept { return *to_block(node_)->at(idx_); }
+        pointer operator->() const noexcept { return to_block(node_)->at(idx_); }
+
+        Iterator &operator++() noexcept
+        {
+            if (++idx_ == to_block(node_)->count) {
+                node_ = node_->next;
+                idx_ = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        Iterator &operator--() noexcept
+        {
+            if (idx_ == 0) {
+                node_ = node_->prev;
+                idx_ = to_block(node_)->count;
+            }
+            --idx_;
+            return *this;
+        }
+
+        Iterator operator--(int) noexcept
+        {
+            Iterator ret = *this;
+            --*this;
+            return ret;
+        }
+
+        friend bool operator==(Iterator const &x, Iterator const &y) noexcept
+        {
+            return x.node_ == y.node_ && x.idx_ == y.idx_;
+        }
+
+        friend bool operator!=(Iterator const &x, Iterator const &y) noexcept
+        {
+            return !(x == y);
+        }
+
+       private:
+        friend class Iterator<!IsConst>;
+
+        Iterator(zda_list_node_t *node, size_t idx) noexcept
+          : node_(node)
+          , idx_(idx)
+        {
+        }
+
+        /* The end iterator is (sentinel, 0) */
+        zda_list_node_t *node_;
+        size_t idx_;
+    };
+
+   public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    UnrolledList() noexcept
+      : size_(0)
+    {
+        zda_list_header_init(&header_);
+    }
+
+    UnrolledList(std::initializer_list<T> il)
+      : UnrolledList()
+    {
+        try {
+            for (auto const &x : il)
+                emplace_back(x);
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    UnrolledList(UnrolledList const &other)
+      : UnrolledList()
+    {
+        try {
+            for (auto const &x : other)
+                emplace_back(x);
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    UnrolledList(UnrolledList &&other) noexcept
+      : UnrolledList()
+    {
+        take(other);
+    }
+
+    UnrolledList &operator=(UnrolledList const &other)
+    {
+        if (this != &other) {
+            UnrolledList tmp(other);
+            clear();
+            take(tmp);
+        }
+        return *this;
+    }
+
+    UnrolledList &operator=(UnrolledList &&other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~UnrolledList() noexcept { clear(); }
+
+    void swap(UnrolledList &other) noexcept
+    {
+        UnrolledList tmp(std::move(other));
+        other.take(*this);
+        take(tmp);
+    }
+
+    /*****************************/
+    /* Observer APIs */
+    /*****************************/
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    /* The maximum number of elements in a block */
+    static constexpr size_type block_capacity() noexcept { return CAPACITY; }
+
+    size_type block_count() const noexcept
+    {
+        size_type ret = 0;
+        for (zda_list_node_t *node = header_.node.next; node != &header_.node; node = node->next)
+            ++ret;
+        return ret;
+    }
+
+    iterator begin() noexcept { return iterator(header_.node.next, 0); }
+    iterator end() noexcept { return iterator(&header_.node, 0); }
+    const_iterator begin() const noexcept { return const_iterator(header_.node.next, 0); }
+    const_iterator end() const noexcept { return const_iterator(sentinel(), 0); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    T &front() noexcept { return *begin(); }
+    T const &front() const noexcept { return *begin(); }
+    T &back() noexcept { return *--end(); }
+    T const &back() const noexcept { return *--end(); }
+
+    /*****************************/
+    /* Insert APIs */
+    /*****************************/
+    /**
+     * @brief Construct the element before \p pos
+     * @return The iterator to the new element
+     * @throw std::bad_alloc, or the exception thrown by the constructor of T,
+     *        then nothing is changed
+     */
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args &&...args)
+    {
+        /* Build the element first, the args may refer to an element moved by make_room() */
+        T tmp(std::forward<Args>(args)...);
+        Block *blk;
+        size_t idx;
+
+        /* The end() is inserted to the back of the last block */
+        if (pos.node_ == &header_.node) {
+            if (empty()) {
+                blk = new_block_before(&header_.node);
+                idx = 0;
+            } else {
+                blk = to_block(header_.node.prev);
+                idx = blk->count;
+            }
+        } else {
+            blk = to_block(pos.node_);
+            idx = pos.idx_;
+        }
+
+        if (blk->count == CAPACITY) make_room(blk, idx);
+
+        T *slot = blk->at(idx);
+        if (idx == blk->count) {
+            new (slot) T(std::move(tmp));
+        } else {
+            /* Shift [idx, count) right by one */
+            T *last = blk->at(blk->count - 1);
+            new (last + 1) T(std::move(*last));
+            std::move_backward(slot, last, last + 1);
+            *slot = std::move(tmp);
+        }
+        ++blk->count;
+        ++size_;
+        return iterator(&blk->node, idx);
+    }
+
+    iterator insert(const_iterator pos, T const &value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T &&value) { return emplace(pos, std::move(value)); }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    T &emplace_front(Args &&...args)
+    {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+
+    void push_back(T const &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+    void push_front(T const &value) { emplace_front(value); }
+    void push_front(T &&value) { emplace_front(std::move(value)); }
+
+    /**
+     * @brief Move all elements of \p other before \p pos
+     * The blocks of \p other are linked without moving the elements, only the block of \p pos
+     * is split if \p pos is in the middle of it.
+     * @throw std::bad_alloc if the split fails, then nothing is changed
+     */
+    void splice(const_iterator pos, UnrolledList &other)
+    {
+        if (this == &other || other.empty()) return;
+
+        zda_list_node_t *next = pos.node_;
+        if (pos.idx_ != 0) {
+            Block *blk = to_block(pos.node_);
+            Block *new_blk = new_block_before(blk->node.next);
+            new_blk->count = blk->count - pos.idx_;
+            move_elements(blk, pos.idx_, new_blk, 0, new_blk->count);
+            blk->count = pos.idx_;
+            next = &new_blk->node;
+        }
+
+        zda_list_node_t *first = other.header_.node.next;
+        zda_list_node_t *last = other.header_.node.prev;
+        first->prev = next->prev;
+        next->prev->next = first;
+        last->next = next;
+        next->prev = last;
+
+        size_ += other.size_;
+        other.size_ = 0;
+        zda_list_header_init(&other.header_);
+    }
+
+    /*****************************/
+    /* Remove APIs */
+    /*****************************/
+    /**
+     * @brief Erase the element at \p pos
+     * @return The iterator to the element following the erased one
+     */
+    iterator erase(const_iterator pos)
+    {
+        Block *blk = to_block(pos.node_);
+        size_t const idx = pos.idx_;
+
+        std::move(blk->at(idx + 1), blk->at(blk->count), blk->at(idx));
+        blk->at(blk->count - 1)->~T();
+        --blk->count;
+        --size_;
+
+        if (blk->count == 0) {
+            zda_list_node_t *next = blk->node.next;
+            free_block(blk);
+            return iterator(next, 0);
+        }
+        return rebalance(blk, idx);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        /* The last may be invalidated by the erase, so count the distance first */
+        size_t n = (size_t)std::distance(first, last);
+        iterator ret(first.node_, first.idx_);
+        while (n--)
+            ret = erase(ret);
+        return ret;
+    }
+
+    void pop_back() { erase(--end()); }
+    void pop_front() { erase(begin()); }
+
+    void clear() noexcept
+    {
+        zda_list_node_t *node = header_.node.next;
+        while (node != &header_.node) {
+            zda_list_node_t *next = node->next;
+            Block *blk = to_block(node);
+            for (size_t i = 0; i < blk->count; ++i)
+                blk->at(i)->~T();
+            delete blk;
+            node = next;
+        }
+        zda_list_header_init(&header_);
+        size_ = 0;
+    }
+
+   private:
+    zda_list_node_t *sentinel() const noexcept
+    {
+        return const_cast<zda_list_node_t *>(&header_.node);
+    }
+
+    Block *new_block_before(zda_list_node_t *pos)
+    {
+        Block *blk = new Block;
+        blk->count = 0;
+        zda_list_insert_before(pos, &blk->node);
+        return blk;
+    }
+
+    void free_block(Block *blk) noexcept
+    {
+        zda_list_remove(&blk->node);
+        delete blk;
+    }
+
+    bool has_room(zda_list_node_t *node) const noexcept
+    {
+        return node != &header_.node && to_block(node)->count < CAPACITY;
+    }
+
+    /* Move n elements from src[sidx, ...) to the uninitialized dst[didx, ...) */
+    static void move_elements(Block *src, size_t sidx, Block *dst, size_t didx, size_t n) noexcept
+    {
+        for (size_t i = 0; i < n; ++i) {
+            new (dst->at(didx + i)) T(std::move(*src->at(sidx + i)));
+            src->at(sidx + i)->~T();
+        }
+    }
+
+    /**
+     * @brief Make the position idx of the full blk insertable
+     * The blk and idx are updated to the position where the element should be constructed.
+     */
+    void make_room(Block *&blk, size_t &idx)
+    {
+        if (idx == CAPACITY) {
+            /* Append: use the front of next block */
+            if (!has_room(blk->node.next)) new_block_before(blk->node.next);
+            blk = to_block(blk->node.next);
+            idx = 0;
+        } else if (idx == 0) {
+            /* Prepend: use the back of the previous block */
+            if (!has_room(blk->node.prev)) new_block_before(&blk->node);
+            blk = to_block(blk->node.prev);
+            idx = blk->count;
+        } else {
+            /* Split in half */
+            size_t const half = CAPACITY / 2;
+            Block *new_blk = new_block_before(blk->node.next);
+            move_elements(blk, half, new_blk, 0, CAPACITY - half);
+            blk->count = half;
+            new_blk->count = CAPACITY - half;
+            if (idx > half) {
+                blk = new_blk;
+                idx -= half;
+            }
+        }
+    }
+
+    /**
+     * @brief Keep the blk at least half full by the next block
+     * If the blk is the last one, merge it into the previous one if possible.
+     * @return The iterator to the element at blk[idx] before rebalancing
+     */
+    iterator rebalance(Block *blk, size_t idx)
+    {
+        size_t const half = CAPACITY / 2;
+
+        if (blk->count < half) {
+            zda_list_node_t *next_node = blk->node.next;
+            zda_list_node_t *prev_node = blk->node.prev;
+
+            if (next_node != &header_.node) {
+                Block *next = to_block(next_node);
+                if (blk->count + next->count <= CAPACITY) {
+                    move_elements(next, 0, blk, blk->count, next->count);
+                    blk->count += next->count;
+                    free_block(next);
+                } else {
+                    /* Borrow to half full */
+                    size_t const n = half - blk->count;
+                    for (size_t i = 0; i < n; ++i)
+                        new (blk->at(blk->count + i)) T(std::move(*next->at(i)));
+                    std::move(next->at(n), next->at(next->count), next->at(0));
+                    for (size_t i = next->count - n; i < next->count; ++i)
+                        next->at(i)->~T();
+                    blk->count += n;
+                    next->count -= n;
+                }
+            } else if (prev_node != &header_.node) {
+                Block *prev = to_block(prev_node);
+                if (prev->count + blk->count <= CAPACITY) {
+                    size_t const base = prev->count;
+                    move_elements(blk, 0, prev, base, blk->count);
+                    prev->count += blk->count;
+                    free_block(blk);
+                    blk = prev;
+                    idx += base;
+                }
+            }
+        }
+
+        if (idx == blk->count) return iterator(blk->node.next, 0);
+        return iterator(&blk->node, idx);
+    }
+
+    /* Take over the blocks of other, this must be empty */
+    void take(UnrolledList &other) noexcept
+    {
+        if (other.empty()) return;
+        header_ = other.header_;
+        header_.node.next->prev = &header_.node;
+        header_.node.prev->next = &header_.node;
+        size_ = other.size_;
+        zda_list_header_init(&other.header_);
+        other.size_ = 0;
+    }
+
+    zda_list_header_t header_;
+    size_type size_;
+};
+
+} // namespace zda
+
+#endif /* guard */
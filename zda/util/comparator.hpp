@@ -14,12 +14,15 @@ struct Comparator {
   static_assert(sizeof(T) < 0, "The specialization of Comparator<T> isn't defined");
 };
 
+/* Don't return x - y since it may overflow(e.g. INT_MIN - 1),
+ * and the result of int64_t is truncated to int.
+ * (x > y) - (x < y) is branchless(setcc) in the common compilers. */
 #define ZDA_DEF_COMPARATOR_SPEC_SIGNED_(t_)                                                        \
   template <>                                                                                      \
   struct Comparator<t_> {                                                                          \
     zda_inline int operator()(t_ x, t_ y) const noexcept                                           \
     {                                                                                              \
-      return x - y;                                                                                \
+      return (x > y) - (x < y);                                                                    \
     }                                                                                              \
   }
 
@@ -38,7 +41,7 @@ ZDA_DEF_COMPARATOR_SPEC_SIGNED_(int64_t);
   struct Comparator<t_> {                                                                          \
     zda_inline int32_t operator()(t_ x, t_ y) const noexcept                                       \
     {                                                                                              \
-      return (x < y) ? -1 : ((x == y) ? 0 : 1);                                                    \
+      return (x > y) - (x < y);                                                                    \
     }                                                                                              \
   }
 
@@ -74,7 +77,7 @@ struct Comparator<float> {
 
 template <typename T>
 struct Comparator<T *> {
-  zda_inline int operator()(T *const x, T *const y) const noexcept { return x - y; }
+  zda_inline int operator()(T *const x, T *const y) const noexcept { return (x > y) - (x < y); }
 };
 
 } // namespace zda
@@ -0,0 +1,149 @@
+// SPDX-LICENSE-IDENTIFIER: MIT
+#ifndef _ZDA_UTIL_LIST_SORT_H__
+#define _ZDA_UTIL_LIST_SORT_H__
+
+/*
+ * The sort algorithms shared by the list, slist and delist.
+ * They work on the NULL-terminated chain linked by the next field only,
+ * the list APIs fix up the other links(e.g. prev, tail) after sorting.
+ *
+ * The comparator and key are expanded in place, so they can be inlined.
+ * Both algorithms relink the nodes and don't allocate.
+ */
+
+#include <stdint.h>
+
+/* Pass the node to the comparator or key directly */
+#define _zda_sort_node_self(p_node, type) (p_node)
+
+/**
+ * @brief Bottom-up merge sort(Simon Tatham's algorithm)
+ * Merge the runs of size 1, 2, 4, ... until there is only one run.
+ * Stable, O(nlogn) comparisons and O(1) extra memory.
+ * @param node_type The type of the nodes
+ * @param head [in, out] The first node of the chain
+ * @param tail [out] The last node of the sorted chain, NULL if the chain is empty
+ * @param to_entry to_entry(node, type) gets the argument of the \p cmp
+ * @param cmp cmp(lhs, rhs) returns negative, zero, positive like the strcmp()
+ */
+#define _zda_chain_merge_sort(node_type, head, tail, to_entry, type, cmp)                          \
+    do {                                                                                           \
+        node_type *__list   = (head);                                                              \
+        node_type *__tail   = NULL;                                                                \
+        size_t     __insize = 1;                                                                   \
+        while (__list) {                                                                           \
+            node_type *__p       = __list;                                                         \
+            size_t     __nmerges = 0;                                                              \
+            __list               = NULL;                                                           \
+            __tail               = NULL;                                                           \
+            while (__p) {                                                                          \
+                node_type *__q     = __p;                                                          \
+                node_type *__e     = NULL;                                                         \
+                size_t     __psize = 0;                                                            \
+                size_t     __qsize = __insize;                                                     \
+                ++__nmerges;                                                                       \
+                while (__q && __psize < __insize) {                                                \
+                    ++__psize;                                                                     \
+                    __q = __q->next;                                                               \
+                }                                                                                  \
+                /* Merge the run p and the run q */                                                \
+                while (__psize > 0 || (__qsize > 0 && __q)) {                                      \
+                    if (__psize == 0) {                                                            \
+                        __e = __q;                                                                 \
+                        __q = __q->next;                                                           \
+                        --__qsize;                                                                 \
+                    } else if (__qsize == 0 || !__q ||                                             \
+                               cmp(to_entry(__p, type), to_entry(__q, type)) <= 0) {               \
+                        /* Take p first if equal to keep stable */                                 \
+                        __e = __p;                                                                 \
+                        __p = __p->next;                                                           \
+                        --__psize;                                                                 \
+                    } else {                                                                       \
+                        __e = __q;                                                                 \
+                        __q = __q->next;                                                           \
+                        --__qsize;                                                                 \
+                    }                                                                              \
+                    if (__tail)                                                                    \
+                        __tail->next = __e;                                                        \
+                    else                                                                           \
+                        __list = __e;                                                              \
+                    __tail = __e;                                                                  \
+                }                                                                                  \
+                __p = __q;                                                                         \
+            }                                                                                      \
+            __tail->next = NULL;                                                                   \
+            if (__nmerges <= 1) break;                                                             \
+            __insize <<= 1;                                                                        \
+        }                                                                                          \
+        (head) = __list;                                                                           \
+        (tail) = __tail;                                                                           \
+    } while (0)
+
+#define ZDA_RADIX_SORT_BITS    8
+#define ZDA_RADIX_SORT_BUCKETS (1 << ZDA_RADIX_SORT_BITS)
+
+/**
+ * @brief LSD radix sort by the unsigned integer key(at most 64 bits)
+ * Each pass distributes the nodes to 256 bucket chains by one byte of the key, then
+ * concatenates the chains. The bytes that are same in all keys are skipped, so the
+ * small keys only take a few passes.
+ * Stable, O(n * passes) and the extra memory is the bucket heads/tails on the stack.
+ * For signed keys, flip the sign bit to make them ordered as unsigned.
+ * @param node_type The type of the nodes
+ * @param head [in, out] The first node of the chain
+ * @param tail [out] The last node of the sorted chain, NULL if the chain is empty
+ * @param to_entry to_entry(node, type) gets the argument of the \p key_of
+ * @param key_of key_of(entry) returns the key
+ */
+#define _zda_chain_radix_sort(node_type, head, tail, to_entry, type, key_of)                       \
+    do {                                                                                           \
+        node_type *__heads[ZDA_RADIX_SORT_BUCKETS];                                                \
+        node_type *__tails[ZDA_RADIX_SORT_BUCKETS];                                                \
+        node_type *__list = (head);                                                                \
+        node_type *__last = NULL;                                                                  \
+        node_type *__pos;                                                                          \
+        node_type *__next;                                                                         \
+        uint64_t   __first_key;                                                                    \
+        uint64_t   __diff = 0;                                                                     \
+        unsigned   __shift;                                                                        \
+        int        __i;                                                                            \
+        if (__list) {                                                                              \
+            /* The bits set in diff are different in some keys */                                  \
+            __first_key = (uint64_t)key_of(to_entry(__list, type));                                \
+            for (__pos = __list; __pos; __pos = __pos->next) {                                     \
+                __diff |= (uint64_t)key_of(to_entry(__pos, type)) ^ __first_key;                   \
+                __last = __pos;                                                                    \
+            }                                                                                      \
+            for (__shift = 0; __shift < 64 && (__diff >> __shift); __shift += ZDA_RADIX_SORT_BITS) \
+            {                                                                                      \
+                if (((__diff >> __shift) & (ZDA_RADIX_SORT_BUCKETS - 1)) == 0) continue;           \
+                for (__i = 0; __i < ZDA_RADIX_SORT_BUCKETS; ++__i)                                 \
+                    __heads[__i] = NULL;                                                           \
+                for (__pos = __list; __pos; __pos = __next) {                                      \
+                    __next = __pos->next;                                                          \
+                    __i    = (int)(((uint64_t)key_of(to_entry(__pos, type)) >> __shift) &          \
+                                (ZDA_RADIX_SORT_BUCKETS - 1));                                     \
+                    if (__heads[__i])                                                              \
+                        __tails[__i]->next = __pos;                                                \
+                    else                                                                           \
+                        __heads[__i] = __pos;                                                      \
+                    __tails[__i] = __pos;                                                          \
+                }                                                                                  \
+                __list = NULL;                                                                     \
+                __last = NULL;                                                                     \
+                for (__i = 0; __i < ZDA_RADIX_SORT_BUCKETS; ++__i) {                               \
+                    if (!__heads[__i]) continue;                                                   \
+                    if (__last)                                                                    \
+                        __last->next = __heads[__i];                                               \
+                    else                                                                           \
+                        __list = __heads[__i];                                                     \
+                    __last = __tails[__i];                                                         \
+                }                                                                                  \
+                __last->next = NULL;                                                               \
+            }                                                                                      \
+        }                                                                                          \
+        (head) = __list;                                                                           \
+        (tail) = __last;                                                                           \
+    } while (0)
+
+#endif /* Header guard */
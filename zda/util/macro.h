@@ -57,4 +57,7 @@
 #    define ZDA_UNLIKELY(cond) (cond)
 #endif
 
+/* Separate the data written by different threads to avoid false sharing */
+#define ZDA_CACHELINE_SIZE 64
+
 #endif /* Header Guard */
\ No newline at end of file